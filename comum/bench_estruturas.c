@@ -0,0 +1,249 @@
+// -------------------------------
+// BENCHMARK DAS ESTRUTURAS COMUNS
+// -------------------------------
+// Mede cada contêiner de estruturas.h com as especializações usadas pelos
+// programas (fila e pilha de structs pequenas, vetor de inteiros, mapa
+// texto -> id, mapa inteiro -> inteiro e mapa ordenado). Uma otimização no
+// cabeçalho aparece aqui antes de chegar aos três jogos.
+//
+//   gcc -O2 -o bench_estruturas bench_estruturas.c && ./bench_estruturas [N]
+//
+// Saída em CSV: estrutura,operacao,n,total_ms,ns_por_op. A linha
+// 'fila_modulo' repete a fila com '%' (como era no tetris) como referência.
+#define _POSIX_C_SOURCE 200809L // clock_gettime
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "estruturas.h"
+
+#define N_PADRAO 1000000 // Operações por medição sem argumento
+#define CAP_FILA 5       // Capacidade da fila do tetris
+#define CAP_PILHA 3      // Capacidade da pilha do tetris
+
+typedef struct {
+    char nome;
+    int id;
+} Peca;
+
+DEFINIR_FILA_CIRCULAR(FilaPecas, Peca, CAP_FILA)
+DEFINIR_FILA_CIRCULAR(FilaDinamica, int, 0)
+DEFINIR_PILHA(PilhaPecas, Peca, CAP_PILHA)
+DEFINIR_VETOR(VetorInteiros, int)
+DEFINIR_MAPA_HASH(MapaTextoId, const char *, int, hashDeTexto, textosIguais)
+DEFINIR_MAPA_HASH(MapaInteiros, int, int, hashDeInteiro, inteirosIguais)
+DEFINIR_MAPA_ORDENADO(ArvoreInteiros, int, int, ordemDeInteiros)
+
+static volatile long sumidouro; // Impede que o compilador descarte os laços medidos
+
+// Tempo monotônico em segundos
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void linha(const char *estrutura, const char *operacao, int n, double segundos) {
+    printf("%s,%s,%d,%.3f,%.2f\n", estrutura, operacao, n, segundos * 1e3, segundos * 1e9 / n);
+}
+
+// Sequência pseudoaleatória reprodutível (xorshift32)
+static uint32_t proximoAleatorio(uint32_t *estado) {
+    *estado ^= *estado << 13;
+    *estado ^= *estado >> 17;
+    *estado ^= *estado << 5;
+    return *estado;
+}
+
+// Fila cheia em regime: cada passo tira da frente e repõe no fim, como no tetris
+static void medirFilas(int n) {
+    FilaPecas f;
+    FilaPecas_iniciar(&f, 0);
+    Peca p = { 'I', 0 };
+    long soma = 0;
+    while (FilaPecas_inserir(&f, p))
+        p.id++;
+    double inicio = agora();
+    for (int i = 0; i < n; i++) {
+        Peca saiu = p;
+        FilaPecas_remover(&f, &saiu);
+        soma += saiu.id;
+        p.id++;
+        FilaPecas_inserir(&f, p);
+    }
+    linha("fila_circular", "remover+inserir", n, agora() - inicio);
+
+    // Referência: mesma fila com o índice em '%'
+    Peca itens[CAP_FILA];
+    int frente = 0, fim = 0, qtd = 0;
+    for (; qtd < CAP_FILA; qtd++) {
+        itens[fim] = p;
+        fim = (fim + 1) % CAP_FILA;
+    }
+    inicio = agora();
+    for (int i = 0; i < n; i++) {
+        soma += itens[frente].id;
+        frente = (frente + 1) % CAP_FILA;
+        p.id++;
+        itens[fim] = p;
+        fim = (fim + 1) % CAP_FILA;
+    }
+    linha("fila_modulo", "remover+inserir", n, agora() - inicio);
+
+    FilaDinamica d;
+    FilaDinamica_iniciar(&d, 1024);
+    inicio = agora();
+    for (int i = 0; i < n; i++) {
+        if (!FilaDinamica_inserir(&d, i)) {
+            int x;
+            FilaDinamica_remover(&d, &x);
+            soma += x;
+            FilaDinamica_inserir(&d, i);
+        }
+    }
+    linha("fila_circular_dinamica", "inserir", n, agora() - inicio);
+    FilaDinamica_liberar(&d);
+    sumidouro = soma;
+}
+
+// Pilha de reserva: empilha até encher e desempilha tudo
+static void medirPilha(int n) {
+    PilhaPecas p;
+    PilhaPecas_iniciar(&p, 0);
+    long soma = 0;
+    double inicio = agora();
+    for (int i = 0; i < n; i++) {
+        Peca peca = { 'T', i };
+        if (!PilhaPecas_empilhar(&p, peca)) {
+            while (PilhaPecas_desempilhar(&p, &peca))
+                soma += peca.id;
+        }
+    }
+    linha("pilha", "empilhar/desempilhar", n, agora() - inicio);
+    sumidouro = soma;
+}
+
+static void medirVetor(int n) {
+    VetorInteiros v;
+    VetorInteiros_iniciar(&v);
+    double inicio = agora();
+    for (int i = 0; i < n; i++)
+        VetorInteiros_acrescentar(&v, i);
+    linha("vetor", "acrescentar", n, agora() - inicio);
+
+    long soma = 0;
+    inicio = agora();
+    while (v.qtd > 0)
+        soma += VetorInteiros_retirarUltimo(&v);
+    linha("vetor", "retirarUltimo", n, agora() - inicio);
+    VetorInteiros_liberar(&v);
+    sumidouro = soma;
+}
+
+// Mapa texto -> id com chaves no formato das pistas e dos nomes
+static void medirMapaTexto(int n) {
+    char (*textos)[24] = realocarEstrutura(NULL, (size_t)n * sizeof(*textos));
+    for (int i = 0; i < n; i++)
+        snprintf(textos[i], sizeof(textos[i]), "pista-%d-sala", i);
+
+    MapaTextoId m;
+    MapaTextoId_iniciar(&m);
+    double inicio = agora();
+    for (int i = 0; i < n; i++)
+        MapaTextoId_inserir(&m, textos[i], i);
+    linha("mapa_hash_texto", "inserir", n, agora() - inicio);
+
+    long soma = 0;
+    uint32_t estado = 12345;
+    inicio = agora();
+    for (int i = 0; i < n; i++) {
+        const int *id = MapaTextoId_buscar(&m, textos[proximoAleatorio(&estado) % (uint32_t)n]);
+        soma += id != NULL ? *id : -1;
+    }
+    linha("mapa_hash_texto", "buscar", n, agora() - inicio);
+
+    inicio = agora();
+    for (int i = 0; i < n; i++)
+        soma += MapaTextoId_buscar(&m, "pista-inexistente") == NULL;
+    linha("mapa_hash_texto", "buscar_ausente", n, agora() - inicio);
+    MapaTextoId_liberar(&m);
+    free(textos);
+    sumidouro = soma;
+}
+
+static void medirMapaInteiros(int n) {
+    MapaInteiros m;
+    MapaInteiros_iniciar(&m);
+    uint32_t estado = 2463534242u;
+    double inicio = agora();
+    for (int i = 0; i < n; i++)
+        MapaInteiros_inserir(&m, (int)(proximoAleatorio(&estado) >> 1), i);
+    linha("mapa_hash_inteiro", "inserir", n, agora() - inicio);
+
+    long soma = 0;
+    estado = 2463534242u;
+    inicio = agora();
+    for (int i = 0; i < n; i++) {
+        const int *v = MapaInteiros_buscar(&m, (int)(proximoAleatorio(&estado) >> 1));
+        soma += v != NULL ? *v : 0;
+    }
+    linha("mapa_hash_inteiro", "buscar", n, agora() - inicio);
+
+    estado = 2463534242u;
+    inicio = agora();
+    for (int i = 0; i < n; i++)
+        soma += MapaInteiros_remover(&m, (int)(proximoAleatorio(&estado) >> 1));
+    linha("mapa_hash_inteiro", "remover", n, agora() - inicio);
+    MapaInteiros_liberar(&m);
+    sumidouro = soma;
+}
+
+static void medirMapaOrdenado(int n) {
+    ArvoreInteiros a;
+    ArvoreInteiros_iniciar(&a);
+    uint32_t estado = 88172645u;
+    double inicio = agora();
+    for (int i = 0; i < n; i++)
+        ArvoreInteiros_inserir(&a, (int)(proximoAleatorio(&estado) >> 1), i);
+    linha("mapa_ordenado", "inserir", n, agora() - inicio);
+
+    long soma = 0;
+    estado = 88172645u;
+    inicio = agora();
+    for (int i = 0; i < n; i++) {
+        const int *v = ArvoreInteiros_buscar(&a, (int)(proximoAleatorio(&estado) >> 1));
+        soma += v != NULL ? *v : 0;
+    }
+    linha("mapa_ordenado", "buscar", n, agora() - inicio);
+
+    inicio = agora();
+    for (int no = ArvoreInteiros_primeiro(&a); no >= 0; no = ArvoreInteiros_seguinte(&a, no))
+        soma += a.nos[no].valor;
+    linha("mapa_ordenado", "percorrer", a.qtd, agora() - inicio);
+
+    estado = 88172645u;
+    inicio = agora();
+    for (int i = 0; i < n; i++)
+        soma += ArvoreInteiros_remover(&a, (int)(proximoAleatorio(&estado) >> 1));
+    linha("mapa_ordenado", "remover", n, agora() - inicio);
+    ArvoreInteiros_liberar(&a);
+    sumidouro = soma;
+}
+
+int main(int argc, char *argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : N_PADRAO;
+    if (n <= 0) {
+        fprintf(stderr, "Uso: %s [N]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    printf("estrutura,operacao,n,total_ms,ns_por_op\n");
+    medirFilas(n);
+    medirPilha(n);
+    medirVetor(n);
+    medirMapaTexto(n);
+    medirMapaInteiros(n);
+    medirMapaOrdenado(n);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,483 @@
+// -------------------------------
+// ESTRUTURAS DE DADOS COMUNS (somente cabeçalho)
+// -------------------------------
+// Contêineres compartilhados pelos três programas (tetris, detective-quest e
+// free-fire), especializados em tempo de compilação por macros: cada
+// DEFINIR_... gera um tipo 'Nome' e funções 'Nome_operacao' static inline para
+// o tipo de elemento informado, sem void * nem cópias por memcpy.
+//
+//   DEFINIR_FILA_CIRCULAR(Nome, Tipo, CAP)  fila FIFO em anel
+//   DEFINIR_PILHA(Nome, Tipo, CAP)          pilha LIFO
+//   DEFINIR_VETOR(Nome, Tipo)               vetor que cresce sob demanda
+//   DEFINIR_MAPA_HASH(Nome, Chave, Valor, hash, iguais)
+//                                           endereçamento aberto, sondagem linear
+//   DEFINIR_MAPA_ORDENADO(Nome, Chave, Valor, comparar)
+//                                           treap com nós num vetor (ordem pela chave)
+//
+// Na fila e na pilha, CAP > 0 embute um vetor de CAP elementos na estrutura
+// (capacidade fixa, sem alocação); CAP == 0 deixa a capacidade para
+// Nome_iniciar(x, capacidade), alocada no heap. Nos dois casos os elementos são
+// acessados pelo ponteiro 'itens', então a estrutura não deve ser copiada.
+// Falta de memória encerra o programa, como nos três jogos.
+#ifndef ESTRUTURAS_H
+#define ESTRUTURAS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Alocador usado pelos contêineres. Quem inclui pode definir os dois antes do
+// #include (ex.: para contar as chamadas) sem redefinir malloc/free da libc.
+#ifndef ESTRUTURAS_REALOCAR
+#define ESTRUTURAS_REALOCAR(bloco, bytes) realloc(bloco, bytes)
+#endif
+#ifndef ESTRUTURAS_LIBERAR
+#define ESTRUTURAS_LIBERAR(bloco) free(bloco)
+#endif
+
+// Aloca ou realoca; sem memória, encerra o programa
+static inline void *realocarEstrutura(void *bloco, size_t bytes) {
+    void *novo = ESTRUTURAS_REALOCAR(bloco, bytes > 0 ? bytes : 1);
+    if (novo == NULL) {
+        fprintf(stderr, "\n❌ Memória insuficiente.\n");
+        exit(EXIT_FAILURE);
+    }
+    return novo;
+}
+
+// Funções de hash, igualdade e ordem prontas para chaves texto e inteiras
+static inline uint32_t hashDeTexto(const char *texto) { // FNV-1a de 32 bits
+    uint32_t h = 2166136261u;
+    for (; *texto; texto++)
+        h = (h ^ (unsigned char)*texto) * 16777619u;
+    return h;
+}
+static inline int textosIguais(const char *a, const char *b) { return strcmp(a, b) == 0; }
+static inline int ordemDeTextos(const char *a, const char *b) { return strcmp(a, b); }
+static inline uint32_t hashDeInteiro(int x) { // Mistura de Murmur3 (fmix32)
+    uint32_t h = (uint32_t)x;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    return h ^ (h >> 16);
+}
+static inline int inteirosIguais(int a, int b) { return a == b; }
+static inline int ordemDeInteiros(int a, int b) { return (a > b) - (a < b); }
+
+// -------------------------------
+// FILA CIRCULAR (FIFO)
+// -------------------------------
+// O índice dá a volta com uma comparação em vez de '%', então qualquer
+// capacidade (não só potências de 2) custa o mesmo.
+#define DEFINIR_FILA_CIRCULAR(Nome, Tipo, CAP)                                        \
+    typedef struct {                                                                  \
+        Tipo *itens;                                                                  \
+        int inicio;     /* Posição do próximo a sair */                               \
+        int qtd;                                                                      \
+        int capacidade;                                                               \
+        Tipo fixo[(CAP) > 0 ? (CAP) : 1];                                             \
+    } Nome;                                                                           \
+                                                                                      \
+    static inline void Nome##_iniciar(Nome *f, int capacidade) {                      \
+        f->capacidade = (CAP) > 0 ? (CAP) : capacidade;                               \
+        f->itens = (CAP) > 0 ? f->fixo                                                \
+                             : (Tipo *)realocarEstrutura(NULL, (size_t)capacidade * sizeof(Tipo)); \
+        f->inicio = f->qtd = 0;                                                       \
+    }                                                                                 \
+    static inline void Nome##_liberar(Nome *f) {                                      \
+        if (f->itens != f->fixo)                                                      \
+            ESTRUTURAS_LIBERAR(f->itens);                                             \
+        f->itens = NULL;                                                              \
+        f->qtd = f->capacidade = 0;                                                   \
+    }                                                                                 \
+    static inline int Nome##_vazia(const Nome *f) { return f->qtd == 0; }             \
+    static inline int Nome##_cheia(const Nome *f) { return f->qtd == f->capacidade; } \
+    /* Posição física do i-ésimo elemento a partir da frente */                       \
+    static inline int Nome##_posicao(const Nome *f, int i) {                          \
+        int p = f->inicio + i;                                                        \
+        return p >= f->capacidade ? p - f->capacidade : p;                            \
+    }                                                                                 \
+    static inline Tipo *Nome##_em(Nome *f, int i) { return &f->itens[Nome##_posicao(f, i)]; } \
+    static inline Tipo *Nome##_frente(Nome *f) { return &f->itens[f->inicio]; }       \
+    /* Insere no fim; devolve 0 se estiver cheia */                                   \
+    static inline int Nome##_inserir(Nome *f, Tipo x) {                               \
+        if (f->qtd == f->capacidade)                                                  \
+            return 0;                                                                 \
+        f->itens[Nome##_posicao(f, f->qtd++)] = x;                                    \
+        return 1;                                                                     \
+    }                                                                                 \
+    /* Retira da frente; devolve 0 se estiver vazia */                                \
+    static inline int Nome##_remover(Nome *f, Tipo *x) {                              \
+        if (f->qtd == 0)                                                              \
+            return 0;                                                                 \
+        *x = f->itens[f->inicio];                                                     \
+        f->inicio = Nome##_posicao(f, 1);                                             \
+        f->qtd--;                                                                     \
+        return 1;                                                                     \
+    }
+
+// -------------------------------
+// PILHA (LIFO)
+// -------------------------------
+#define DEFINIR_PILHA(Nome, Tipo, CAP)                                                \
+    typedef struct {                                                                  \
+        Tipo *itens;                                                                  \
+        int qtd;        /* O topo é itens[qtd - 1] */                                 \
+        int capacidade;                                                               \
+        Tipo fixo[(CAP) > 0 ? (CAP) : 1];                                             \
+    } Nome;                                                                           \
+                                                                                      \
+    static inline void Nome##_iniciar(Nome *p, int capacidade) {                      \
+        p->capacidade = (CAP) > 0 ? (CAP) : capacidade;                               \
+        p->itens = (CAP) > 0 ? p->fixo                                                \
+                             : (Tipo *)realocarEstrutura(NULL, (size_t)capacidade * sizeof(Tipo)); \
+        p->qtd = 0;                                                                   \
+    }                                                                                 \
+    static inline void Nome##_liberar(Nome *p) {                                      \
+        if (p->itens != p->fixo)                                                      \
+            ESTRUTURAS_LIBERAR(p->itens);                                             \
+        p->itens = NULL;                                                              \
+        p->qtd = p->capacidade = 0;                                                   \
+    }                                                                                 \
+    static inline int Nome##_vazia(const Nome *p) { return p->qtd == 0; }             \
+    static inline int Nome##_cheia(const Nome *p) { return p->qtd == p->capacidade; } \
+    /* i-ésimo elemento a partir do topo (0 = topo) */                                \
+    static inline Tipo *Nome##_doTopo(Nome *p, int i) { return &p->itens[p->qtd - 1 - i]; } \
+    /* Empilha; devolve 0 se estiver cheia */                                         \
+    static inline int Nome##_empilhar(Nome *p, Tipo x) {                              \
+        if (p->qtd == p->capacidade)                                                  \
+            return 0;                                                                 \
+        p->itens[p->qtd++] = x;                                                       \
+        return 1;                                                                     \
+    }                                                                                 \
+    /* Desempilha; devolve 0 se estiver vazia */                                      \
+    static inline int Nome##_desempilhar(Nome *p, Tipo *x) {                          \
+        if (p->qtd == 0)                                                              \
+            return 0;                                                                 \
+        *x = p->itens[--p->qtd];                                                      \
+        return 1;                                                                     \
+    }
+
+// -------------------------------
+// VETOR DINÂMICO
+// -------------------------------
+// Cresce dobrando a capacidade (a partir de 16); também serve de pilha sem limite.
+#define DEFINIR_VETOR(Nome, Tipo)                                                     \
+    typedef struct {                                                                  \
+        Tipo *itens;                                                                  \
+        int qtd;                                                                      \
+        int capacidade;                                                               \
+    } Nome;                                                                           \
+                                                                                      \
+    static inline void Nome##_iniciar(Nome *v) {                                      \
+        v->itens = NULL;                                                              \
+        v->qtd = v->capacidade = 0;                                                   \
+    }                                                                                 \
+    static inline void Nome##_liberar(Nome *v) {                                      \
+        ESTRUTURAS_LIBERAR(v->itens);                                                 \
+        Nome##_iniciar(v);                                                            \
+    }                                                                                 \
+    /* Garante espaço para pelo menos 'capacidade' elementos */                       \
+    static inline void Nome##_reservar(Nome *v, int capacidade) {                     \
+        if (capacidade <= v->capacidade)                                              \
+            return;                                                                   \
+        int nova = v->capacidade > 0 ? v->capacidade : 16;                            \
+        while (nova < capacidade)                                                     \
+            nova *= 2;                                                                \
+        v->itens = (Tipo *)realocarEstrutura(v->itens, (size_t)nova * sizeof(Tipo)); \
+        v->capacidade = nova;                                                         \
+    }                                                                                 \
+    static inline void Nome##_acrescentar(Nome *v, Tipo x) {                          \
+        if (v->qtd == v->capacidade)                                                  \
+            Nome##_reservar(v, v->qtd + 1);                                           \
+        v->itens[v->qtd++] = x;                                                       \
+    }                                                                                 \
+    static inline Tipo *Nome##_ultimo(Nome *v) { return &v->itens[v->qtd - 1]; }      \
+    static inline Tipo Nome##_retirarUltimo(Nome *v) { return v->itens[--v->qtd]; }
+
+// -------------------------------
+// MAPA HASH
+// -------------------------------
+// Endereçamento aberto com sondagem linear e capacidade potência de 2, dobrada
+// acima de 50% de ocupação. O hash de cada entrada fica guardado (0 = vazia),
+// então a sondagem só chama 'iguais' quando os hashes coincidem e a tabela
+// cresce sem recalcular nenhum. A remoção desloca as entradas seguintes para
+// trás, sem deixar lápides. Chaves texto (const char *) não são copiadas: o
+// texto precisa viver enquanto estiver no mapa.
+#define DEFINIR_MAPA_HASH(Nome, Chave, Valor, funcaoHash, funcaoIguais)               \
+    typedef struct {                                                                  \
+        uint32_t *hashes; /* Hash de cada entrada (0 = vazia) */                      \
+        Chave *chaves;                                                                \
+        Valor *valores;                                                               \
+        int capacidade;   /* Potência de 2 (0 = ainda sem tabela) */                  \
+        int qtd;                                                                      \
+    } Nome;                                                                           \
+                                                                                      \
+    static inline void Nome##_iniciar(Nome *m) {                                      \
+        memset(m, 0, sizeof(Nome));                                                   \
+    }                                                                                 \
+    static inline void Nome##_liberar(Nome *m) {                                      \
+        ESTRUTURAS_LIBERAR(m->hashes);                                                \
+        ESTRUTURAS_LIBERAR(m->chaves);                                                \
+        ESTRUTURAS_LIBERAR(m->valores);                                               \
+        Nome##_iniciar(m);                                                            \
+    }                                                                                 \
+    static inline uint32_t Nome##_hash(Chave k) {                                     \
+        uint32_t h = funcaoHash(k);                                                   \
+        return h != 0 ? h : 1; /* 0 marca entrada vazia */                            \
+    }                                                                                 \
+    /* Posição da chave, ou da vaga onde ela entraria */                              \
+    static inline int Nome##_sondar(const Nome *m, Chave k, uint32_t h) {             \
+        int mascara = m->capacidade - 1, i = (int)(h & (uint32_t)mascara);            \
+        while (m->hashes[i] != 0 && !(m->hashes[i] == h && funcaoIguais(m->chaves[i], k))) \
+            i = (i + 1) & mascara;                                                    \
+        return i;                                                                     \
+    }                                                                                 \
+    /* Valor da chave, ou NULL */                                                     \
+    static inline Valor *Nome##_buscar(const Nome *m, Chave k) {                      \
+        if (m->qtd == 0)                                                              \
+            return NULL;                                                              \
+        int i = Nome##_sondar(m, k, Nome##_hash(k));                                  \
+        return m->hashes[i] != 0 ? &m->valores[i] : NULL;                             \
+    }                                                                                 \
+    static inline void Nome##_crescer(Nome *m) {                                      \
+        Nome antigo = *m;                                                             \
+        m->capacidade = antigo.capacidade > 0 ? antigo.capacidade * 2 : 16;           \
+        m->hashes = (uint32_t *)realocarEstrutura(NULL, (size_t)m->capacidade * sizeof(uint32_t)); \
+        m->chaves = (Chave *)realocarEstrutura(NULL, (size_t)m->capacidade * sizeof(Chave)); \
+        m->valores = (Valor *)realocarEstrutura(NULL, (size_t)m->capacidade * sizeof(Valor)); \
+        memset(m->hashes, 0, (size_t)m->capacidade * sizeof(uint32_t));              \
+        int mascara = m->capacidade - 1;                                              \
+        for (int j = 0; j < antigo.capacidade; j++) {                                 \
+            if (antigo.hashes[j] == 0)                                                \
+                continue;                                                             \
+            int i = (int)(antigo.hashes[j] & (uint32_t)mascara);                      \
+            while (m->hashes[i] != 0)                                                 \
+                i = (i + 1) & mascara;                                                \
+            m->hashes[i] = antigo.hashes[j];                                          \
+            m->chaves[i] = antigo.chaves[j];                                          \
+            m->valores[i] = antigo.valores[j];                                        \
+        }                                                                             \
+        ESTRUTURAS_LIBERAR(antigo.hashes);                                            \
+        ESTRUTURAS_LIBERAR(antigo.chaves);                                            \
+        ESTRUTURAS_LIBERAR(antigo.valores);                                           \
+    }                                                                                 \
+    /* Valor da chave; se ela não existia, entra com 'inicial' e *novo = 1 */         \
+    static inline Valor *Nome##_obter(Nome *m, Chave k, Valor inicial, int *novo) {   \
+        if (2 * (m->qtd + 1) > m->capacidade)                                         \
+            Nome##_crescer(m);                                                        \
+        uint32_t h = Nome##_hash(k);                                                  \
+        int i = Nome##_sondar(m, k, h);                                               \
+        if (novo != NULL)                                                             \
+            *novo = m->hashes[i] == 0;                                                \
+        if (m->hashes[i] == 0) {                                                      \
+            m->hashes[i] = h;                                                         \
+            m->chaves[i] = k;                                                         \
+            m->valores[i] = inicial;                                                  \
+            m->qtd++;                                                                 \
+        }                                                                             \
+        return &m->valores[i];                                                        \
+    }                                                                                 \
+    /* Associa o valor à chave (substitui o anterior) */                              \
+    static inline void Nome##_inserir(Nome *m, Chave k, Valor v) {                    \
+        *Nome##_obter(m, k, v, NULL) = v;                                             \
+    }                                                                                 \
+    /* Remove a chave; devolve 0 se não existia */                                    \
+    static inline int Nome##_remover(Nome *m, Chave k) {                              \
+        if (m->qtd == 0)                                                              \
+            return 0;                                                                 \
+        int i = Nome##_sondar(m, k, Nome##_hash(k));                                  \
+        if (m->hashes[i] == 0)                                                        \
+            return 0;                                                                 \
+        int mascara = m->capacidade - 1;                                              \
+        for (int j = (i + 1) & mascara; m->hashes[j] != 0; j = (j + 1) & mascara) {   \
+            int ideal = (int)(m->hashes[j] & (uint32_t)mascara);                      \
+            /* Move j para a vaga i se i está entre a posição ideal de j e j */       \
+            if (((j - ideal) & mascara) >= ((j - i) & mascara)) {                     \
+                m->hashes[i] = m->hashes[j];                                          \
+                m->chaves[i] = m->chaves[j];                                          \
+                m->valores[i] = m->valores[j];                                        \
+                i = j;                                                                \
+            }                                                                         \
+        }                                                                             \
+        m->hashes[i] = 0;                                                             \
+        m->qtd--;                                                                     \
+        return 1;                                                                     \
+    }
+
+// -------------------------------
+// MAPA ORDENADO
+// -------------------------------
+// Treap (árvore de busca com prioridades aleatórias, altura O(log n) esperada)
+// com os nós num vetor ligados por índices; nós removidos vão para uma lista
+// livre e são reaproveitados. Percurso em ordem:
+//   for (int no = Nome_primeiro(m); no >= 0; no = Nome_seguinte(m, no)) ... m->nos[no].chave
+#define DEFINIR_MAPA_ORDENADO(Nome, Chave, Valor, funcaoComparar)                     \
+    typedef struct {                                                                  \
+        Chave chave;                                                                  \
+        Valor valor;                                                                  \
+        int esq, dir;   /* Filhos (-1 = nenhum); 'esq' encadeia a lista livre */      \
+        uint32_t peso;                                                                \
+    } Nome##_No;                                                                      \
+    typedef struct {                                                                  \
+        Nome##_No *nos;                                                               \
+        int raiz;                                                                     \
+        int livre;      /* Primeiro nó livre (-1 = nenhum) */                         \
+        int usados;     /* Nós já tirados do vetor */                                 \
+        int capacidade;                                                               \
+        int qtd;                                                                      \
+        uint32_t semente;                                                             \
+    } Nome;                                                                           \
+                                                                                      \
+    static inline void Nome##_iniciar(Nome *m) {                                      \
+        memset(m, 0, sizeof(Nome));                                                   \
+        m->raiz = m->livre = -1;                                                      \
+        m->semente = 2463534242u;                                                     \
+    }                                                                                 \
+    static inline void Nome##_liberar(Nome *m) {                                      \
+        ESTRUTURAS_LIBERAR(m->nos);                                                   \
+        Nome##_iniciar(m);                                                            \
+    }                                                                                 \
+    /* Nó da chave, ou -1 */                                                          \
+    static inline int Nome##_buscarNo(const Nome *m, Chave k) {                       \
+        int no = m->raiz;                                                             \
+        while (no >= 0) {                                                             \
+            int c = funcaoComparar(k, m->nos[no].chave);                              \
+            if (c == 0)                                                               \
+                return no;                                                            \
+            no = c < 0 ? m->nos[no].esq : m->nos[no].dir;                             \
+        }                                                                             \
+        return -1;                                                                    \
+    }                                                                                 \
+    /* Valor da chave, ou NULL */                                                     \
+    static inline Valor *Nome##_buscar(Nome *m, Chave k) {                            \
+        int no = Nome##_buscarNo(m, k);                                               \
+        return no >= 0 ? &m->nos[no].valor : NULL;                                    \
+    }                                                                                 \
+    /* Primeiro nó com chave >= k, ou -1 */                                           \
+    static inline int Nome##_limiteInferior(const Nome *m, Chave k) {                 \
+        int no = m->raiz, melhor = -1;                                                \
+        while (no >= 0) {                                                             \
+            if (funcaoComparar(m->nos[no].chave, k) >= 0) {                           \
+                melhor = no;                                                          \
+                no = m->nos[no].esq;                                                  \
+            } else {                                                                  \
+                no = m->nos[no].dir;                                                  \
+            }                                                                         \
+        }                                                                             \
+        return melhor;                                                                \
+    }                                                                                 \
+    static inline int Nome##_primeiro(const Nome *m) {                                \
+        int no = m->raiz;                                                             \
+        while (no >= 0 && m->nos[no].esq >= 0)                                        \
+            no = m->nos[no].esq;                                                      \
+        return no;                                                                    \
+    }                                                                                 \
+    /* Nó seguinte na ordem das chaves, ou -1 (O(log n), sem ponteiro para o pai) */  \
+    static inline int Nome##_seguinte(const Nome *m, int no) {                        \
+        if (m->nos[no].dir >= 0) {                                                    \
+            no = m->nos[no].dir;                                                      \
+            while (m->nos[no].esq >= 0)                                               \
+                no = m->nos[no].esq;                                                  \
+            return no;                                                                \
+        }                                                                             \
+        int atual = m->raiz, melhor = -1;                                             \
+        while (atual >= 0) {                                                          \
+            if (funcaoComparar(m->nos[no].chave, m->nos[atual].chave) < 0) {          \
+                melhor = atual;                                                       \
+                atual = m->nos[atual].esq;                                            \
+            } else {                                                                  \
+                atual = m->nos[atual].dir;                                            \
+            }                                                                         \
+        }                                                                             \
+        return melhor;                                                                \
+    }                                                                                 \
+    /* Separa a árvore em chaves < k e chaves > k (k não está nela) */                \
+    static inline void Nome##_dividir(Nome *m, int raiz, Chave k, int *menores, int *maiores) { \
+        if (raiz < 0) {                                                               \
+            *menores = *maiores = -1;                                                 \
+        } else if (funcaoComparar(m->nos[raiz].chave, k) < 0) {                       \
+            Nome##_dividir(m, m->nos[raiz].dir, k, &m->nos[raiz].dir, maiores);       \
+            *menores = raiz;                                                          \
+        } else {                                                                      \
+            Nome##_dividir(m, m->nos[raiz].esq, k, menores, &m->nos[raiz].esq);       \
+            *maiores = raiz;                                                          \
+        }                                                                             \
+    }                                                                                 \
+    /* Une duas árvores (todas as chaves de a < todas as de b) */                     \
+    static inline int Nome##_unir(Nome *m, int a, int b) {                            \
+        if (a < 0)                                                                    \
+            return b;                                                                 \
+        if (b < 0)                                                                    \
+            return a;                                                                 \
+        if (m->nos[a].peso > m->nos[b].peso) {                                        \
+            m->nos[a].dir = Nome##_unir(m, m->nos[a].dir, b);                         \
+            return a;                                                                 \
+        }                                                                             \
+        m->nos[b].esq = Nome##_unir(m, a, m->nos[b].esq);                             \
+        return b;                                                                     \
+    }                                                                                 \
+    /* Desce até onde o nó novo entra pelo peso e o encaixa dividindo a subárvore */  \
+    static inline int Nome##_encaixar(Nome *m, int raiz, int novo) {                  \
+        if (raiz < 0 || m->nos[novo].peso > m->nos[raiz].peso) {                      \
+            Nome##_dividir(m, raiz, m->nos[novo].chave, &m->nos[novo].esq, &m->nos[novo].dir); \
+            return novo;                                                              \
+        }                                                                             \
+        if (funcaoComparar(m->nos[novo].chave, m->nos[raiz].chave) < 0)               \
+            m->nos[raiz].esq = Nome##_encaixar(m, m->nos[raiz].esq, novo);            \
+        else                                                                          \
+            m->nos[raiz].dir = Nome##_encaixar(m, m->nos[raiz].dir, novo);            \
+        return raiz;                                                                  \
+    }                                                                                 \
+    /* Valor da chave; se ela não existia, entra com 'inicial' e *novo = 1 */         \
+    static inline Valor *Nome##_obter(Nome *m, Chave k, Valor inicial, int *novo) {   \
+        int no = Nome##_buscarNo(m, k);                                               \
+        if (novo != NULL)                                                             \
+            *novo = no < 0;                                                           \
+        if (no >= 0)                                                                  \
+            return &m->nos[no].valor;                                                 \
+        if (m->livre >= 0) {                                                          \
+            no = m->livre;                                                            \
+            m->livre = m->nos[no].esq;                                                \
+        } else {                                                                      \
+            if (m->usados == m->capacidade) {                                         \
+                m->capacidade = m->capacidade > 0 ? m->capacidade * 2 : 16;           \
+                m->nos = (Nome##_No *)realocarEstrutura(m->nos, (size_t)m->capacidade * sizeof(Nome##_No)); \
+            }                                                                         \
+            no = m->usados++;                                                         \
+        }                                                                             \
+        m->semente ^= m->semente << 13; /* xorshift32 */                              \
+        m->semente ^= m->semente >> 17;                                               \
+        m->semente ^= m->semente << 5;                                                \
+        m->nos[no].chave = k;                                                         \
+        m->nos[no].valor = inicial;                                                   \
+        m->nos[no].esq = m->nos[no].dir = -1;                                         \
+        m->nos[no].peso = m->semente;                                                 \
+        m->raiz = Nome##_encaixar(m, m->raiz, no);                                    \
+        m->qtd++;                                                                     \
+        return &m->nos[no].valor;                                                     \
+    }                                                                                 \
+    /* Associa o valor à chave (substitui o anterior) */                              \
+    static inline void Nome##_inserir(Nome *m, Chave k, Valor v) {                    \
+        *Nome##_obter(m, k, v, NULL) = v;                                             \
+    }                                                                                 \
+    /* Remove a chave; devolve 0 se não existia */                                    \
+    static inline int Nome##_remover(Nome *m, Chave k) {                              \
+        int *ligacao = &m->raiz;                                                      \
+        while (*ligacao >= 0) {                                                       \
+            int no = *ligacao, c = funcaoComparar(k, m->nos[no].chave);               \
+            if (c == 0) {                                                             \
+                *ligacao = Nome##_unir(m, m->nos[no].esq, m->nos[no].dir);            \
+                m->nos[no].esq = m->livre;                                            \
+                m->livre = no;                                                        \
+                m->qtd--;                                                             \
+                return 1;                                                             \
+            }                                                                         \
+            ligacao = c < 0 ? &m->nos[no].esq : &m->nos[no].dir;                      \
+        }                                                                             \
+        return 0;                                                                     \
+    }
+
+#endif
@@ -0,0 +1,362 @@
+// -------------------------------
+// TELEMETRIA (somente cabeçalho, desligada por padrão)
+// -------------------------------
+// Camada única de instrumentação dos três programas. Sem -DTELEMETRIA as
+// macros abaixo somem na compilação (nem os argumentos são avaliados); com
+// ela, cada thread acumula contadores e intervalos de tempo no próprio buffer,
+// sem travas nem atômicos no caminho quente.
+//
+//   TELEMETRIA_CONTAR(nome, n)   soma n ao contador 'nome' (guarda total,
+//                                chamadas e o maior n visto)
+//   TELEMETRIA_INICIO(marca)     declara 'marca' com o instante atual
+//   TELEMETRIA_MARCAR(marca)     reinicia 'marca' no instante atual
+//   TELEMETRIA_FIM(marca, nome)  registra o intervalo [marca, agora] como 'nome'
+//
+// Os nomes devem ser textos que vivem até o fim do programa (literais ou
+// tabelas estáticas). O relógio é o TSC (rdtsc) em x86, convertido para
+// nanossegundos com uma calibração contra CLOCK_MONOTONIC na exportação, e o
+// próprio CLOCK_MONOTONIC nas outras arquiteturas.
+//
+// Ao sair do programa (atexit), os dados são exportados conforme o ambiente:
+//   TELEMETRIA_JSON=arquivo   resumo em JSON (contadores e intervalos agregados
+//                             por nome, no total e por thread)
+//   TELEMETRIA_TRACE=arquivo  eventos no formato Chrome trace (chrome://tracing,
+//                             Perfetto), uma linha do tempo por thread
+// Sem nenhuma das duas, o resumo JSON sai na saída de erros; '-' também a indica.
+#ifndef TELEMETRIA_H
+#define TELEMETRIA_H
+
+#ifdef TELEMETRIA
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "estruturas.h"
+
+#define MAX_CONTADORES_TELEMETRIA 64           // Contadores distintos por programa
+#define LIMITE_EVENTOS_TELEMETRIA (1 << 20)    // Intervalos guardados por thread (os demais são descartados)
+#define CALIBRACAO_MINIMA_TELEMETRIA_NS 1000000 // Janela mínima para converter ticks em ns
+
+typedef struct {
+    long long total;
+    long long chamadas;
+    long long maximo; // Maior n somado de uma vez
+} ContadorTelemetria;
+
+typedef struct {
+    const char *nome;
+    uint64_t inicio, fim; // Ticks do relógio da telemetria
+} EventoTelemetria;
+
+DEFINIR_VETOR(VetorEventosTelemetria, EventoTelemetria)
+
+// Buffer de uma thread; fica na lista global até a exportação, mesmo após a thread terminar
+typedef struct ThreadTelemetria {
+    int tid; // Ordem de chegada (1 = primeira thread instrumentada)
+    ContadorTelemetria contadores[MAX_CONTADORES_TELEMETRIA];
+    VetorEventosTelemetria eventos;
+    long long descartados;
+    struct ThreadTelemetria *proxima;
+} ThreadTelemetria;
+
+static pthread_mutex_t travaTelemetria = PTHREAD_MUTEX_INITIALIZER;
+static ThreadTelemetria *threadsTelemetria = NULL; // Em ordem inversa de chegada
+static int qtdThreadsTelemetria = 0;
+static const char *nomesContadoresTelemetria[MAX_CONTADORES_TELEMETRIA];
+static int qtdContadoresTelemetria = 0;
+static uint64_t ticksBaseTelemetria;  // Relógio da telemetria no primeiro registro
+static long long nsBaseTelemetria;    // CLOCK_MONOTONIC no mesmo instante
+static _Thread_local ThreadTelemetria *telemetriaLocal = NULL;
+
+// Nanossegundos do relógio monotônico
+static inline long long telemetriaNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Instante atual em ticks (TSC em x86; ns nas demais arquiteturas)
+static inline uint64_t telemetriaRelogio(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)telemetriaNs();
+#endif
+}
+
+static void telemetriaEncerrar(void);
+
+// Buffer da thread atual; o primeiro acesso de cada thread o cria e o encadeia
+static inline ThreadTelemetria *telemetriaDaThread(void) {
+    if (telemetriaLocal != NULL)
+        return telemetriaLocal;
+    ThreadTelemetria *t = realocarEstrutura(NULL, sizeof(ThreadTelemetria));
+    memset(t, 0, sizeof(ThreadTelemetria));
+    VetorEventosTelemetria_iniciar(&t->eventos);
+    pthread_mutex_lock(&travaTelemetria);
+    if (qtdThreadsTelemetria == 0) {
+        ticksBaseTelemetria = telemetriaRelogio();
+        nsBaseTelemetria = telemetriaNs();
+        atexit(telemetriaEncerrar);
+    }
+    t->tid = ++qtdThreadsTelemetria;
+    t->proxima = threadsTelemetria;
+    threadsTelemetria = t;
+    pthread_mutex_unlock(&travaTelemetria);
+    telemetriaLocal = t;
+    return t;
+}
+
+// Id do contador com esse nome (criado no primeiro uso); -1 se a tabela encheu
+static int telemetriaRegistrarContador(const char *nome) {
+    telemetriaDaThread(); // Garante a base do relógio e a exportação
+    pthread_mutex_lock(&travaTelemetria);
+    int id = 0;
+    while (id < qtdContadoresTelemetria && strcmp(nomesContadoresTelemetria[id], nome) != 0)
+        id++;
+    if (id == qtdContadoresTelemetria) {
+        if (id < MAX_CONTADORES_TELEMETRIA)
+            nomesContadoresTelemetria[qtdContadoresTelemetria++] = nome;
+        else
+            id = -1;
+    }
+    pthread_mutex_unlock(&travaTelemetria);
+    return id;
+}
+
+static inline void telemetriaSomar(int id, long long n) {
+    if (id < 0)
+        return;
+    ContadorTelemetria *c = &telemetriaDaThread()->contadores[id];
+    c->total += n;
+    c->chamadas++;
+    if (n > c->maximo)
+        c->maximo = n;
+}
+
+static inline void telemetriaRegistrarIntervalo(const char *nome, uint64_t inicio, uint64_t fim) {
+    ThreadTelemetria *t = telemetriaDaThread();
+    if (t->eventos.qtd >= LIMITE_EVENTOS_TELEMETRIA) {
+        t->descartados++;
+        return;
+    }
+    EventoTelemetria e = { nome, inicio, fim };
+    VetorEventosTelemetria_acrescentar(&t->eventos, e);
+}
+
+// O id de cada ponto de contagem é resolvido uma vez e guardado num static local
+#define TELEMETRIA_CONTAR(nome, n)                                                \
+    do {                                                                          \
+        static int idTelemetria_ = -1;                                            \
+        int id_ = __atomic_load_n(&idTelemetria_, __ATOMIC_RELAXED);              \
+        if (id_ < 0) {                                                            \
+            id_ = telemetriaRegistrarContador(nome);                              \
+            __atomic_store_n(&idTelemetria_, id_, __ATOMIC_RELAXED);              \
+        }                                                                         \
+        telemetriaSomar(id_, (long long)(n));                                     \
+    } while (0)
+#define TELEMETRIA_INICIO(marca) uint64_t marca = telemetriaRelogio()
+#define TELEMETRIA_MARCAR(marca) ((marca) = telemetriaRelogio())
+#define TELEMETRIA_FIM(marca, nome) telemetriaRegistrarIntervalo((nome), (marca), telemetriaRelogio())
+
+// -------------------------------
+// EXPORTAÇÃO
+// -------------------------------
+
+// Agregado dos intervalos de um nome
+typedef struct {
+    long long qtd;
+    double total, minimo, maximo; // µs
+} ResumoIntervalos;
+
+DEFINIR_MAPA_HASH(MapaResumoIntervalos, const char *, int, hashDeTexto, textosIguais)
+DEFINIR_VETOR(VetorResumoIntervalos, ResumoIntervalos)
+DEFINIR_VETOR(VetorNomesTelemetria, const char *)
+
+// Converte ticks em µs desde o primeiro registro
+static double nsPorTickTelemetria = 1.0;
+static inline double telemetriaMicros(uint64_t ticks) {
+    return (double)(int64_t)(ticks - ticksBaseTelemetria) * nsPorTickTelemetria / 1e3;
+}
+
+// Calcula ns por tick (espera a janela mínima para a razão ser estável)
+static void telemetriaCalibrar(void) {
+    long long ns = telemetriaNs();
+    while (ns - nsBaseTelemetria < CALIBRACAO_MINIMA_TELEMETRIA_NS)
+        ns = telemetriaNs();
+    uint64_t ticks = telemetriaRelogio();
+    if (ticks > ticksBaseTelemetria)
+        nsPorTickTelemetria = (double)(ns - nsBaseTelemetria) / (double)(ticks - ticksBaseTelemetria);
+}
+
+// Texto entre aspas com os escapes do JSON
+static void telemetriaTexto(FILE *saida, const char *texto) {
+    fputc('"', saida);
+    for (const unsigned char *c = (const unsigned char *)texto; *c; c++) {
+        if (*c == '"' || *c == '\\')
+            fprintf(saida, "\\%c", *c);
+        else if (*c < 0x20)
+            fprintf(saida, "\\u%04x", *c);
+        else
+            fputc(*c, saida);
+    }
+    fputc('"', saida);
+}
+
+static void telemetriaContadoresJSON(FILE *saida, const ContadorTelemetria contadores[]) {
+    fputc('{', saida);
+    for (int id = 0, primeiro = 1; id < qtdContadoresTelemetria; id++) {
+        const ContadorTelemetria *c = &contadores[id];
+        if (c->chamadas == 0)
+            continue;
+        fprintf(saida, "%s", primeiro ? "" : ", ");
+        telemetriaTexto(saida, nomesContadoresTelemetria[id]);
+        fprintf(saida, ": {\"total\": %lld, \"chamadas\": %lld, \"media\": %.3f, \"maximo\": %lld}",
+                c->total, c->chamadas, (double)c->total / c->chamadas, c->maximo);
+        primeiro = 0;
+    }
+    fputc('}', saida);
+}
+
+// Resumo: contadores e intervalos somados de todas as threads e depois por thread
+static void telemetriaExportarJSON(FILE *saida) {
+    ContadorTelemetria total[MAX_CONTADORES_TELEMETRIA];
+    memset(total, 0, sizeof(total));
+    MapaResumoIntervalos indices;
+    VetorResumoIntervalos resumos;
+    VetorNomesTelemetria nomes; // Ordem de primeira aparição
+    MapaResumoIntervalos_iniciar(&indices);
+    VetorResumoIntervalos_iniciar(&resumos);
+    VetorNomesTelemetria_iniciar(&nomes);
+    long long eventos = 0, descartados = 0;
+
+    for (ThreadTelemetria *t = threadsTelemetria; t != NULL; t = t->proxima) {
+        for (int id = 0; id < qtdContadoresTelemetria; id++) {
+            total[id].total += t->contadores[id].total;
+            total[id].chamadas += t->contadores[id].chamadas;
+            if (t->contadores[id].maximo > total[id].maximo)
+                total[id].maximo = t->contadores[id].maximo;
+        }
+        for (int i = 0; i < t->eventos.qtd; i++) {
+            const EventoTelemetria *e = &t->eventos.itens[i];
+            int novo;
+            int r = *MapaResumoIntervalos_obter(&indices, e->nome, resumos.qtd, &novo);
+            if (novo) {
+                ResumoIntervalos vazio = { 0, 0, 1e300, 0 };
+                VetorResumoIntervalos_acrescentar(&resumos, vazio);
+                VetorNomesTelemetria_acrescentar(&nomes, e->nome);
+            }
+            double us = (double)(e->fim - e->inicio) * nsPorTickTelemetria / 1e3;
+            ResumoIntervalos *s = &resumos.itens[r];
+            s->qtd++;
+            s->total += us;
+            s->minimo = us < s->minimo ? us : s->minimo;
+            s->maximo = us > s->maximo ? us : s->maximo;
+        }
+        eventos += t->eventos.qtd;
+        descartados += t->descartados;
+    }
+
+    fprintf(saida, "{\n  \"duracao_us\": %.1f,\n  \"ns_por_tick\": %.6f,\n  \"threads\": %d,\n",
+            (telemetriaNs() - nsBaseTelemetria) / 1e3, nsPorTickTelemetria, qtdThreadsTelemetria);
+    fprintf(saida, "  \"intervalos_registrados\": %lld,\n  \"intervalos_descartados\": %lld,\n", eventos, descartados);
+    fprintf(saida, "  \"contadores\": ");
+    telemetriaContadoresJSON(saida, total);
+    fprintf(saida, ",\n  \"intervalos\": {");
+    for (int i = 0; i < nomes.qtd; i++) {
+        const ResumoIntervalos *s = &resumos.itens[i];
+        fprintf(saida, "%s\n    ", i > 0 ? "," : "");
+        telemetriaTexto(saida, nomes.itens[i]);
+        fprintf(saida, ": {\"qtd\": %lld, \"total_us\": %.3f, \"media_us\": %.3f, \"min_us\": %.3f, \"max_us\": %.3f}",
+                s->qtd, s->total, s->total / s->qtd, s->minimo, s->maximo);
+    }
+    fprintf(saida, "%s},\n  \"por_thread\": [", nomes.qtd > 0 ? "\n  " : "");
+    for (int tid = 1; tid <= qtdThreadsTelemetria; tid++) {
+        ThreadTelemetria *t = threadsTelemetria;
+        while (t->tid != tid)
+            t = t->proxima;
+        fprintf(saida, "%s\n    {\"tid\": %d, \"intervalos\": %d, \"descartados\": %lld, \"contadores\": ",
+                tid > 1 ? "," : "", tid, t->eventos.qtd, t->descartados);
+        telemetriaContadoresJSON(saida, t->contadores);
+        fputc('}', saida);
+    }
+    fprintf(saida, "\n  ]\n}\n");
+
+    MapaResumoIntervalos_liberar(&indices);
+    VetorResumoIntervalos_liberar(&resumos);
+    VetorNomesTelemetria_liberar(&nomes);
+}
+
+// Formato Chrome trace: um evento completo ("X") por intervalo e os contadores
+// finais de cada thread como evento de contador ("C")
+static void telemetriaExportarTrace(FILE *saida) {
+    int pid = (int)getpid();
+    double fim = (telemetriaNs() - nsBaseTelemetria) / 1e3;
+    fprintf(saida, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    int primeiro = 1;
+    for (ThreadTelemetria *t = threadsTelemetria; t != NULL; t = t->proxima) {
+        fprintf(saida, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, \"args\": {\"name\": \"thread %d\"}}",
+                primeiro ? "" : ",\n", pid, t->tid, t->tid);
+        primeiro = 0;
+        for (int i = 0; i < t->eventos.qtd; i++) {
+            const EventoTelemetria *e = &t->eventos.itens[i];
+            fprintf(saida, ",\n{\"name\": ");
+            telemetriaTexto(saida, e->nome);
+            fprintf(saida, ", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": %d, \"tid\": %d}",
+                    telemetriaMicros(e->inicio), (double)(e->fim - e->inicio) * nsPorTickTelemetria / 1e3, pid, t->tid);
+        }
+        for (int id = 0; id < qtdContadoresTelemetria; id++) {
+            if (t->contadores[id].chamadas == 0)
+                continue;
+            fprintf(saida, ",\n{\"name\": ");
+            telemetriaTexto(saida, nomesContadoresTelemetria[id]);
+            fprintf(saida, ", \"ph\": \"C\", \"ts\": %.3f, \"pid\": %d, \"tid\": %d, \"args\": {\"total\": %lld}}",
+                    fim, pid, t->tid, t->contadores[id].total);
+        }
+    }
+    fprintf(saida, "\n]}\n");
+}
+
+// Abre o destino ('-' = saída de erros) e chama o exportador
+static void telemetriaGravar(const char *caminho, void (*exportar)(FILE *)) {
+    FILE *saida = strcmp(caminho, "-") == 0 ? stderr : fopen(caminho, "w");
+    if (saida == NULL) {
+        fprintf(stderr, "telemetria: não foi possível criar '%s'\n", caminho);
+        return;
+    }
+    exportar(saida);
+    if (saida != stderr)
+        fclose(saida);
+}
+
+// Exporta ao sair (registrada com atexit no primeiro uso). Os buffers não são
+// liberados: threads que ainda não terminaram podem continuar gravando neles.
+static void telemetriaEncerrar(void) {
+    pthread_mutex_lock(&travaTelemetria);
+    telemetriaCalibrar();
+    const char *json = getenv("TELEMETRIA_JSON"), *trace = getenv("TELEMETRIA_TRACE");
+    if (trace != NULL)
+        telemetriaGravar(trace, telemetriaExportarTrace);
+    if (json != NULL || trace == NULL)
+        telemetriaGravar(json != NULL ? json : "-", telemetriaExportarJSON);
+    pthread_mutex_unlock(&travaTelemetria);
+}
+
+#else // Sem -DTELEMETRIA: nada é compilado
+
+#define TELEMETRIA_CONTAR(nome, n) ((void)0)
+#define TELEMETRIA_INICIO(marca) ((void)0)
+#define TELEMETRIA_MARCAR(marca) ((void)0)
+#define TELEMETRIA_FIM(marca, nome) ((void)0)
+
+#endif
+
+#endif
@@ -1,7 +1,64 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <time.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+/**
+ * @brief Chamadas ao alocador feitas por este programa (relatadas pelo gerador de carga).
+ *
+ * O programa aloca e libera sempre pelas funções ...Contado abaixo, que só contam
+ * a chamada; os contêineres comuns usam as mesmas pelos ganchos ESTRUTURAS_*.
+ */
+typedef struct {
+    long long mallocs;
+    long long callocs;
+    long long reallocs;
+    long long frees;
+} ContagemAlocacoes;
+
+ContagemAlocacoes alocacoes = { 0, 0, 0, 0 };
+
+void* mallocContado(size_t tamanho) {
+    __atomic_fetch_add(&alocacoes.mallocs, 1, __ATOMIC_RELAXED);
+    return malloc(tamanho);
+}
+
+void* callocContado(size_t quantidade, size_t tamanho) {
+    __atomic_fetch_add(&alocacoes.callocs, 1, __ATOMIC_RELAXED);
+    return calloc(quantidade, tamanho);
+}
+
+void* reallocContado(void *ponteiro, size_t tamanho) {
+    __atomic_fetch_add(&alocacoes.reallocs, 1, __ATOMIC_RELAXED);
+    return realloc(ponteiro, tamanho);
+}
+
+void freeContado(void *ponteiro) {
+    if (ponteiro != NULL) {
+        __atomic_fetch_add(&alocacoes.frees, 1, __ATOMIC_RELAXED);
+    }
+    free(ponteiro);
+}
+
+#define ESTRUTURAS_REALOCAR(bloco, bytes) reallocContado(bloco, bytes)
+#define ESTRUTURAS_LIBERAR(bloco) freeContado(bloco)
+
+#include "../../comum/estruturas.h" // Vetor dinâmico e mapa hash compartilhados pelos três programas
+#include "../../comum/telemetria.h"  // Contadores e intervalos (só com -DTELEMETRIA)
 
 // ------------------------------------------
 // 1. CONSTANTES E DEFINIÇÕES
@@ -10,6 +67,17 @@
 #define MAX_PISTA 100
 #define TAMANHO_HASH 7 // Tamanho primo para a Tabela Hash
 #define PISTAS_MINIMAS 2 // Requisito: Pelo menos 2 pistas para sustentar a acusacao
+#define LIMIAR_BFS_PARALELO 4096 // Fronteiras menores que isso são expandidas sem threads
+#define MAX_THREADS_BFS 64       // Limite de threads na BFS por níveis
+#define MAX_ROTA 4096            // Tamanho máximo de rota exibida no explorador
+#define MAX_RESULTADOS_BUSCA 20  // Resultados exibidos por busca de pistas
+#define ARQUIVO_SNAPSHOT "investigacao.dqs" // Arquivo padrão de gravação da investigação
+#define VERSAO_SNAPSHOT 1
+#define NOS_POR_BLOCO 1024       // Nós da BST de pistas por bloco da arena
+#define MAX_THREADS_RESOLVEDOR 64 // Limite de threads do resolvedor exaustivo
+#define TAREFAS_MINIMAS_FILA 4   // Abaixo disso, a thread divide sua subárvore em novas tarefas
+#define PASSOS_SESSAO_CARGA 48   // Máximo de comandos por sessão sorteada pelo gerador de carga
+#define TIPOS_PASSO "edvpmbgrxw?cj" // Passos medidos na carga: comandos do menu, inválido, coleta e julgamento
 
 // ------------------------------------------
 // 2. ESTRUTURAS DA TABELA HASH (Suspeitos por Pista)
@@ -44,10 +112,77 @@ typedef struct {
  */
 typedef struct PistaNode {
     char pista[MAX_PISTA];
+    int altura;                // Altura da subárvore (balanceamento AVL)
     struct PistaNode *esquerda;
     struct PistaNode *direita;
 } PistaNode;
 
+/**
+ * @brief Bloco da arena de nós da BST de Pistas.
+ *
+ * A BST é persistente (cada versão compartilha nós com as anteriores), então
+ * os nós são alocados em blocos e liberados todos juntos.
+ */
+typedef struct BlocoPistas {
+    struct BlocoPistas *anterior;
+    int usados;
+    PistaNode nos[NOS_POR_BLOCO];
+} BlocoPistas;
+
+/**
+ * @brief Nó da trie de termos do índice de busca.
+ *
+ * Os nós ficam em um vetor e se ligam por índices (primeiro filho / próximo irmão),
+ * com os irmãos ordenados por letra.
+ */
+typedef struct {
+    unsigned char letra;
+    int primeiro_filho;
+    int proximo_irmao;
+    int termo;           // Id do termo que termina neste nó, ou -1
+} NoTermo;
+
+/**
+ * @brief Vetor dinâmico de inteiros (núcleo comum): listas de ocorrências e pilhas de percurso.
+ */
+DEFINIR_VETOR(VetorInteiros, int)
+
+/**
+ * @brief Lista de ocorrências de um termo: ids das pistas (itens) em ordem crescente.
+ */
+typedef VetorInteiros ListaOcorrencias;
+
+/**
+ * @brief Mapa texto -> id (núcleo comum, endereçamento aberto). Não copia os textos.
+ */
+DEFINIR_MAPA_HASH(MapaTextoId, const char*, int, hashDeTexto, textosIguais)
+
+/**
+ * @brief Índice de busca sobre o texto das pistas coletadas.
+ *
+ * Combina uma trie de termos (consultas por prefixo) com um índice invertido
+ * termo -> pistas (consultas por palavra-chave). Os ids das pistas são
+ * atribuídos em ordem de coleta, então as listas de ocorrências já nascem ordenadas.
+ */
+typedef struct {
+    char **textos;                  // Id da pista -> texto
+    int num_pistas;
+    int cap_pistas;
+    MapaTextoId ids;                // Texto -> id (evita duplicatas); chaves apontam para textos[id]
+    NoTermo *nos;                   // Nó 0 é a raiz da trie
+    int num_nos;
+    int cap_nos;
+    ListaOcorrencias *ocorrencias;  // Id do termo -> pistas
+    int num_termos;
+    int cap_termos;
+    int *marca;                     // Marcação por geração para uniões sem duplicatas
+    int cap_marca;
+    int geracao;
+    char *ativa;                    // Id -> 1 se a pista está na versão atual da investigação
+    int cap_ativa;
+    int num_ativas;
+} IndicePistas;
+
 // ------------------------------------------
 // 4. ESTRUTURA DO MAPA (Árvore Binária)
 // ------------------------------------------
@@ -59,17 +194,242 @@ typedef struct Sala {
     char nome[MAX_NOME];
     char pista_estatica[MAX_PISTA]; // Pista original associada à sala
     int pista_coletada;             // Flag: 1 se coletada, 0 caso contrário
+    int id;                         // Índice da sala no grafo da mansão (-1 se ainda não indexada)
     struct Sala *esquerda;
     struct Sala *direita;
 } Sala;
 
+/**
+ * @brief Passagem dirigida entre dois cômodos (pelos índices no grafo).
+ *
+ * Usada para declarar saídas extras além de esquerda/direita.
+ */
+typedef struct {
+    int origem;
+    int destino;
+} Passagem;
+
+/**
+ * @brief Registro de uma coleta de pista, usado para desfazer ramificações.
+ */
+typedef struct {
+    Sala *sala;
+    int id_indice;   // Pista ativada no índice de busca por esta coleta (-1 se já estava ativa)
+} RegistroColeta;
+
+/**
+ * @brief Ponto de ramificação da investigação ("e se eu for pela esquerda?").
+ *
+ * Guarda a raiz da versão da BST naquele momento (a árvore é persistente,
+ * então isso não copia nada), a sala e o tamanho do registro de coletas.
+ */
+typedef struct {
+    PistaNode *raiz;
+    Sala *sala;
+    int qtd_coletas;
+} PontoRamificacao;
+
+/**
+ * @brief Histórico da investigação: registro de coletas e pilha de ramificações.
+ */
+typedef struct {
+    RegistroColeta *coletas;
+    int qtd_coletas;
+    int cap_coletas;
+    PontoRamificacao *pontos;
+    int qtd_pontos;
+    int cap_pontos;
+} HistoricoInvestigacao;
+
+/**
+ * @brief Grafo dirigido da mansão em formato CSR (Compressed Sparse Rows).
+ *
+ * As saídas da sala v ficam em destinos[inicio_saidas[v] .. inicio_saidas[v + 1]).
+ * Todas as saídas ficam contíguas em um único vetor, o que deixa a BFS
+ * percorrendo memória sequencial em vez de seguir ponteiros.
+ */
+typedef struct {
+    int num_salas;
+    int num_saidas;      // Total de arestas dirigidas
+    Sala **salas;        // Índice -> sala
+    int *inicio_saidas;  // num_salas + 1 posições
+    int *destinos;       // num_saidas posições
+
+    // Áreas de trabalho das consultas com parada antecipada (rota, pista mais próxima)
+    int *marca;          // marca[v] == geracao -> v já visitada na consulta atual
+    int *anterior;       // Predecessor de cada sala na última consulta
+    int *fila;           // Fila da BFS
+    int geracao;
+    int vetores_mapeados; // 1 se inicio_saidas/destinos apontam para um snapshot mapeado
+} GrafoMansao;
+
+// ------------------------------------------
+// 5. ESTRUTURAS DO SNAPSHOT (Persistência)
+// ------------------------------------------
+
+/**
+ * @brief Cabeçalho do arquivo de snapshot da investigação.
+ *
+ * O arquivo guarda os registros de Sala, PistaNode e HashNode com o mesmo layout
+ * da memória, mas com os ponteiros trocados por deslocamentos a partir do início
+ * do arquivo (0 = NULL). Os vetores CSR do grafo já são baseados em índices e são
+ * usados diretamente da região mapeada.
+ */
+typedef struct {
+    char magica[8];                 // "DQSNAP1"
+    uint32_t versao;
+    uint32_t tam_sala;              // sizeof dos registros: o layout depende da plataforma
+    uint32_t tam_pista;
+    uint32_t tam_hash;
+    int32_t num_salas;
+    int32_t num_pistas;
+    int32_t num_hash;
+    int32_t num_saidas;
+    int32_t sala_atual;             // Índice da sala onde o jogador parou
+    int32_t reservado;
+    uint64_t desloc_salas;          // Registros Sala em ordem de índice do grafo
+    uint64_t desloc_pistas;         // Registros PistaNode (BST de pistas coletadas)
+    uint64_t desloc_hash;           // Registros HashNode (Tabela Hash de suspeitos)
+    uint64_t desloc_inicio_saidas;  // CSR: num_salas + 1 inteiros
+    uint64_t desloc_destinos;       // CSR: num_saidas inteiros
+    uint64_t raiz_pistas;           // Deslocamento da raiz da BST (0 = vazia)
+    uint64_t baldes[TAMANHO_HASH];  // Deslocamento do primeiro nó de cada balde
+    uint64_t tamanho_total;
+} CabecalhoSnapshot;
+
+/**
+ * @brief Região de memória de um snapshot carregado com mmap.
+ */
+typedef struct {
+    char *base;
+    size_t tamanho;
+} RegiaoSnapshot;
+
+// ------------------------------------------
+// 6. ESTRUTURAS DO RESOLVEDOR EXAUSTIVO
+// ------------------------------------------
+
+/**
+ * @brief Subárvore do mapa a ser enumerada por uma thread do resolvedor.
+ */
+typedef struct {
+    Sala *sala;
+    int *prefixo;      // Ids das pistas no caminho da raiz até o pai da sala
+    int tam_prefixo;
+} TarefaResolvedor;
+
+/**
+ * @brief Fila dupla de tarefas de uma thread (work-stealing).
+ *
+ * A dona empilha e desempilha no fim (LIFO, mantém a localidade); as demais
+ * roubam do início, onde estão as subárvores mais próximas da raiz (maiores).
+ */
+typedef struct {
+    TarefaResolvedor *tarefas;   // Vetor circular
+    int inicio;
+    int qtd;
+    int capacidade;
+    pthread_mutex_t trava;
+} FilaTrabalho;
+
+/**
+ * @brief Dados compartilhados (somente leitura durante a enumeração) e filas do resolvedor.
+ */
+typedef struct {
+    const char **textos_pista;   // Id da pista -> texto (da Tabela Hash)
+    int *suspeito_da_pista;      // Id da pista -> id do suspeito
+    int num_pistas;
+    MapaTextoId ids;             // Texto -> id da pista
+    const char **suspeitos;      // Id do suspeito -> nome
+    int num_suspeitos;
+    int num_threads;
+    FilaTrabalho filas[MAX_THREADS_RESOLVEDOR];
+    long pendentes;              // Tarefas criadas e ainda não concluídas (atômico)
+} Resolvedor;
+
+/**
+ * @brief Estado local de uma thread: contagem de evidências do caminho atual e resultados parciais.
+ */
+typedef struct {
+    Resolvedor *resolvedor;
+    int indice;
+    int *vistas;                 // Id da pista -> ocorrências no caminho atual
+    int *evidencias;             // Id do suspeito -> pistas distintas no caminho atual
+    int acusaveis;               // Suspeitos com evidencias >= PISTAS_MINIMAS
+    int *caminho;                // Ids das pistas no caminho atual (prefixo das tarefas criadas)
+    int tam_caminho;
+    int cap_caminho;
+    long long caminhos;          // Caminhos raiz-folha enumerados
+    long long resolviveis;       // ... com pelo menos um suspeito acusável
+    long long ambiguos;          // ... com mais de um suspeito acusável
+    long long *acusavel_por_suspeito;
+    long long salas_visitadas;
+    long long tarefas_roubadas;
+} TrabalhadorResolvedor;
+
 // Ponteiros globais
-PistaNode *raiz_pistas = NULL;
+PistaNode *raiz_pistas = NULL;      // Versão atual da BST de pistas
+BlocoPistas *arena_pistas = NULL;   // Arena com os nós de todas as versões
 TabelaHash tabela_suspeitos; 
+GrafoMansao *grafo_mansao = NULL; // Grafo construído a partir do mapa (rotas e BFS)
+IndicePistas indice_pistas;       // Índice de busca sobre as pistas coletadas
+HistoricoInvestigacao historico = { NULL, 0, 0, NULL, 0, 0 }; // Coletas e ramificações
+RegiaoSnapshot snapshot_carregado = { NULL, 0 }; // Snapshot mapeado (nós que não vieram de malloc)
+const char *arquivo_snapshot = ARQUIVO_SNAPSHOT;  // Destino do comando de gravação
+
+/**
+ * @brief Indica se um nó pertence à região do snapshot mapeado (e não deve ir para free).
+ */
+int pertenceAoSnapshot(const void *ponteiro) {
+    const char *p = (const char*)ponteiro;
+    return snapshot_carregado.base != NULL && p >= snapshot_carregado.base &&
+           p < snapshot_carregado.base + snapshot_carregado.tamanho;
+}
+
+// ------------------------------------------
+// 7. ESTRUTURAS DO GERADOR DE CARGA
+// ------------------------------------------
+
+/**
+ * @brief Vetor dinâmico de durações em segundos (núcleo comum).
+ */
+DEFINIR_VETOR(VetorTempos, double)
+
+/**
+ * @brief Texto montado em memória: comandos de uma sessão sorteada.
+ */
+DEFINIR_VETOR(TextoSessao, char)
+
+/**
+ * @brief Vetor dinâmico de textos (pistas e suspeitos sorteados pelo gerador de carga).
+ */
+DEFINIR_VETOR(VetorTextos, const char*)
+
+/**
+ * @brief Latências coletadas pelo gerador de carga, uma lista por tipo de passo (TIPOS_PASSO).
+ */
+typedef struct {
+    VetorTempos tempos[sizeof(TIPOS_PASSO) - 1];
+} MedicaoCarga;
+
+FILE *entrada_jogo = NULL;           // Origem dos comandos do jogador (stdin ou sessão da carga)
+MedicaoCarga *medicao_carga = NULL;  // Não nulo enquanto o gerador de carga roda
 
+/**
+ * @brief Registra a duração de um passo da exploração na medição da carga.
+ *
+ * @param tipo Letra de TIPOS_PASSO; comandos desconhecidos contam como '?'.
+ */
+void registrarPasso(MedicaoCarga *medicao, char tipo, double segundos) {
+    const char *posicao = strchr(TIPOS_PASSO, tipo);
+    if (tipo == '\0' || posicao == NULL) {
+        posicao = strchr(TIPOS_PASSO, '?');
+    }
+    VetorTempos_acrescentar(&medicao->tempos[posicao - TIPOS_PASSO], segundos);
+}
 
 // ------------------------------------------
-// 5. FUNÇÕES DA TABELA HASH
+// 8. FUNÇÕES DA TABELA HASH
 // ------------------------------------------
 
 /**
@@ -104,7 +464,7 @@ int calcularHash(const char *chave) {
  */
 void inserirNaHash(const char *pista, const char *suspeito) {
     int indice = calcularHash(pista);
-    HashNode *novoNo = (HashNode*)malloc(sizeof(HashNode));
+    HashNode *novoNo = (HashNode*)mallocContado(sizeof(HashNode));
     
     if (novoNo == NULL) {
         perror("Erro ao alocar memoria para HashNode.");
@@ -119,6 +479,13 @@ void inserirNaHash(const char *pista, const char *suspeito) {
     // Encademento Separado: Insere no início da lista do balde
     novoNo->proximo = tabela_suspeitos.tabela[indice];
     tabela_suspeitos.tabela[indice] = novoNo;
+#ifdef TELEMETRIA
+    int comprimento = 0;
+    for (HashNode *no = novoNo; no != NULL; no = no->proximo) {
+        comprimento++;
+    }
+    TELEMETRIA_CONTAR("hash.comprimento_cadeia", comprimento);
+#endif
     
     printf("  [HASH REGISTRO] Pista associada a '%s' (indice %d).\n", suspeito, indice);
 }
@@ -133,15 +500,19 @@ void inserirNaHash(const char *pista, const char *suspeito) {
 const char* encontrarSuspeito(const char *pista) {
     int indice = calcularHash(pista);
     HashNode *atual = tabela_suspeitos.tabela[indice];
+    int sondagens = 0;
     
     // Percorre a lista ligada (Encadeamento)
     while (atual != NULL) {
+        sondagens++;
         if (strcmp(atual->pista, pista) == 0) {
+            TELEMETRIA_CONTAR("hash.sondagens", sondagens);
             return atual->suspeito; // Suspeito encontrado
         }
         atual = atual->proximo;
     }
     
+    TELEMETRIA_CONTAR("hash.sondagens", sondagens);
     return "DESCONHECIDO"; // Pista sem associação na Hash
 }
 
@@ -154,36 +525,111 @@ void liberarHash() {
         while (atual != NULL) {
             HashNode *temp = atual;
             atual = atual->proximo;
-            free(temp);
+            if (!pertenceAoSnapshot(temp)) {
+                freeContado(temp);
+            }
         }
         tabela_suspeitos.tabela[i] = NULL;
     }
 }
 
 // ------------------------------------------
-// 6. FUNÇÕES DA BST
+// 9. FUNÇÕES DA BST
 // ------------------------------------------
 
 /**
- * @brief Cria e aloca um novo nó para a BST de Pistas.
+ * @brief Aloca um nó da BST de Pistas na arena (blocos de NOS_POR_BLOCO nós).
+ *
+ * Como as versões da BST compartilham nós, eles não são liberados um a um:
+ * a arena inteira é liberada no fim com liberarPistas().
  */
-PistaNode* criarPistaNode(const char *conteudo) {
-    PistaNode *novoNo = (PistaNode*)malloc(sizeof(PistaNode));
-    if (novoNo == NULL) {
-        perror("Erro ao alocar memoria para PistaNode.");
-        exit(EXIT_FAILURE);
+PistaNode* alocarPistaNode() {
+    if (arena_pistas == NULL || arena_pistas->usados == NOS_POR_BLOCO) {
+        BlocoPistas *bloco = (BlocoPistas*)mallocContado(sizeof(BlocoPistas));
+        if (bloco == NULL) {
+            perror("Erro ao alocar memoria para PistaNode.");
+            exit(EXIT_FAILURE);
+        }
+        bloco->anterior = arena_pistas;
+        bloco->usados = 0;
+        arena_pistas = bloco;
     }
+    return &arena_pistas->nos[arena_pistas->usados++];
+}
+
+/**
+ * @brief Retorna a altura de um nó (0 para NULL).
+ */
+int alturaPista(const PistaNode *no) {
+    return no != NULL ? no->altura : 0;
+}
+
+/**
+ * @brief Cria um nó com o texto e os filhos informados (altura calculada a partir dos filhos).
+ */
+PistaNode* montarPistaNode(const char *conteudo, PistaNode *esquerda, PistaNode *direita) {
+    PistaNode *novoNo = alocarPistaNode();
     strncpy(novoNo->pista, conteudo, MAX_PISTA - 1);
     novoNo->pista[MAX_PISTA - 1] = '\0';
-    novoNo->esquerda = NULL;
-    novoNo->direita = NULL;
+    novoNo->esquerda = esquerda;
+    novoNo->direita = direita;
+    int he = alturaPista(esquerda), hd = alturaPista(direita);
+    novoNo->altura = 1 + (he > hd ? he : hd);
     return novoNo;
 }
 
 /**
- * @brief Insere uma nova pista na BST de forma recursiva.
+ * @brief Cria e aloca um novo nó para a BST de Pistas.
+ */
+PistaNode* criarPistaNode(const char *conteudo) {
+    return montarPistaNode(conteudo, NULL, NULL);
+}
+
+/**
+ * @brief Monta um novo nó com o conteúdo de 'base' e os filhos dados, rebalanceando (AVL).
+ *
+ * Nenhum nó existente é alterado: rotações criam nós novos, então versões
+ * anteriores da árvore continuam válidas.
+ */
+PistaNode* balancearPista(const PistaNode *base, PistaNode *esquerda, PistaNode *direita) {
+    int he = alturaPista(esquerda), hd = alturaPista(direita);
+
+    if (he > hd + 1) {
+        if (alturaPista(esquerda->esquerda) >= alturaPista(esquerda->direita)) {
+            // Rotação simples à direita
+            return montarPistaNode(esquerda->pista, esquerda->esquerda,
+                                   montarPistaNode(base->pista, esquerda->direita, direita));
+        }
+        // Rotação dupla esquerda-direita
+        PistaNode *meio = esquerda->direita;
+        return montarPistaNode(meio->pista,
+                               montarPistaNode(esquerda->pista, esquerda->esquerda, meio->esquerda),
+                               montarPistaNode(base->pista, meio->direita, direita));
+    }
+    if (hd > he + 1) {
+        if (alturaPista(direita->direita) >= alturaPista(direita->esquerda)) {
+            // Rotação simples à esquerda
+            return montarPistaNode(direita->pista,
+                                   montarPistaNode(base->pista, esquerda, direita->esquerda),
+                                   direita->direita);
+        }
+        // Rotação dupla direita-esquerda
+        PistaNode *meio = direita->esquerda;
+        return montarPistaNode(meio->pista,
+                               montarPistaNode(base->pista, esquerda, meio->esquerda),
+                               montarPistaNode(direita->pista, meio->direita, direita->direita));
+    }
+    return montarPistaNode(base->pista, esquerda, direita);
+}
+
+/**
+ * @brief Insere uma nova pista na BST de forma recursiva, sem alterar a versão recebida.
  *
  * Requisito: Armazenar as pistas coletadas em ordem.
+ * A árvore é persistente: apenas o caminho até a nova folha é copiado
+ * (O(log n) nós, pois a árvore é mantida balanceada como AVL) e a raiz
+ * antiga continua representando a versão anterior.
+ * @return PistaNode* A raiz da nova versão (a mesma raiz se a pista já existia).
  */
 PistaNode* inserirPista(PistaNode *raiz, const char *conteudo) {
     if (raiz == NULL) {
@@ -193,15 +639,31 @@ PistaNode* inserirPista(PistaNode *raiz, const char *conteudo) {
     int comparacao = strcmp(conteudo, raiz->pista);
 
     if (comparacao < 0) {
-        raiz->esquerda = inserirPista(raiz->esquerda, conteudo);
+        PistaNode *esquerda = inserirPista(raiz->esquerda, conteudo);
+        return esquerda == raiz->esquerda ? raiz : balancearPista(raiz, esquerda, raiz->direita);
     } else if (comparacao > 0) {
-        raiz->direita = inserirPista(raiz->direita, conteudo);
-    } 
-    // Ignora duplicatas
+        PistaNode *direita = inserirPista(raiz->direita, conteudo);
+        return direita == raiz->direita ? raiz : balancearPista(raiz, raiz->esquerda, direita);
+    }
+    // Ignora duplicatas (a versão não muda)
 
     return raiz;
 }
 
+/**
+ * @brief Profundidade da pista na árvore (raiz = 1), ou 0 se ela não está lá.
+ */
+int profundidadePista(const PistaNode *raiz, const char *conteudo) {
+    for (int profundidade = 1; raiz != NULL; profundidade++) {
+        int comparacao = strcmp(conteudo, raiz->pista);
+        if (comparacao == 0) {
+            return profundidade;
+        }
+        raiz = comparacao < 0 ? raiz->esquerda : raiz->direita;
+    }
+    return 0;
+}
+
 /**
  * @brief Exibe todas as pistas coletadas (Percurso Em Ordem).
  */
@@ -214,93 +676,1481 @@ void exibirPistas(PistaNode *raiz) {
 }
 
 /**
- * @brief Libera recursivamente a memória alocada para a BST de pistas.
+ * @brief Libera a arena de nós da BST (todas as versões de uma vez).
+ *
+ * Nós restaurados de um snapshot vivem na região mapeada e não estão na arena.
  */
-void liberarPistas(PistaNode *raiz) {
-    if (raiz != NULL) {
-        liberarPistas(raiz->esquerda);
-        liberarPistas(raiz->direita);
-        free(raiz);
+void liberarPistas() {
+    while (arena_pistas != NULL) {
+        BlocoPistas *anterior = arena_pistas->anterior;
+        freeContado(arena_pistas);
+        arena_pistas = anterior;
     }
 }
 
 // ------------------------------------------
-// 7. FUNÇÕES DO MAPA (ÁRVORE BINÁRIA)
+// 10. FUNÇÕES DO ÍNDICE DE BUSCA DE PISTAS
 // ------------------------------------------
 
 /**
- * @brief Cria e inicializa um novo cômodo (nó) da mansão.
- *
- * Requisito: Cria dinamicamente um cômodo com nome e pista estática.
- * @param nome O nome do cômodo.
- * @param pista O conteúdo da pista estática da sala.
- * @return Sala* Um ponteiro para a nova sala criada.
+ * @brief Retorna o instante atual de um relógio monotônico, em segundos.
  */
-Sala* criarSala(const char *nome, const char *pista) {
-    Sala *novaSala = (Sala*)malloc(sizeof(Sala));
-    if (novaSala == NULL) {
-        perror("Erro ao alocar memoria para a sala.");
+double tempoAtual() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Realoca um vetor dobrando a capacidade quando necessário.
+ */
+void* garantirCapacidade(void *vetor, int *capacidade, int necessario, size_t tamanho_item) {
+    if (necessario <= *capacidade) {
+        return vetor;
+    }
+    int nova = *capacidade > 0 ? *capacidade : 16;
+    while (nova < necessario) {
+        nova *= 2;
+    }
+    vetor = reallocContado(vetor, (size_t)nova * tamanho_item);
+    if (vetor == NULL) {
+        perror("Erro ao alocar memoria para o indice de pistas.");
         exit(EXIT_FAILURE);
     }
+    *capacidade = nova;
+    return vetor;
+}
 
-    strncpy(novaSala->nome, nome, MAX_NOME - 1);
-    strncpy(novaSala->pista_estatica, pista, MAX_PISTA - 1);
-    novaSala->pista_coletada = 0; // Pista não coletada inicialmente
+/**
+ * @brief Inicializa o índice vazio (apenas a raiz da trie).
+ */
+void inicializarIndice(IndicePistas *indice) {
+    memset(indice, 0, sizeof(IndicePistas));
+    indice->nos = (NoTermo*)garantirCapacidade(NULL, &indice->cap_nos, 1, sizeof(NoTermo));
+    indice->nos[0] = (NoTermo){ 0, -1, -1, -1 };
+    indice->num_nos = 1;
+}
 
-    novaSala->esquerda = NULL;
-    novaSala->direita = NULL;
+/**
+ * @brief Libera toda a memória do índice.
+ */
+void liberarIndice(IndicePistas *indice) {
+    for (int i = 0; i < indice->num_pistas; i++) {
+        freeContado(indice->textos[i]);
+    }
+    for (int t = 0; t < indice->num_termos; t++) {
+        VetorInteiros_liberar(&indice->ocorrencias[t]);
+    }
+    freeContado(indice->textos);
+    MapaTextoId_liberar(&indice->ids);
+    freeContado(indice->nos);
+    freeContado(indice->ocorrencias);
+    freeContado(indice->marca);
+    freeContado(indice->ativa);
+    memset(indice, 0, sizeof(IndicePistas));
+}
 
-    return novaSala;
+/**
+ * @brief Procura o id de uma pista pelo texto completo.
+ *
+ * @return int O id da pista, ou -1 se ainda não indexada.
+ */
+int buscarIdPista(const IndicePistas *indice, const char *texto) {
+    const int *id = MapaTextoId_buscar(&indice->ids, texto);
+    return id != NULL ? *id : -1;
 }
 
 /**
- * @brief Constrói o mapa fixo da mansão (Árvore Binária) e configura as pistas.
+ * @brief Extrai o próximo termo (sequência alfanumérica, em minúsculas) do texto.
  *
- * As pistas estão associadas à sala e serão coletadas apenas uma vez.
- * @return Sala* O ponteiro para o nó Raiz (Hall de Entrada).
+ * @param cursor Posição atual no texto; avança para depois do termo.
+ * @param termo Buffer de saída com pelo menos MAX_PISTA posições.
+ * @return int Tamanho do termo, ou 0 quando o texto termina.
  */
-Sala* montarMapa() {
-    // Definindo o mapa e as pistas estáticas
-    Sala *hall = criarSala("Hall de Entrada", "A altura do culpado e acima de 1.80m.");
+int proximoTermo(const char **cursor, char *termo) {
+    const unsigned char *c = (const unsigned char*)*cursor;
+    while (*c != '\0' && !isalnum(*c)) {
+        c++;
+    }
+    int tamanho = 0;
+    while (*c != '\0' && isalnum(*c)) {
+        if (tamanho < MAX_PISTA - 1) {
+            termo[tamanho++] = (char)tolower(*c);
+        }
+        c++;
+    }
+    termo[tamanho] = '\0';
+    *cursor = (const char*)c;
+    return tamanho;
+}
 
-    hall->esquerda = criarSala("Sala de Estar", "O culpado fuma charutos cubanos.");
-    hall->direita = criarSala("Cozinha", "O culpado possui uma alergia a amendoim.");
+/**
+ * @brief Desce na trie seguindo o termo.
+ *
+ * @param criar 1 para criar os nós que faltarem, 0 apenas para consultar.
+ * @return int O índice do nó do termo, ou -1 se não existe (com criar = 0).
+ */
+int descerTrie(IndicePistas *indice, const char *termo, int criar) {
+    int no = 0;
+    for (const unsigned char *c = (const unsigned char*)termo; *c != '\0'; c++) {
+        // Irmãos ordenados por letra: para no primeiro >= *c
+        int anterior = -1, filho = indice->nos[no].primeiro_filho;
+        while (filho != -1 && indice->nos[filho].letra < *c) {
+            anterior = filho;
+            filho = indice->nos[filho].proximo_irmao;
+        }
+        if (filho == -1 || indice->nos[filho].letra != *c) {
+            if (!criar) {
+                return -1;
+            }
+            indice->nos = (NoTermo*)garantirCapacidade(indice->nos, &indice->cap_nos, indice->num_nos + 1, sizeof(NoTermo));
+            int novo = indice->num_nos++;
+            indice->nos[novo] = (NoTermo){ *c, -1, filho, -1 };
+            if (anterior == -1) {
+                indice->nos[no].primeiro_filho = novo;
+            } else {
+                indice->nos[anterior].proximo_irmao = novo;
+            }
+            filho = novo;
+        }
+        no = filho;
+    }
+    return no;
+}
 
-    hall->esquerda->esquerda = criarSala("Quarto Principal", "O culpado tem um relogio suico de ouro.");
-    hall->esquerda->direita = criarSala("Biblioteca", "A arma do crime e um castical de bronze.");
+/**
+ * @brief Indexa uma pista coletada (chamada a cada coleta em explorarSalas).
+ *
+ * Custo proporcional ao tamanho do texto; pistas repetidas não são reindexadas.
+ * @return int O id da pista no índice.
+ */
+int adicionarAoIndice(IndicePistas *indice, const char *texto) {
+    int existente = buscarIdPista(indice, texto);
+    if (existente != -1) {
+        // Já indexada: apenas volta a valer (pode ter sido desfeita por uma ramificação)
+        if (!indice->ativa[existente]) {
+            indice->ativa[existente] = 1;
+            indice->num_ativas++;
+        }
+        return existente;
+    }
 
-    hall->direita->direita = criarSala("Dispensa", "O culpado deixou um lenco bordado com a letra 'C'."); 
-    
-    hall->esquerda->esquerda->esquerda = criarSala("Banheiro", "A digital do culpado esta na lamina da faca.");
+    int id = indice->num_pistas;
+    indice->textos = (char**)garantirCapacidade(indice->textos, &indice->cap_pistas, id + 1, sizeof(char*));
+    indice->textos[id] = (char*)mallocContado(strlen(texto) + 1);
+    if (indice->textos[id] == NULL) {
+        perror("Erro ao alocar memoria para o indice de pistas.");
+        exit(EXIT_FAILURE);
+    }
+    strcpy(indice->textos[id], texto);
+    MapaTextoId_inserir(&indice->ids, indice->textos[id], id);
+    indice->num_pistas++;
+    indice->ativa = (char*)garantirCapacidade(indice->ativa, &indice->cap_ativa, id + 1, sizeof(char));
+    indice->ativa[id] = 1;
+    indice->num_ativas++;
 
-    return hall;
+    char termo[MAX_PISTA];
+    const char *cursor = texto;
+    while (proximoTermo(&cursor, termo) > 0) {
+        int no = descerTrie(indice, termo, 1);
+        if (indice->nos[no].termo == -1) {
+            indice->ocorrencias = (ListaOcorrencias*)garantirCapacidade(indice->ocorrencias, &indice->cap_termos,
+                                                                        indice->num_termos + 1, sizeof(ListaOcorrencias));
+            VetorInteiros_iniciar(&indice->ocorrencias[indice->num_termos]);
+            indice->nos[no].termo = indice->num_termos++;
+        }
+        ListaOcorrencias *lista = &indice->ocorrencias[indice->nos[no].termo];
+        if (lista->qtd == 0 || *VetorInteiros_ultimo(lista) != id) { // Termo repetido na mesma pista
+            VetorInteiros_acrescentar(lista, id);
+        }
+    }
+    return id;
 }
 
 /**
- * @brief Libera recursivamente a memória alocada para o mapa da mansão.
+ * @brief Indica se o texto já está indexado e ativo na versão atual.
  */
-void liberarMapa(Sala *sala) {
-    if (sala != NULL) {
-        liberarMapa(sala->esquerda);
-        liberarMapa(sala->direita);
-        free(sala);
+int pistaAtivaNoIndice(const IndicePistas *indice, const char *texto) {
+    int id = buscarIdPista(indice, texto);
+    return id != -1 && indice->ativa[id];
+}
+
+/**
+ * @brief Retira uma pista dos resultados (a coleta foi desfeita), mantendo seus termos indexados.
+ */
+void desativarPistaNoIndice(IndicePistas *indice, int id) {
+    if (id >= 0 && id < indice->num_pistas && indice->ativa[id]) {
+        indice->ativa[id] = 0;
+        indice->num_ativas--;
     }
 }
 
-// ------------------------------------------
-// 8. FUNÇÃO DE JULGAMENTO FINAL
-// ------------------------------------------
+/**
+ * @brief Comparador de inteiros para qsort.
+ */
+int compararInteiros(const void *a, const void *b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
 
 /**
- * @brief Conta recursivamente quantas pistas na BST apontam para o suspeito acusado.
+ * @brief Reúne, sem repetições e em ordem crescente, as pistas de todos os termos com o prefixo.
  *
- * @param no O nó atual da BST (pista coletada).
- * @param acusado O nome do suspeito acusado.
- * @return int A contagem de pistas que sustentam a acusação.
+ * @param quantidade Saída: tamanho do vetor retornado.
+ * @return int* Vetor alocado com os ids (liberar com free), ou NULL se nenhum termo tem o prefixo.
  */
-int contarPistasParaSuspeito(PistaNode *no, const char *acusado) {
-    if (no == NULL) {
-        return 0;
+int* pistasComPrefixo(IndicePistas *indice, const char *prefixo, int *quantidade) {
+    *quantidade = 0;
+    int no_prefixo = descerTrie(indice, prefixo, 0);
+    if (no_prefixo == -1) {
+        return NULL;
+    }
+
+    if (indice->cap_marca < indice->num_pistas) {
+        indice->marca = (int*)reallocContado(indice->marca, indice->cap_pistas * sizeof(int));
+        if (indice->marca == NULL) {
+            perror("Erro ao alocar memoria para o indice de pistas.");
+            exit(EXIT_FAILURE);
+        }
+        memset(indice->marca + indice->cap_marca, 0, (indice->cap_pistas - indice->cap_marca) * sizeof(int));
+        indice->cap_marca = indice->cap_pistas;
+    }
+    if (++indice->geracao <= 0) {
+        memset(indice->marca, 0, indice->cap_marca * sizeof(int));
+        indice->geracao = 1;
+    }
+
+    VetorInteiros resultado, pilha;
+    VetorInteiros_iniciar(&resultado);
+    VetorInteiros_iniciar(&pilha);
+    VetorInteiros_acrescentar(&pilha, no_prefixo);
+
+    // Percorre a subárvore do prefixo unindo as listas de ocorrências
+    while (pilha.qtd > 0) {
+        int no = VetorInteiros_retirarUltimo(&pilha);
+        if (indice->nos[no].termo != -1) {
+            ListaOcorrencias *lista = &indice->ocorrencias[indice->nos[no].termo];
+            for (int i = 0; i < lista->qtd; i++) {
+                int id = lista->itens[i];
+                if (indice->marca[id] != indice->geracao) {
+                    indice->marca[id] = indice->geracao;
+                    VetorInteiros_acrescentar(&resultado, id);
+                }
+            }
+        }
+        for (int filho = indice->nos[no].primeiro_filho; filho != -1; filho = indice->nos[filho].proximo_irmao) {
+            VetorInteiros_acrescentar(&pilha, filho);
+        }
+    }
+    VetorInteiros_liberar(&pilha);
+
+    *quantidade = resultado.qtd;
+    if (resultado.itens != NULL) {
+        qsort(resultado.itens, resultado.qtd, sizeof(int), compararInteiros);
+    }
+    return resultado.itens;
+}
+
+/**
+ * @brief Busca pistas que contêm todos os termos da consulta.
+ *
+ * Cada termo é uma palavra-chave exata ("faca") ou, terminado em '*', um
+ * prefixo ("culp*"). Os conjuntos de cada termo são intersectados em ordem,
+ * percorrendo o menor e galopando sobre o maior.
+ * @param resultados Saída: ids das pistas encontradas (as max primeiras).
+ * @return int Quantidade total de pistas encontradas.
+ */
+int buscarPistas(IndicePistas *indice, const char *consulta, int *resultados, int max) {
+    int *atual = NULL, qtd_atual = -1; // -1: nenhum termo processado ainda
+    char termo[MAX_PISTA];
+    const char *cursor = consulta;
+
+    while (qtd_atual != 0 && proximoTermo(&cursor, termo) > 0) {
+        int *conjunto = NULL, qtd_conjunto = 0, alocado = 0;
+        if (*cursor == '*') {
+            conjunto = pistasComPrefixo(indice, termo, &qtd_conjunto);
+            alocado = 1;
+        } else {
+            int no = descerTrie(indice, termo, 0);
+            if (no != -1 && indice->nos[no].termo != -1) {
+                conjunto = indice->ocorrencias[indice->nos[no].termo].itens;
+                qtd_conjunto = indice->ocorrencias[indice->nos[no].termo].qtd;
+            }
+        }
+
+        if (qtd_atual == -1) {
+            // Primeiro termo: copia o conjunto
+            atual = (int*)mallocContado((qtd_conjunto > 0 ? qtd_conjunto : 1) * sizeof(int));
+            if (atual == NULL) {
+                perror("Erro ao alocar memoria para a busca.");
+                exit(EXIT_FAILURE);
+            }
+            if (qtd_conjunto > 0) {
+                memcpy(atual, conjunto, qtd_conjunto * sizeof(int));
+            }
+            qtd_atual = qtd_conjunto;
+        } else {
+            // Interseção: percorre o menor conjunto e localiza cada id no maior
+            // com busca exponencial (galope) a partir da última posição encontrada
+            const int *menor = qtd_atual <= qtd_conjunto ? atual : conjunto;
+            const int *maior = qtd_atual <= qtd_conjunto ? conjunto : atual;
+            int qtd_menor = qtd_atual <= qtd_conjunto ? qtd_atual : qtd_conjunto;
+            int qtd_maior = qtd_atual <= qtd_conjunto ? qtd_conjunto : qtd_atual;
+            int mantidos = 0, base = 0;
+            for (int i = 0; i < qtd_menor && base < qtd_maior; i++) {
+                int passo = 1;
+                while (base + passo < qtd_maior && maior[base + passo] < menor[i]) {
+                    passo *= 2;
+                }
+                int inicio = base + passo / 2, fim = base + passo < qtd_maior ? base + passo + 1 : qtd_maior;
+                while (inicio < fim) {
+                    int meio = inicio + (fim - inicio) / 2;
+                    if (maior[meio] < menor[i]) {
+                        inicio = meio + 1;
+                    } else {
+                        fim = meio;
+                    }
+                }
+                base = inicio;
+                if (base < qtd_maior && maior[base] == menor[i]) {
+                    atual[mantidos++] = menor[i]; // mantidos <= i e <= base: nada ainda não lido é sobrescrito
+                }
+            }
+            qtd_atual = mantidos;
+        }
+        if (alocado) {
+            freeContado(conjunto);
+        }
+        if (*cursor == '*') {
+            cursor++;
+        }
+    }
+
+    // Descarta pistas de coletas desfeitas
+    int encontradas = 0;
+    for (int i = 0; i < qtd_atual; i++) {
+        if (indice->ativa[atual[i]]) {
+            if (encontradas < max) {
+                resultados[encontradas] = atual[i];
+            }
+            encontradas++;
+        }
+    }
+    freeContado(atual);
+    return encontradas;
+}
+
+/**
+ * @brief Pergunta os termos ao jogador e exibe as pistas coletadas que os contêm.
+ */
+void buscarPistasInterativo(IndicePistas *indice) {
+    char consulta[MAX_PISTA];
+    int resultados[MAX_RESULTADOS_BUSCA];
+
+    printf("Termos da busca (ex: 'faca', 'culpado relogio', 'cha*'): ");
+    if (fscanf(entrada_jogo, " %99[^\n]", consulta) != 1) {
+        printf("[ERRO] Entrada invalida.\n");
+        return;
+    }
+
+    double inicio = tempoAtual();
+    TELEMETRIA_INICIO(marca_busca);
+    int total = buscarPistas(indice, consulta, resultados, MAX_RESULTADOS_BUSCA);
+    TELEMETRIA_FIM(marca_busca, "indice.buscar");
+    double micros = (tempoAtual() - inicio) * 1e6;
+
+    printf("[BUSCA] %d pista(s) entre %d coletada(s) (%.1f us):\n", total, indice->num_ativas, micros);
+    for (int i = 0; i < total && i < MAX_RESULTADOS_BUSCA; i++) {
+        printf("- %s\n", indice->textos[resultados[i]]);
+    }
+    if (total > MAX_RESULTADOS_BUSCA) {
+        printf("  ... (%d resultados omitidos)\n", total - MAX_RESULTADOS_BUSCA);
+    }
+}
+
+// ------------------------------------------
+// 11. FUNÇÕES DO MAPA (ÁRVORE BINÁRIA)
+// ------------------------------------------
+
+/**
+ * @brief Cria e inicializa um novo cômodo (nó) da mansão.
+ *
+ * Requisito: Cria dinamicamente um cômodo com nome e pista estática.
+ * @param nome O nome do cômodo.
+ * @param pista O conteúdo da pista estática da sala.
+ * @return Sala* Um ponteiro para a nova sala criada.
+ */
+Sala* criarSala(const char *nome, const char *pista) {
+    Sala *novaSala = (Sala*)mallocContado(sizeof(Sala));
+    if (novaSala == NULL) {
+        perror("Erro ao alocar memoria para a sala.");
+        exit(EXIT_FAILURE);
+    }
+
+    strncpy(novaSala->nome, nome, MAX_NOME - 1);
+    strncpy(novaSala->pista_estatica, pista, MAX_PISTA - 1);
+    novaSala->pista_coletada = 0; // Pista não coletada inicialmente
+    novaSala->id = -1;            // Definido ao construir o grafo
+
+    novaSala->esquerda = NULL;
+    novaSala->direita = NULL;
+
+    return novaSala;
+}
+
+/**
+ * @brief Constrói o mapa fixo da mansão (Árvore Binária) e configura as pistas.
+ *
+ * As pistas estão associadas à sala e serão coletadas apenas uma vez.
+ * @return Sala* O ponteiro para o nó Raiz (Hall de Entrada).
+ */
+Sala* montarMapa() {
+    // Definindo o mapa e as pistas estáticas
+    Sala *hall = criarSala("Hall de Entrada", "A altura do culpado e acima de 1.80m.");
+
+    hall->esquerda = criarSala("Sala de Estar", "O culpado fuma charutos cubanos.");
+    hall->direita = criarSala("Cozinha", "O culpado possui uma alergia a amendoim.");
+
+    hall->esquerda->esquerda = criarSala("Quarto Principal", "O culpado tem um relogio suico de ouro.");
+    hall->esquerda->direita = criarSala("Biblioteca", "A arma do crime e um castical de bronze.");
+
+    hall->direita->direita = criarSala("Dispensa", "O culpado deixou um lenco bordado com a letra 'C'."); 
+    
+    hall->esquerda->esquerda->esquerda = criarSala("Banheiro", "A digital do culpado esta na lamina da faca.");
+
+    return hall;
+}
+
+/**
+ * @brief Gerador pseudoaleatório xorshift32 com estado explícito.
+ *
+ * Usado no lugar de rand() para que mapas gerados sejam reproduzíveis
+ * a partir da semente e para que cada thread possa ter seu próprio estado.
+ */
+unsigned int proximoAleatorio(unsigned int *estado) {
+    unsigned int x = *estado ? *estado : 0x9E3779B9u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *estado = x;
+    return x;
+}
+
+/**
+ * @brief Gera uma mansão procedural com num_salas cômodos (Árvore Binária aleatória).
+ *
+ * Cada nova sala ocupa uma vaga livre (esquerda ou direita) sorteada entre todas as
+ * salas já criadas, o que produz árvores com profundidade esperada O(log n).
+ * As pistas são sorteadas entre as já registradas na Tabela Hash, então o
+ * registro de suspeitos deve ser feito antes da geração.
+ * @param num_salas Quantidade de cômodos a gerar (mínimo 1).
+ * @param semente Semente do gerador pseudoaleatório.
+ * @return Sala* O ponteiro para o nó Raiz (Hall de Entrada).
+ */
+Sala* gerarMansaoProcedural(int num_salas, unsigned int semente) {
+    if (num_salas < 1) {
+        num_salas = 1;
+    }
+
+    // Coleta as pistas registradas na Hash para distribuí-las pelos cômodos
+    int total_pistas = 0;
+    for (int i = 0; i < TAMANHO_HASH; i++) {
+        for (HashNode *no = tabela_suspeitos.tabela[i]; no != NULL; no = no->proximo) {
+            total_pistas++;
+        }
+    }
+    const char **pistas = (const char**)mallocContado((total_pistas + 1) * sizeof(const char*));
+    // Vagas livres: endereço do campo esquerda/direita ainda NULL (no máximo num_salas + 1)
+    Sala ***vagas = (Sala***)mallocContado((num_salas + 1) * sizeof(Sala**));
+    if (pistas == NULL || vagas == NULL) {
+        perror("Erro ao alocar memoria para a mansao procedural.");
+        exit(EXIT_FAILURE);
+    }
+    total_pistas = 0;
+    for (int i = 0; i < TAMANHO_HASH; i++) {
+        for (HashNode *no = tabela_suspeitos.tabela[i]; no != NULL; no = no->proximo) {
+            pistas[total_pistas++] = no->pista;
+        }
+    }
+
+    unsigned int estado = semente;
+    char nome[MAX_NOME];
+    Sala *hall = criarSala("Hall de Entrada", total_pistas > 0 ? pistas[0] : "");
+    int qtd_vagas = 0;
+    vagas[qtd_vagas++] = &hall->esquerda;
+    vagas[qtd_vagas++] = &hall->direita;
+
+    for (int i = 1; i < num_salas; i++) {
+        const char *pista = "";
+        // Aproximadamente um terço dos cômodos guarda uma pista
+        if (total_pistas > 0 && proximoAleatorio(&estado) % 3 == 0) {
+            pista = pistas[proximoAleatorio(&estado) % total_pistas];
+        }
+        snprintf(nome, sizeof(nome), "Comodo %d", i);
+        Sala *nova = criarSala(nome, pista);
+
+        // Ocupa uma vaga sorteada e disponibiliza as duas vagas da nova sala
+        int sorteada = proximoAleatorio(&estado) % qtd_vagas;
+        *vagas[sorteada] = nova;
+        vagas[sorteada] = vagas[--qtd_vagas];
+        vagas[qtd_vagas++] = &nova->esquerda;
+        vagas[qtd_vagas++] = &nova->direita;
+    }
+
+    freeContado(vagas);
+    freeContado(pistas);
+    return hall;
+}
+
+/**
+ * @brief Sorteia passagens extras (atalhos dirigidos) entre cômodos de uma mansão.
+ *
+ * @param num_salas Quantidade de cômodos do grafo (índices válidos 0..num_salas-1).
+ * @param quantidade Quantidade de passagens a sortear.
+ * @param semente Semente do gerador pseudoaleatório.
+ * @return Passagem* Vetor alocado com as passagens (liberar com free).
+ */
+Passagem* gerarPassagensAleatorias(int num_salas, int quantidade, unsigned int semente) {
+    Passagem *passagens = (Passagem*)mallocContado((quantidade > 0 ? quantidade : 1) * sizeof(Passagem));
+    if (passagens == NULL) {
+        perror("Erro ao alocar memoria para as passagens.");
+        exit(EXIT_FAILURE);
+    }
+    unsigned int estado = semente ^ 0xA5A5A5A5u;
+    for (int i = 0; i < quantidade; i++) {
+        passagens[i].origem = proximoAleatorio(&estado) % num_salas;
+        passagens[i].destino = proximoAleatorio(&estado) % num_salas;
+    }
+    return passagens;
+}
+
+/**
+ * @brief Libera recursivamente a memória alocada para o mapa da mansão.
+ */
+void liberarMapa(Sala *sala) {
+    if (sala != NULL && !pertenceAoSnapshot(sala)) { // Um mapa restaurado vive inteiro no snapshot
+        liberarMapa(sala->esquerda);
+        liberarMapa(sala->direita);
+        freeContado(sala);
+    }
+}
+
+// ------------------------------------------
+// 12. FUNÇÕES DO GRAFO DA MANSÃO (CSR)
+// ------------------------------------------
+
+/**
+ * @brief Aloca um grafo sem saídas, com as áreas de trabalho das consultas.
+ *
+ * @param salas Vetor índice -> sala (o grafo passa a ser dono do vetor).
+ * @param num_salas Quantidade de salas.
+ * @return GrafoMansao* O grafo com inicio_saidas/destinos ainda nulos.
+ */
+GrafoMansao* criarGrafoVazio(Sala **salas, int num_salas) {
+    GrafoMansao *grafo = (GrafoMansao*)mallocContado(sizeof(GrafoMansao));
+    if (grafo == NULL) {
+        perror("Erro ao alocar memoria para o grafo.");
+        exit(EXIT_FAILURE);
+    }
+    grafo->num_salas = num_salas;
+    grafo->num_saidas = 0;
+    grafo->salas = salas;
+    grafo->inicio_saidas = NULL;
+    grafo->destinos = NULL;
+    grafo->marca = (int*)callocContado(num_salas > 0 ? num_salas : 1, sizeof(int));
+    grafo->anterior = (int*)mallocContado((num_salas > 0 ? num_salas : 1) * sizeof(int));
+    grafo->fila = (int*)mallocContado((num_salas > 0 ? num_salas : 1) * sizeof(int));
+    grafo->geracao = 0;
+    grafo->vetores_mapeados = 0;
+    if (grafo->marca == NULL || grafo->anterior == NULL || grafo->fila == NULL) {
+        perror("Erro ao alocar memoria para o grafo.");
+        exit(EXIT_FAILURE);
+    }
+    return grafo;
+}
+
+/**
+ * @brief Monta o grafo CSR a partir de um vetor de salas e uma lista de passagens.
+ *
+ * As passagens são distribuídas por origem com uma contagem (counting sort),
+ * em O(salas + passagens). Passagens com índices inválidos são ignoradas.
+ * @param salas Vetor índice -> sala (o grafo passa a ser dono do vetor).
+ * @param num_salas Quantidade de salas.
+ * @param passagens Arestas dirigidas a inserir.
+ * @param num_passagens Quantidade de arestas.
+ * @return GrafoMansao* O grafo alocado.
+ */
+GrafoMansao* construirGrafoDePassagens(Sala **salas, int num_salas, const Passagem *passagens, int num_passagens) {
+    GrafoMansao *grafo = criarGrafoVazio(salas, num_salas);
+    grafo->inicio_saidas = (int*)callocContado(num_salas + 1, sizeof(int));
+    if (grafo->inicio_saidas == NULL) {
+        perror("Erro ao alocar memoria para o grafo.");
+        exit(EXIT_FAILURE);
+    }
+
+    // 1. Conta as saídas de cada sala (deslocado em uma posição)
+    int validas = 0;
+    for (int i = 0; i < num_passagens; i++) {
+        int origem = passagens[i].origem, destino = passagens[i].destino;
+        if (origem >= 0 && origem < num_salas && destino >= 0 && destino < num_salas) {
+            grafo->inicio_saidas[origem + 1]++;
+            validas++;
+        }
+    }
+
+    // 2. Soma de prefixos: início da linha de cada sala
+    for (int v = 0; v < num_salas; v++) {
+        grafo->inicio_saidas[v + 1] += grafo->inicio_saidas[v];
+    }
+
+    // 3. Distribui os destinos (a ordem de declaração é preservada em cada linha)
+    grafo->num_saidas = validas;
+    grafo->destinos = (int*)mallocContado((validas > 0 ? validas : 1) * sizeof(int));
+    int *cursor = (int*)mallocContado((num_salas > 0 ? num_salas : 1) * sizeof(int));
+    if (grafo->destinos == NULL || cursor == NULL) {
+        perror("Erro ao alocar memoria para o grafo.");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(cursor, grafo->inicio_saidas, num_salas * sizeof(int));
+    for (int i = 0; i < num_passagens; i++) {
+        int origem = passagens[i].origem, destino = passagens[i].destino;
+        if (origem >= 0 && origem < num_salas && destino >= 0 && destino < num_salas) {
+            grafo->destinos[cursor[origem]++] = destino;
+        }
+    }
+    freeContado(cursor);
+    return grafo;
+}
+
+/**
+ * @brief Constrói o grafo da mansão a partir do mapa em árvore.
+ *
+ * Indexa as salas em pré-ordem (sala->id), cria as saídas esquerda/direita,
+ * a passagem de volta de cada filho para o pai e as passagens extras informadas.
+ * O percurso é iterativo para suportar mapas muito profundos.
+ * @param raiz O Hall de Entrada.
+ * @param extras Passagens extras, em índices de pré-ordem (pode ser NULL).
+ * @param num_extras Quantidade de passagens extras.
+ * @return GrafoMansao* O grafo alocado (liberar com liberarGrafo).
+ */
+GrafoMansao* construirGrafo(Sala *raiz, const Passagem *extras, int num_extras) {
+    int capacidade = 64, num_salas = 0, topo = 0;
+    Sala **salas = (Sala**)mallocContado(capacidade * sizeof(Sala*));
+    Sala **pilha = (Sala**)mallocContado(capacidade * sizeof(Sala*));
+    if (salas == NULL || pilha == NULL) {
+        perror("Erro ao alocar memoria para o grafo.");
+        exit(EXIT_FAILURE);
+    }
+
+    // 1. Indexação em pré-ordem com pilha explícita
+    if (raiz != NULL) {
+        pilha[topo++] = raiz;
+    }
+    while (topo > 0) {
+        Sala *sala = pilha[--topo];
+        if (num_salas == capacidade || topo + 2 > capacidade) {
+            capacidade *= 2;
+            salas = (Sala**)reallocContado(salas, capacidade * sizeof(Sala*));
+            pilha = (Sala**)reallocContado(pilha, capacidade * sizeof(Sala*));
+            if (salas == NULL || pilha == NULL) {
+                perror("Erro ao alocar memoria para o grafo.");
+                exit(EXIT_FAILURE);
+            }
+        }
+        sala->id = num_salas;
+        salas[num_salas++] = sala;
+        if (sala->direita != NULL) {
+            pilha[topo++] = sala->direita;
+        }
+        if (sala->esquerda != NULL) {
+            pilha[topo++] = sala->esquerda;
+        }
+    }
+    freeContado(pilha);
+
+    // 2. Lista de passagens: ida e volta para cada filho, mais as extras
+    int num_passagens = 0;
+    Passagem *passagens = (Passagem*)mallocContado((2 * (size_t)num_salas + num_extras + 1) * sizeof(Passagem));
+    if (passagens == NULL) {
+        perror("Erro ao alocar memoria para o grafo.");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v < num_salas; v++) {
+        Sala *filhos[2] = { salas[v]->esquerda, salas[v]->direita };
+        for (int k = 0; k < 2; k++) {
+            if (filhos[k] != NULL) {
+                passagens[num_passagens++] = (Passagem){ v, filhos[k]->id };
+                passagens[num_passagens++] = (Passagem){ filhos[k]->id, v };
+            }
+        }
+    }
+    for (int i = 0; i < num_extras; i++) {
+        passagens[num_passagens++] = extras[i];
+    }
+
+    GrafoMansao *grafo = construirGrafoDePassagens(salas, num_salas, passagens, num_passagens);
+    freeContado(passagens);
+    return grafo;
+}
+
+/**
+ * @brief Libera os vetores do grafo (as salas continuam pertencendo ao mapa).
+ */
+void liberarGrafo(GrafoMansao *grafo) {
+    if (grafo != NULL) {
+        freeContado(grafo->salas);
+        if (!grafo->vetores_mapeados) {
+            freeContado(grafo->inicio_saidas);
+            freeContado(grafo->destinos);
+        }
+        freeContado(grafo->marca);
+        freeContado(grafo->anterior);
+        freeContado(grafo->fila);
+        freeContado(grafo);
+    }
+}
+
+/**
+ * @brief Critério de parada da BFS: sala de destino específica.
+ */
+int ehSalaDestino(const GrafoMansao *grafo, int v, const void *contexto) {
+    (void)grafo;
+    return v == *(const int*)contexto;
+}
+
+/**
+ * @brief Critério de parada da BFS: sala com pista ainda não coletada.
+ */
+int temPistaNaoColetada(const GrafoMansao *grafo, int v, const void *contexto) {
+    (void)contexto;
+    const Sala *sala = grafo->salas[v];
+    return sala->pista_estatica[0] != '\0' && sala->pista_coletada == 0;
+}
+
+/**
+ * @brief BFS a partir de origem que para na primeira sala que satisfaz o critério.
+ *
+ * Usa as áreas de trabalho do grafo com marcação por geração, então nenhuma
+ * consulta precisa limpar vetores do tamanho da mansão: o custo é proporcional
+ * apenas às salas efetivamente visitadas.
+ * @return int O índice da sala encontrada (mais próxima), ou -1.
+ */
+int bfsAteCriterio(GrafoMansao *grafo, int origem,
+                   int (*criterio)(const GrafoMansao*, int, const void*), const void *contexto) {
+    if (origem < 0 || origem >= grafo->num_salas) {
+        return -1;
+    }
+
+    // Nova geração; ao dar a volta no contador, as marcas antigas são zeradas
+    if (++grafo->geracao <= 0) {
+        memset(grafo->marca, 0, grafo->num_salas * sizeof(int));
+        grafo->geracao = 1;
+    }
+    int geracao = grafo->geracao;
+    int inicio = 0, fim = 0;
+
+    grafo->marca[origem] = geracao;
+    grafo->anterior[origem] = -1;
+    grafo->fila[fim++] = origem;
+
+    while (inicio < fim) {
+        int v = grafo->fila[inicio++];
+        if (criterio(grafo, v, contexto)) {
+            return v;
+        }
+        for (int k = grafo->inicio_saidas[v]; k < grafo->inicio_saidas[v + 1]; k++) {
+            int w = grafo->destinos[k];
+            if (grafo->marca[w] != geracao) {
+                grafo->marca[w] = geracao;
+                grafo->anterior[w] = v;
+                grafo->fila[fim++] = w;
+            }
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Reconstrói a rota da última BFS (origem -> destino).
+ *
+ * @param rota Vetor de saída com os índices das salas (as max primeiras são gravadas).
+ * @param max Capacidade do vetor rota.
+ * @return int Quantidade de salas da rota completa (incluindo origem e destino).
+ */
+int reconstruirRota(const GrafoMansao *grafo, int destino, int *rota, int max) {
+    int tamanho = 0;
+    for (int v = destino; v != -1; v = grafo->anterior[v]) {
+        tamanho++;
+    }
+    int posicao = tamanho - 1;
+    for (int v = destino; v != -1; v = grafo->anterior[v], posicao--) {
+        if (posicao < max) {
+            rota[posicao] = v;
+        }
+    }
+    return tamanho;
+}
+
+/**
+ * @brief Menor caminho (em número de passagens) entre duas salas.
+ *
+ * @return int Quantidade de salas da rota, ou -1 se o destino é inalcançável.
+ */
+int menorCaminho(GrafoMansao *grafo, int origem, int destino, int *rota, int max) {
+    if (bfsAteCriterio(grafo, origem, ehSalaDestino, &destino) < 0) {
+        return -1;
+    }
+    return reconstruirRota(grafo, destino, rota, max);
+}
+
+/**
+ * @brief Encontra a sala mais próxima com pista ainda não coletada.
+ *
+ * @param tamanho_rota Saída: quantidade de salas da rota (0 se nada encontrado).
+ * @return int O índice da sala encontrada, ou -1 se todas as pistas alcançáveis já foram coletadas.
+ */
+int pistaMaisProxima(GrafoMansao *grafo, int origem, int *rota, int max, int *tamanho_rota) {
+    int encontrada = bfsAteCriterio(grafo, origem, temPistaNaoColetada, NULL);
+    *tamanho_rota = encontrada < 0 ? 0 : reconstruirRota(grafo, encontrada, rota, max);
+    return encontrada;
+}
+
+/**
+ * @brief Trabalho de uma thread na expansão de um nível da BFS paralela.
+ */
+typedef struct {
+    const GrafoMansao *grafo;
+    int *distancia;
+    int *anterior;
+    const int *fronteira;
+    int inicio, fim;     // Faixa da fronteira atribuída à thread
+    int nivel;
+    int *descobertos;    // Salas descobertas pela thread neste nível
+    int qtd_descobertos;
+    int capacidade;
+} TrabalhoBFS;
+
+/**
+ * @brief Expande uma faixa da fronteira; cada sala é reivindicada com CAS em distancia[].
+ */
+void* expandirFaixaBFS(void *argumento) {
+    TrabalhoBFS *trabalho = (TrabalhoBFS*)argumento;
+    const GrafoMansao *grafo = trabalho->grafo;
+    int proximo_nivel = trabalho->nivel + 1;
+
+    for (int i = trabalho->inicio; i < trabalho->fim; i++) {
+        int v = trabalho->fronteira[i];
+        for (int k = grafo->inicio_saidas[v]; k < grafo->inicio_saidas[v + 1]; k++) {
+            int w = grafo->destinos[k];
+            int esperado = -1;
+            if (__atomic_load_n(&trabalho->distancia[w], __ATOMIC_RELAXED) != -1 ||
+                !__atomic_compare_exchange_n(&trabalho->distancia[w], &esperado, proximo_nivel,
+                                             0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                continue; // Já visitada (por esta ou por outra thread)
+            }
+            if (trabalho->anterior != NULL) {
+                trabalho->anterior[w] = v;
+            }
+            if (trabalho->qtd_descobertos == trabalho->capacidade) {
+                trabalho->capacidade = trabalho->capacidade ? 2 * trabalho->capacidade : 1024;
+                trabalho->descobertos = (int*)reallocContado(trabalho->descobertos, trabalho->capacidade * sizeof(int));
+                if (trabalho->descobertos == NULL) {
+                    perror("Erro ao alocar memoria para a BFS.");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            trabalho->descobertos[trabalho->qtd_descobertos++] = w;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief BFS completa por níveis, com a expansão de fronteiras grandes dividida entre threads.
+ *
+ * Fronteiras menores que LIMIAR_BFS_PARALELO são expandidas na própria thread,
+ * já que o custo de criar threads superaria o ganho.
+ * @param distancia Saída: distância (em passagens) de cada sala, ou -1 se inalcançável.
+ * @param anterior Saída opcional (pode ser NULL): predecessor de cada sala na árvore da BFS.
+ * @param num_threads Quantidade de threads (0 = todos os núcleos disponíveis).
+ * @return int Quantidade de salas alcançadas a partir da origem.
+ */
+int bfsMansao(const GrafoMansao *grafo, int origem, int *distancia, int *anterior, int num_threads) {
+    int n = grafo->num_salas;
+    for (int v = 0; v < n; v++) {
+        distancia[v] = -1;
+        if (anterior != NULL) {
+            anterior[v] = -1;
+        }
+    }
+    if (origem < 0 || origem >= n) {
+        return 0;
+    }
+    if (num_threads <= 0) {
+        num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+    if (num_threads > MAX_THREADS_BFS) {
+        num_threads = MAX_THREADS_BFS;
+    }
+
+    int *fronteira = (int*)mallocContado(n * sizeof(int));
+    int *proxima = (int*)mallocContado(n * sizeof(int));
+    if (fronteira == NULL || proxima == NULL) {
+        perror("Erro ao alocar memoria para a BFS.");
+        exit(EXIT_FAILURE);
+    }
+    TrabalhoBFS trabalhos[MAX_THREADS_BFS];
+    pthread_t threads[MAX_THREADS_BFS];
+    memset(trabalhos, 0, sizeof(trabalhos));
+
+    distancia[origem] = 0;
+    fronteira[0] = origem;
+    int tamanho = 1, alcancadas = 1, nivel = 0;
+
+    while (tamanho > 0) {
+        int partes = (num_threads > 1 && tamanho >= LIMIAR_BFS_PARALELO) ? num_threads : 1;
+        for (int p = 0; p < partes; p++) {
+            trabalhos[p].grafo = grafo;
+            trabalhos[p].distancia = distancia;
+            trabalhos[p].anterior = anterior;
+            trabalhos[p].fronteira = fronteira;
+            trabalhos[p].inicio = (int)((long long)tamanho * p / partes);
+            trabalhos[p].fim = (int)((long long)tamanho * (p + 1) / partes);
+            trabalhos[p].nivel = nivel;
+            trabalhos[p].qtd_descobertos = 0;
+        }
+
+        // A thread principal processa a primeira faixa; as demais vão para threads auxiliares
+        int criadas[MAX_THREADS_BFS] = {0};
+        for (int p = 1; p < partes; p++) {
+            criadas[p] = pthread_create(&threads[p], NULL, expandirFaixaBFS, &trabalhos[p]) == 0;
+            if (!criadas[p]) {
+                expandirFaixaBFS(&trabalhos[p]);
+            }
+        }
+        expandirFaixaBFS(&trabalhos[0]);
+        for (int p = 1; p < partes; p++) {
+            if (criadas[p]) {
+                pthread_join(threads[p], NULL);
+            }
+        }
+
+        // Concatena as descobertas de cada thread na próxima fronteira
+        int tamanho_proxima = 0;
+        for (int p = 0; p < partes; p++) {
+            memcpy(proxima + tamanho_proxima, trabalhos[p].descobertos, trabalhos[p].qtd_descobertos * sizeof(int));
+            tamanho_proxima += trabalhos[p].qtd_descobertos;
+        }
+        int *troca = fronteira;
+        fronteira = proxima;
+        proxima = troca;
+        tamanho = tamanho_proxima;
+        alcancadas += tamanho;
+        nivel++;
+    }
+
+    for (int p = 0; p < MAX_THREADS_BFS; p++) {
+        freeContado(trabalhos[p].descobertos);
+    }
+    freeContado(fronteira);
+    freeContado(proxima);
+    return alcancadas;
+}
+
+/**
+ * @brief Posição (a partir de 1) da passagem origem -> destino entre as saídas da origem.
+ *
+ * @return int A posição usada pelo comando [V], ou 0 se a passagem não existe.
+ */
+int posicaoDaPassagem(const GrafoMansao *grafo, int origem, int destino) {
+    for (int k = grafo->inicio_saidas[origem]; k < grafo->inicio_saidas[origem + 1]; k++) {
+        if (grafo->destinos[k] == destino) {
+            return k - grafo->inicio_saidas[origem] + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Exibe a rota da sala atual até a pista não coletada mais próxima.
+ *
+ * Cada passo vem com o comando que o percorre: [E]/[D] quando é um filho da
+ * sala, ou [V] com a posição da passagem (volta ao cômodo anterior ou atalho).
+ */
+void exibirRotaPistaMaisProxima(Sala *atual) {
+    if (grafo_mansao == NULL || atual->id < 0) {
+        printf("[INFO] O grafo da mansao nao foi construido.\n");
+        return;
+    }
+
+    static int rota[MAX_ROTA];
+    int tamanho = 0;
+    double inicio = tempoAtual();
+    int encontrada = pistaMaisProxima(grafo_mansao, atual->id, rota, MAX_ROTA, &tamanho);
+    double micros = (tempoAtual() - inicio) * 1e6;
+
+    if (encontrada < 0) {
+        printf("[ROTA] Nenhuma pista pendente alcancavel a partir daqui (%.1f us).\n", micros);
+        return;
+    }
+    printf("[ROTA] Pista mais proxima em '%s', a %d passagem(ns) (%.1f us):\n",
+           grafo_mansao->salas[encontrada]->nome, tamanho - 1, micros);
+    int exibidas = tamanho < MAX_ROTA ? tamanho : MAX_ROTA;
+    for (int i = 0; i < exibidas; i++) {
+        const Sala *sala = grafo_mansao->salas[rota[i]];
+        if (i == 0) {
+            printf("  %s\n", sala->nome);
+            continue;
+        }
+        const Sala *anterior = grafo_mansao->salas[rota[i - 1]];
+        if (anterior->esquerda == sala) {
+            printf("  -> %s [E]\n", sala->nome);
+        } else if (anterior->direita == sala) {
+            printf("  -> %s [D]\n", sala->nome);
+        } else {
+            printf("  -> %s [V %d]\n", sala->nome, posicaoDaPassagem(grafo_mansao, rota[i - 1], rota[i]));
+        }
+    }
+    if (exibidas < tamanho) {
+        printf("  ... (%d salas omitidas)\n", tamanho - exibidas);
+    }
+}
+
+/**
+ * @brief Lista as passagens do grafo que saem da sala e segue a escolhida.
+ *
+ * Torna andáveis as arestas que as consultas de rota usam além de esquerda e
+ * direita: a volta para o cômodo anterior e os atalhos da mansão.
+ * @return Sala* A sala de destino, ou a própria sala se a escolha for inválida.
+ */
+Sala* seguirPassagem(Sala *atual) {
+    if (grafo_mansao == NULL || atual->id < 0 ||
+        grafo_mansao->inicio_saidas[atual->id] == grafo_mansao->inicio_saidas[atual->id + 1]) {
+        printf("[ALERTA] Nao ha passagens a partir deste comodo.\n");
+        return atual;
+    }
+    int primeira = grafo_mansao->inicio_saidas[atual->id];
+    int total = grafo_mansao->inicio_saidas[atual->id + 1] - primeira;
+    for (int k = 0; k < total; k++) {
+        printf("  [%d] %s\n", k + 1, grafo_mansao->salas[grafo_mansao->destinos[primeira + k]]->nome);
+    }
+    printf("Passagem (1-%d): ", total);
+    int escolha;
+    if (fscanf(entrada_jogo, "%d", &escolha) != 1) {
+        int c;
+        while ((c = fgetc(entrada_jogo)) != '\n' && c != EOF);
+        escolha = 0;
+    }
+    if (escolha < 1 || escolha > total) {
+        printf("[ALERTA] Passagem invalida.\n");
+        return atual;
+    }
+    return grafo_mansao->salas[grafo_mansao->destinos[primeira + escolha - 1]];
+}
+
+/**
+ * @brief Exibe o alcance da mansão a partir da sala atual (BFS completa em paralelo).
+ */
+void exibirAlcanceMansao(Sala *atual) {
+    if (grafo_mansao == NULL || atual->id < 0) {
+        printf("[INFO] O grafo da mansao nao foi construido.\n");
+        return;
+    }
+
+    int *distancia = (int*)mallocContado(grafo_mansao->num_salas * sizeof(int));
+    if (distancia == NULL) {
+        perror("Erro ao alocar memoria para a BFS.");
+        exit(EXIT_FAILURE);
+    }
+    double inicio = tempoAtual();
+    int alcancadas = bfsMansao(grafo_mansao, atual->id, distancia, NULL, 0);
+    double ms = (tempoAtual() - inicio) * 1e3;
+
+    int mais_distante = atual->id;
+    for (int v = 0; v < grafo_mansao->num_salas; v++) {
+        if (distancia[v] > distancia[mais_distante]) {
+            mais_distante = v;
+        }
+    }
+    printf("[MAPA] %d de %d comodos alcancaveis (%d passagens no total), BFS em %.3f ms.\n",
+           alcancadas, grafo_mansao->num_salas, grafo_mansao->num_saidas, ms);
+    printf("[MAPA] Comodo mais distante: '%s' (%d passagens).\n",
+           grafo_mansao->salas[mais_distante]->nome, distancia[mais_distante]);
+    freeContado(distancia);
+}
+
+// ------------------------------------------
+// 13. FUNÇÕES DE PERSISTÊNCIA (SNAPSHOT)
+// ------------------------------------------
+
+/**
+ * @brief Arredonda um deslocamento para múltiplo de 16 bytes (alinhamento dos registros).
+ */
+uint64_t alinharDeslocamento(uint64_t deslocamento) {
+    return (deslocamento + 15) & ~(uint64_t)15;
+}
+
+/**
+ * @brief Grava a investigação (mapa, pistas coletadas, suspeitos e grafo) em um snapshot binário.
+ *
+ * Todo o arquivo é montado em um único buffer e enviado com uma única chamada
+ * write (repetida apenas se o sistema aceitar menos bytes), em um arquivo
+ * temporário que depois substitui o destino com rename.
+ * @param arquivo Caminho do snapshot.
+ * @param atual Sala onde o jogador está (retomada a partir dela).
+ * @return int 1 se sucesso, 0 em caso de erro.
+ */
+int salvarInvestigacao(const char *arquivo, const Sala *atual) {
+    if (grafo_mansao == NULL) {
+        return 0;
+    }
+
+    // 1. Enumera as pistas (BST) e os nós da Hash em ordem de largura
+    int num_pistas = 0, cap_pistas = 0;
+    PistaNode **pistas = NULL;
+    if (raiz_pistas != NULL) {
+        pistas = (PistaNode**)garantirCapacidade(pistas, &cap_pistas, 1, sizeof(PistaNode*));
+        pistas[num_pistas++] = raiz_pistas;
+    }
+    for (int i = 0; i < num_pistas; i++) {
+        PistaNode *filhos[2] = { pistas[i]->esquerda, pistas[i]->direita };
+        for (int k = 0; k < 2; k++) {
+            if (filhos[k] != NULL) {
+                pistas = (PistaNode**)garantirCapacidade(pistas, &cap_pistas, num_pistas + 1, sizeof(PistaNode*));
+                pistas[num_pistas++] = filhos[k];
+            }
+        }
+    }
+    int num_hash = 0;
+    for (int b = 0; b < TAMANHO_HASH; b++) {
+        for (HashNode *no = tabela_suspeitos.tabela[b]; no != NULL; no = no->proximo) {
+            num_hash++;
+        }
+    }
+
+    // 2. Calcula o layout do arquivo
+    CabecalhoSnapshot cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magica, "DQSNAP1", 8);
+    cab.versao = VERSAO_SNAPSHOT;
+    cab.tam_sala = sizeof(Sala);
+    cab.tam_pista = sizeof(PistaNode);
+    cab.tam_hash = sizeof(HashNode);
+    cab.num_salas = grafo_mansao->num_salas;
+    cab.num_pistas = num_pistas;
+    cab.num_hash = num_hash;
+    cab.num_saidas = grafo_mansao->num_saidas;
+    cab.sala_atual = atual != NULL ? atual->id : 0;
+    cab.desloc_salas = alinharDeslocamento(sizeof(cab));
+    cab.desloc_pistas = alinharDeslocamento(cab.desloc_salas + (uint64_t)cab.num_salas * sizeof(Sala));
+    cab.desloc_hash = alinharDeslocamento(cab.desloc_pistas + (uint64_t)num_pistas * sizeof(PistaNode));
+    cab.desloc_inicio_saidas = alinharDeslocamento(cab.desloc_hash + (uint64_t)num_hash * sizeof(HashNode));
+    cab.desloc_destinos = alinharDeslocamento(cab.desloc_inicio_saidas + ((uint64_t)cab.num_salas + 1) * sizeof(int));
+    cab.tamanho_total = alinharDeslocamento(cab.desloc_destinos + (uint64_t)cab.num_saidas * sizeof(int));
+    cab.raiz_pistas = num_pistas > 0 ? cab.desloc_pistas : 0;
+
+    char *buffer = (char*)callocContado(1, cab.tamanho_total);
+    if (buffer == NULL) {
+        freeContado(pistas);
+        return 0;
+    }
+
+    // 3. Salas: ponteiros viram deslocamentos calculados pelo índice no grafo
+    for (int v = 0; v < cab.num_salas; v++) {
+        const Sala *sala = grafo_mansao->salas[v];
+        Sala registro = *sala;
+        registro.esquerda = (Sala*)(uintptr_t)(sala->esquerda ? cab.desloc_salas + (uint64_t)sala->esquerda->id * sizeof(Sala) : 0);
+        registro.direita = (Sala*)(uintptr_t)(sala->direita ? cab.desloc_salas + (uint64_t)sala->direita->id * sizeof(Sala) : 0);
+        memcpy(buffer + cab.desloc_salas + (uint64_t)v * sizeof(Sala), &registro, sizeof(Sala));
+    }
+
+    // 4. Pistas: em ordem de largura, os filhos recebem os próximos índices livres
+    int proximo = 1;
+    for (int i = 0; i < num_pistas; i++) {
+        PistaNode registro = *pistas[i];
+        registro.esquerda = (PistaNode*)(uintptr_t)(pistas[i]->esquerda ? cab.desloc_pistas + (uint64_t)proximo++ * sizeof(PistaNode) : 0);
+        registro.direita = (PistaNode*)(uintptr_t)(pistas[i]->direita ? cab.desloc_pistas + (uint64_t)proximo++ * sizeof(PistaNode) : 0);
+        memcpy(buffer + cab.desloc_pistas + (uint64_t)i * sizeof(PistaNode), &registro, sizeof(PistaNode));
+    }
+    freeContado(pistas);
+
+    // 5. Hash: cada lista encadeada vira uma sequência contígua de registros
+    int indice = 0;
+    for (int b = 0; b < TAMANHO_HASH; b++) {
+        for (HashNode *no = tabela_suspeitos.tabela[b]; no != NULL; no = no->proximo, indice++) {
+            uint64_t deslocamento = cab.desloc_hash + (uint64_t)indice * sizeof(HashNode);
+            if (no == tabela_suspeitos.tabela[b]) {
+                cab.baldes[b] = deslocamento;
+            }
+            HashNode registro = *no;
+            registro.proximo = (HashNode*)(uintptr_t)(no->proximo ? deslocamento + sizeof(HashNode) : 0);
+            memcpy(buffer + deslocamento, &registro, sizeof(HashNode));
+        }
+    }
+
+    // 6. Grafo CSR (já baseado em índices) e cabeçalho
+    memcpy(buffer + cab.desloc_inicio_saidas, grafo_mansao->inicio_saidas, ((size_t)cab.num_salas + 1) * sizeof(int));
+    memcpy(buffer + cab.desloc_destinos, grafo_mansao->destinos, (size_t)cab.num_saidas * sizeof(int));
+    memcpy(buffer, &cab, sizeof(cab));
+
+    // 7. Escrita única em arquivo temporário + rename (o snapshot anterior nunca fica pela metade)
+    char temporario[1024];
+    snprintf(temporario, sizeof(temporario), "%s.tmp", arquivo);
+    int fd = open(temporario, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    int sucesso = fd >= 0;
+    size_t escritos = 0;
+    while (sucesso && escritos < cab.tamanho_total) {
+        ssize_t n = write(fd, buffer + escritos, cab.tamanho_total - escritos);
+        sucesso = n > 0;
+        escritos += sucesso ? (size_t)n : 0;
+    }
+    if (fd >= 0) {
+        sucesso = sucesso && fsync(fd) == 0;
+        sucesso = (close(fd) == 0) && sucesso;
+    }
+    sucesso = sucesso && rename(temporario, arquivo) == 0;
+    if (!sucesso) {
+        unlink(temporario);
+    }
+    freeContado(buffer);
+    return sucesso;
+}
+
+/**
+ * @brief Converte um deslocamento gravado no snapshot em ponteiro para a região mapeada.
+ *
+ * O deslocamento precisa apontar para o início de um dos 'quantidade' registros
+ * de 'tamanho' bytes da seção que começa em 'inicio'.
+ * @param valido Saída: zerado se o deslocamento não for de um registro da seção.
+ */
+void* relocarDeslocamento(void *gravado, uint64_t inicio, int quantidade, size_t tamanho, int *valido) {
+    uint64_t deslocamento = (uint64_t)(uintptr_t)gravado;
+    if (deslocamento == 0) {
+        return NULL;
+    }
+    if (deslocamento < inicio || (deslocamento - inicio) % tamanho != 0 ||
+        (deslocamento - inicio) / tamanho >= (uint64_t)quantidade) {
+        *valido = 0;
+        return NULL;
+    }
+    return snapshot_carregado.base + deslocamento;
+}
+
+/**
+ * @brief Confere se uma seção de 'quantidade' itens de 'tamanho' bytes começa
+ * alinhada depois de 'minimo' e termina dentro de 'limite'.
+ *
+ * @return uint64_t Fim da seção, ou 0 se ela for inválida.
+ */
+uint64_t validarSecao(uint64_t deslocamento, int64_t quantidade, size_t tamanho, uint64_t minimo, uint64_t limite) {
+    if (quantidade < 0 || deslocamento < minimo || deslocamento > limite || deslocamento % 16 != 0 ||
+        (uint64_t)quantidade > (limite - deslocamento) / tamanho) {
+        return 0;
+    }
+    return deslocamento + (uint64_t)quantidade * tamanho;
+}
+
+/**
+ * @brief Confere se um texto de tamanho fixo vindo do arquivo termina dentro do campo.
+ */
+int textoTerminado(const char *texto, size_t tamanho) {
+    return memchr(texto, '\0', tamanho) != NULL;
+}
+
+/**
+ * @brief Restaura uma investigação gravada, mapeando o snapshot com mmap.
+ *
+ * O arquivo é mapeado de forma privada (cópia na escrita) e usado no lugar:
+ * não há leitura campo a campo nem alocação por nó. A única passagem sobre os
+ * registros soma a base do mapeamento aos deslocamentos gravados nos campos de
+ * ponteiro. Define raiz_pistas, tabela_suspeitos e grafo_mansao.
+ *
+ * Nada no arquivo é confiável: cada seção precisa caber, em ordem e alinhada, em
+ * tamanho_total; cada ponteiro precisa cair no início de um registro da sua
+ * seção (e, na BST e nas listas da hash, depois do próprio nó, o que impede
+ * ciclos); os textos precisam terminar no campo; e o CSR precisa ser coerente.
+ * @param arquivo Caminho do snapshot.
+ * @param sala_atual Saída: sala onde o jogador havia parado.
+ * @return Sala* O Hall de Entrada restaurado, ou NULL se o arquivo for inválido.
+ */
+Sala* carregarInvestigacao(const char *arquivo, Sala **sala_atual) {
+    int fd = open(arquivo, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(CabecalhoSnapshot)) {
+        close(fd);
+        return NULL;
+    }
+    char *base = (char*)mmap(NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+
+    // 1. Valida o cabeçalho (inclusive o layout das structs desta compilação) e as seções
+    CabecalhoSnapshot *cab = (CabecalhoSnapshot*)base;
+    uint64_t limite = cab->tamanho_total;
+    int valido = memcmp(cab->magica, "DQSNAP1", 8) == 0 && cab->versao == VERSAO_SNAPSHOT &&
+                 cab->tam_sala == sizeof(Sala) && cab->tam_pista == sizeof(PistaNode) &&
+                 cab->tam_hash == sizeof(HashNode) && limite <= (uint64_t)info.st_size &&
+                 cab->num_salas > 0 && cab->sala_atual >= 0 && cab->sala_atual < cab->num_salas;
+    uint64_t fim = sizeof(CabecalhoSnapshot);
+    if (valido) {
+        fim = validarSecao(cab->desloc_salas, cab->num_salas, sizeof(Sala), fim, limite);
+    }
+    if (fim != 0 && valido) {
+        fim = validarSecao(cab->desloc_pistas, cab->num_pistas, sizeof(PistaNode), fim, limite);
+    }
+    if (fim != 0 && valido) {
+        fim = validarSecao(cab->desloc_hash, cab->num_hash, sizeof(HashNode), fim, limite);
+    }
+    if (fim != 0 && valido) {
+        fim = validarSecao(cab->desloc_inicio_saidas, (int64_t)cab->num_salas + 1, sizeof(int), fim, limite);
+    }
+    if (fim != 0 && valido) {
+        fim = validarSecao(cab->desloc_destinos, cab->num_saidas, sizeof(int), fim, limite);
+    }
+    valido = valido && fim != 0;
+
+    // 2. Grafo CSR: começa em 0, não decresce, termina em num_saidas e só aponta para salas existentes
+    if (valido) {
+        const int *inicio_saidas = (const int*)(base + cab->desloc_inicio_saidas);
+        const int *destinos = (const int*)(base + cab->desloc_destinos);
+        valido = inicio_saidas[0] == 0 && inicio_saidas[cab->num_salas] == cab->num_saidas;
+        for (int v = 0; valido && v < cab->num_salas; v++) {
+            valido = inicio_saidas[v] <= inicio_saidas[v + 1];
+        }
+        for (int i = 0; valido && i < cab->num_saidas; i++) {
+            valido = destinos[i] >= 0 && destinos[i] < cab->num_salas;
+        }
+    }
+    if (!valido) {
+        munmap(base, info.st_size);
+        return NULL;
+    }
+    snapshot_carregado.base = base;
+    snapshot_carregado.tamanho = info.st_size;
+
+    // 3. Relocação: deslocamento -> ponteiro, em passagens lineares sobre cada vetor.
+    //    Filhos só apontam para a frente e cada sala é filha no máximo uma vez: o mapa
+    //    continua uma árvore e nenhum percurso (nem o do resolvedor) anda em círculos
+    Sala *salas = (Sala*)(base + cab->desloc_salas);
+    unsigned char *ja_filha = (unsigned char*)callocContado(cab->num_salas > 0 ? cab->num_salas : 1, 1);
+    valido = ja_filha != NULL;
+    for (int v = 0; valido && v < cab->num_salas; v++) {
+        valido = salas[v].id == v && textoTerminado(salas[v].nome, MAX_NOME) &&
+                 textoTerminado(salas[v].pista_estatica, MAX_PISTA);
+        salas[v].esquerda = (Sala*)relocarDeslocamento(salas[v].esquerda, cab->desloc_salas, cab->num_salas,
+                                                       sizeof(Sala), &valido);
+        salas[v].direita = (Sala*)relocarDeslocamento(salas[v].direita, cab->desloc_salas, cab->num_salas,
+                                                      sizeof(Sala), &valido);
+        Sala *filhos[2] = { salas[v].esquerda, salas[v].direita };
+        for (int f = 0; valido && f < 2; f++) {
+            if (filhos[f] == NULL) {
+                continue;
+            }
+            valido = filhos[f] > &salas[v] && !ja_filha[filhos[f] - salas];
+            ja_filha[filhos[f] - salas] = 1;
+        }
+    }
+    freeContado(ja_filha);
+    PistaNode *pistas = (PistaNode*)(base + cab->desloc_pistas);
+    for (int i = 0; valido && i < cab->num_pistas; i++) {
+        valido = textoTerminado(pistas[i].pista, MAX_PISTA);
+        pistas[i].esquerda = (PistaNode*)relocarDeslocamento(pistas[i].esquerda, cab->desloc_pistas, cab->num_pistas,
+                                                             sizeof(PistaNode), &valido);
+        pistas[i].direita = (PistaNode*)relocarDeslocamento(pistas[i].direita, cab->desloc_pistas, cab->num_pistas,
+                                                            sizeof(PistaNode), &valido);
+        if ((pistas[i].esquerda != NULL && pistas[i].esquerda <= &pistas[i]) ||
+            (pistas[i].direita != NULL && pistas[i].direita <= &pistas[i])) {
+            valido = 0;
+        }
+    }
+    HashNode *nos_hash = (HashNode*)(base + cab->desloc_hash);
+    for (int i = 0; valido && i < cab->num_hash; i++) {
+        valido = textoTerminado(nos_hash[i].pista, MAX_PISTA) && textoTerminado(nos_hash[i].suspeito, MAX_NOME);
+        nos_hash[i].proximo = (HashNode*)relocarDeslocamento(nos_hash[i].proximo, cab->desloc_hash, cab->num_hash,
+                                                             sizeof(HashNode), &valido);
+        if (nos_hash[i].proximo != NULL && nos_hash[i].proximo <= &nos_hash[i]) {
+            valido = 0;
+        }
+    }
+    PistaNode *raiz = (PistaNode*)relocarDeslocamento((void*)(uintptr_t)cab->raiz_pistas, cab->desloc_pistas,
+                                                      cab->num_pistas, sizeof(PistaNode), &valido);
+    HashNode *baldes[TAMANHO_HASH];
+    for (int b = 0; b < TAMANHO_HASH; b++) {
+        baldes[b] = (HashNode*)relocarDeslocamento((void*)(uintptr_t)cab->baldes[b], cab->desloc_hash,
+                                                   cab->num_hash, sizeof(HashNode), &valido);
+    }
+    if (!valido) {
+        munmap(base, info.st_size);
+        snapshot_carregado.base = NULL;
+        snapshot_carregado.tamanho = 0;
+        return NULL;
+    }
+    raiz_pistas = raiz;
+    memcpy(tabela_suspeitos.tabela, baldes, sizeof(baldes));
+
+    // 4. Grafo: os vetores CSR são usados direto da região mapeada
+    Sala **indice_salas = (Sala**)mallocContado(cab->num_salas * sizeof(Sala*));
+    if (indice_salas == NULL) {
+        perror("Erro ao alocar memoria para o grafo.");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v < cab->num_salas; v++) {
+        indice_salas[v] = &salas[v];
+    }
+    grafo_mansao = criarGrafoVazio(indice_salas, cab->num_salas);
+    grafo_mansao->num_saidas = cab->num_saidas;
+    grafo_mansao->inicio_saidas = (int*)(base + cab->desloc_inicio_saidas);
+    grafo_mansao->destinos = (int*)(base + cab->desloc_destinos);
+    grafo_mansao->vetores_mapeados = 1;
+
+    *sala_atual = &salas[cab->sala_atual];
+    return &salas[0];
+}
+
+/**
+ * @brief Desfaz o mapeamento do snapshot (chamar depois de liberar mapa, pistas e hash).
+ */
+void descarregarSnapshot() {
+    if (snapshot_carregado.base != NULL) {
+        munmap(snapshot_carregado.base, snapshot_carregado.tamanho);
+        snapshot_carregado.base = NULL;
+        snapshot_carregado.tamanho = 0;
+    }
+}
+
+/**
+ * @brief Reindexa as pistas de uma BST restaurada no índice de busca (percurso em ordem).
+ */
+void indexarPistasRestauradas(PistaNode *raiz) {
+    if (raiz != NULL) {
+        indexarPistasRestauradas(raiz->esquerda);
+        adicionarAoIndice(&indice_pistas, raiz->pista);
+        indexarPistasRestauradas(raiz->direita);
+    }
+}
+
+// ------------------------------------------
+// 14. FUNÇÃO DE JULGAMENTO FINAL
+// ------------------------------------------
+
+/**
+ * @brief Conta recursivamente quantas pistas na BST apontam para o suspeito acusado.
+ *
+ * @param no O nó atual da BST (pista coletada).
+ * @param acusado O nome do suspeito acusado.
+ * @return int A contagem de pistas que sustentam a acusação.
+ */
+int contarPistasParaSuspeito(PistaNode *no, const char *acusado) {
+    if (no == NULL) {
+        return 0;
     }
     
     int count = 0;
@@ -310,68 +2160,535 @@ int contarPistasParaSuspeito(PistaNode *no, const char *acusado) {
     if (strcmp(suspeito_apontado, acusado) == 0) {
         count = 1;
     }
-    
-    // 2. Soma as contagens das subárvores
-    count += contarPistasParaSuspeito(no->esquerda, acusado);
-    count += contarPistasParaSuspeito(no->direita, acusado);
-    
-    return count;
+    
+    // 2. Soma as contagens das subárvores
+    count += contarPistasParaSuspeito(no->esquerda, acusado);
+    count += contarPistasParaSuspeito(no->direita, acusado);
+    
+    return count;
+}
+
+/**
+ * @brief Conduz a fase de julgamento final.
+ *
+ * Requisito: Verificar se pelo menos duas pistas apontam para o suspeito acusado.
+ */
+void verificarSuspeitoFinal() {
+    char acusado[MAX_NOME];
+    
+    printf("\n\n********************************************************\n");
+    printf("            FASE DE JULGAMENTO FINAL\n");
+    printf("********************************************************\n");
+    
+    printf("Voce analisou as pistas coletadas:\n");
+    exibirPistas(raiz_pistas);
+    printf("--------------------------------------------------------\n");
+    
+    printf("Insira o nome do SUSPEITO que voce acusa (Ex: 'Camila', 'Carlos', 'Cris'): ");
+    // Lê o nome do suspeito acusado
+    if (fscanf(entrada_jogo, " %49s", acusado) != 1) {
+        printf("[ERRO] Entrada invalida. Julgamento encerrado.\n");
+        return;
+    }
+
+    printf("\nACUSADO: %s\n", acusado);
+    printf("ANALISANDO as pistas coletadas...\n");
+
+    // Requisito: Contar as pistas que apontam para o acusado
+    int total_pistas = contarPistasParaSuspeito(raiz_pistas, acusado);
+
+    printf("Pistas que apontam para %s: %d\n", acusado, total_pistas);
+
+    // Requisito: Verificar se, pelo menos, duas pistas sustentam a acusação
+    if (total_pistas >= PISTAS_MINIMAS) {
+        printf("\n=> [VEREDITO: CULPADO!] A acusacao e sustentada por %d pistas.\n", total_pistas);
+        printf("A justica foi feita! Parabens, Detetive.\n");
+    } else {
+        printf("\n=> [VEREDITO: INSUFICIENTE!] Apenas %d pistas apoiam a acusacao.\n", total_pistas);
+        printf("Nao ha provas suficientes. O culpado escapou! Continue a investigar.\n");
+    }
+    printf("********************************************************\n");
+}
+
+// ------------------------------------------
+// 15. FUNÇÕES DE RAMIFICAÇÃO (Versões da Investigação)
+// ------------------------------------------
+
+/**
+ * @brief Registra a coleta de uma pista na sala (para poder desfazê-la).
+ */
+void registrarColeta(HistoricoInvestigacao *hist, Sala *sala, int id_indice) {
+    hist->coletas = (RegistroColeta*)garantirCapacidade(hist->coletas, &hist->cap_coletas,
+                                                       hist->qtd_coletas + 1, sizeof(RegistroColeta));
+    hist->coletas[hist->qtd_coletas++] = (RegistroColeta){ sala, id_indice };
+}
+
+/**
+ * @brief Abre um ponto de ramificação com a versão atual da investigação.
+ *
+ * Custo O(1): a BST persistente permite guardar só a raiz da versão.
+ */
+void ramificarInvestigacao(HistoricoInvestigacao *hist, Sala *atual) {
+    hist->pontos = (PontoRamificacao*)garantirCapacidade(hist->pontos, &hist->cap_pontos,
+                                                        hist->qtd_pontos + 1, sizeof(PontoRamificacao));
+    hist->pontos[hist->qtd_pontos++] = (PontoRamificacao){ raiz_pistas, atual, hist->qtd_coletas };
+}
+
+/**
+ * @brief Volta ao último ponto de ramificação, descartando o que foi coletado depois dele.
+ *
+ * A BST volta à raiz guardada; as salas visitadas depois do ponto têm a pista
+ * liberada de novo e as pistas correspondentes saem dos resultados de busca.
+ * @return Sala* A sala do ponto de ramificação, ou NULL se não há ramificação aberta.
+ */
+Sala* desfazerRamificacao(HistoricoInvestigacao *hist) {
+    if (hist->qtd_pontos == 0) {
+        return NULL;
+    }
+    PontoRamificacao ponto = hist->pontos[--hist->qtd_pontos];
+    while (hist->qtd_coletas > ponto.qtd_coletas) {
+        RegistroColeta coleta = hist->coletas[--hist->qtd_coletas];
+        coleta.sala->pista_coletada = 0;
+        desativarPistaNoIndice(&indice_pistas, coleta.id_indice);
+    }
+    raiz_pistas = ponto.raiz;
+    return ponto.sala;
+}
+
+/**
+ * @brief Compara, por suspeito, as pistas no último ponto de ramificação e na versão atual.
+ *
+ * Permite avaliar o caminho explorado ("e se?") antes de decidir desfazê-lo.
+ */
+void compararRamificacao(const HistoricoInvestigacao *hist) {
+    if (hist->qtd_pontos == 0) {
+        printf("[RAMO] Nenhuma ramificacao aberta. Use [R] para criar uma.\n");
+        return;
+    }
+    const PontoRamificacao *ponto = &hist->pontos[hist->qtd_pontos - 1];
+    printf("[RAMO] Desde '%s': %d coleta(s) neste ramo.\n", ponto->sala->nome,
+           hist->qtd_coletas - ponto->qtd_coletas);
+    printf("  %-20s %8s %8s\n", "SUSPEITO", "ANTES", "AGORA");
+
+    // Cada suspeito distinto da Hash é exibido uma vez
+    for (int b = 0; b < TAMANHO_HASH; b++) {
+        for (HashNode *no = tabela_suspeitos.tabela[b]; no != NULL; no = no->proximo) {
+            int repetido = 0;
+            for (int c = 0; c <= b && !repetido; c++) {
+                for (HashNode *outro = tabela_suspeitos.tabela[c]; outro != NULL && !(c == b && outro == no); outro = outro->proximo) {
+                    if (strcmp(outro->suspeito, no->suspeito) == 0) {
+                        repetido = 1;
+                        break;
+                    }
+                }
+            }
+            if (!repetido) {
+                int antes = contarPistasParaSuspeito(ponto->raiz, no->suspeito);
+                int agora = contarPistasParaSuspeito(raiz_pistas, no->suspeito);
+                printf("  %-20s %8d %8d%s\n", no->suspeito, antes, agora,
+                       agora >= PISTAS_MINIMAS ? "  <- acusacao sustentavel" : "");
+            }
+        }
+    }
+}
+
+/**
+ * @brief Libera o histórico de coletas e ramificações.
+ */
+void liberarHistorico(HistoricoInvestigacao *hist) {
+    freeContado(hist->coletas);
+    freeContado(hist->pontos);
+    memset(hist, 0, sizeof(HistoricoInvestigacao));
+}
+
+// ------------------------------------------
+// 16. RESOLVEDOR EXAUSTIVO (Todos os Caminhos em Paralelo)
+// ------------------------------------------
+
+/**
+ * @brief Empilha uma tarefa no fim da fila (usado pela dona da fila).
+ */
+void empilharTarefa(FilaTrabalho *fila, TarefaResolvedor tarefa) {
+    pthread_mutex_lock(&fila->trava);
+    if (fila->qtd == fila->capacidade) {
+        int nova = fila->capacidade ? 2 * fila->capacidade : 64;
+        TarefaResolvedor *vetor = (TarefaResolvedor*)mallocContado(nova * sizeof(TarefaResolvedor));
+        if (vetor == NULL) {
+            perror("Erro ao alocar memoria para o resolvedor.");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < fila->qtd; i++) {
+            vetor[i] = fila->tarefas[(fila->inicio + i) % fila->capacidade];
+        }
+        freeContado(fila->tarefas);
+        fila->tarefas = vetor;
+        fila->inicio = 0;
+        fila->capacidade = nova;
+    }
+    fila->tarefas[(fila->inicio + fila->qtd) % fila->capacidade] = tarefa;
+    __atomic_store_n(&fila->qtd, fila->qtd + 1, __ATOMIC_RELAXED); // Lido sem trava em executarTarefaResolvedor
+    pthread_mutex_unlock(&fila->trava);
+}
+
+/**
+ * @brief Retira uma tarefa da fila: do fim (dona) ou do início (roubo).
+ *
+ * @return int 1 se uma tarefa foi retirada, 0 se a fila estava vazia.
+ */
+int retirarTarefa(FilaTrabalho *fila, TarefaResolvedor *tarefa, int do_inicio) {
+    pthread_mutex_lock(&fila->trava);
+    int sucesso = fila->qtd > 0;
+    if (sucesso) {
+        if (do_inicio) {
+            *tarefa = fila->tarefas[fila->inicio];
+            fila->inicio = (fila->inicio + 1) % fila->capacidade;
+        } else {
+            *tarefa = fila->tarefas[(fila->inicio + fila->qtd - 1) % fila->capacidade];
+        }
+        __atomic_store_n(&fila->qtd, fila->qtd - 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&fila->trava);
+    return sucesso;
+}
+
+/**
+ * @brief Monta a tabela pista -> (id, suspeito) do resolvedor a partir da Tabela Hash.
+ *
+ * A Hash do jogo tem poucos baldes (TAMANHO_HASH); para milhões de consultas o
+ * resolvedor usa uma cópia num mapa texto -> id com endereçamento aberto (núcleo comum).
+ */
+void prepararResolvedor(Resolvedor *resolvedor, int num_threads) {
+    memset(resolvedor, 0, sizeof(Resolvedor));
+    int total = 0;
+    for (int b = 0; b < TAMANHO_HASH; b++) {
+        for (HashNode *no = tabela_suspeitos.tabela[b]; no != NULL; no = no->proximo) {
+            total++;
+        }
+    }
+    resolvedor->textos_pista = (const char**)mallocContado((total + 1) * sizeof(const char*));
+    resolvedor->suspeito_da_pista = (int*)mallocContado((total + 1) * sizeof(int));
+    resolvedor->suspeitos = (const char**)mallocContado((total + 1) * sizeof(const char*));
+    if (resolvedor->textos_pista == NULL || resolvedor->suspeito_da_pista == NULL || resolvedor->suspeitos == NULL) {
+        perror("Erro ao alocar memoria para o resolvedor.");
+        exit(EXIT_FAILURE);
+    }
+    MapaTextoId_iniciar(&resolvedor->ids);
+
+    for (int b = 0; b < TAMANHO_HASH; b++) {
+        for (HashNode *no = tabela_suspeitos.tabela[b]; no != NULL; no = no->proximo) {
+            // Suspeito: reaproveita o id se o nome já apareceu
+            int suspeito = 0;
+            while (suspeito < resolvedor->num_suspeitos && strcmp(resolvedor->suspeitos[suspeito], no->suspeito) != 0) {
+                suspeito++;
+            }
+            if (suspeito == resolvedor->num_suspeitos) {
+                resolvedor->suspeitos[resolvedor->num_suspeitos++] = no->suspeito;
+            }
+            // Pista: a primeira associação registrada prevalece, como em encontrarSuspeito
+            int nova;
+            MapaTextoId_obter(&resolvedor->ids, no->pista, resolvedor->num_pistas, &nova);
+            if (nova) {
+                int id = resolvedor->num_pistas++;
+                resolvedor->textos_pista[id] = no->pista;
+                resolvedor->suspeito_da_pista[id] = suspeito;
+            }
+        }
+    }
+
+    if (num_threads <= 0) {
+        num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    resolvedor->num_threads = num_threads < 1 ? 1 : (num_threads > MAX_THREADS_RESOLVEDOR ? MAX_THREADS_RESOLVEDOR : num_threads);
+    for (int t = 0; t < resolvedor->num_threads; t++) {
+        pthread_mutex_init(&resolvedor->filas[t].trava, NULL);
+    }
+}
+
+/**
+ * @brief Id da pista de uma sala no resolvedor (-1 se a sala não tem pista associada a suspeito).
+ */
+int idPistaResolvedor(const Resolvedor *resolvedor, const char *texto) {
+    if (texto[0] == '\0') {
+        return -1;
+    }
+    const int *id = MapaTextoId_buscar(&resolvedor->ids, texto);
+    return id != NULL ? *id : -1;
 }
 
 /**
- * @brief Conduz a fase de julgamento final.
- *
- * Requisito: Verificar se pelo menos duas pistas apontam para o suspeito acusado.
+ * @brief Acrescenta uma pista ao caminho atual da thread (pistas repetidas contam uma vez, como na BST).
  */
-void verificarSuspeitoFinal() {
-    char acusado[MAX_NOME];
-    
-    printf("\n\n********************************************************\n");
-    printf("            FASE DE JULGAMENTO FINAL\n");
-    printf("********************************************************\n");
-    
-    printf("Voce analisou as pistas coletadas:\n");
-    exibirPistas(raiz_pistas);
-    printf("--------------------------------------------------------\n");
-    
-    printf("Insira o nome do SUSPEITO que voce acusa (Ex: 'Camila', 'Carlos', 'Cris'): ");
-    // Lê o nome do suspeito acusado
-    if (scanf(" %49s", acusado) != 1) {
-        printf("[ERRO] Entrada invalida. Julgamento encerrado.\n");
+void aplicarPistaResolvedor(TrabalhadorResolvedor *trabalhador, int id) {
+    if (trabalhador->tam_caminho == trabalhador->cap_caminho) {
+        trabalhador->caminho = (int*)garantirCapacidade(trabalhador->caminho, &trabalhador->cap_caminho,
+                                                        trabalhador->tam_caminho + 1, sizeof(int));
+    }
+    trabalhador->caminho[trabalhador->tam_caminho++] = id;
+    if (trabalhador->vistas[id]++ == 0) {
+        int suspeito = trabalhador->resolvedor->suspeito_da_pista[id];
+        if (++trabalhador->evidencias[suspeito] == PISTAS_MINIMAS) {
+            trabalhador->acusaveis++;
+        }
+    }
+}
+
+/**
+ * @brief Remove do caminho atual a última pista aplicada.
+ */
+void reverterPistaResolvedor(TrabalhadorResolvedor *trabalhador) {
+    int id = trabalhador->caminho[--trabalhador->tam_caminho];
+    if (--trabalhador->vistas[id] == 0) {
+        int suspeito = trabalhador->resolvedor->suspeito_da_pista[id];
+        if (trabalhador->evidencias[suspeito]-- == PISTAS_MINIMAS) {
+            trabalhador->acusaveis--;
+        }
+    }
+}
+
+/**
+ * @brief Contabiliza um caminho completo (a sala atual é uma folha).
+ */
+void avaliarCaminho(TrabalhadorResolvedor *trabalhador) {
+    trabalhador->caminhos++;
+    if (trabalhador->acusaveis == 0) {
         return;
     }
+    trabalhador->resolviveis++;
+    if (trabalhador->acusaveis > 1) {
+        trabalhador->ambiguos++;
+    }
+    for (int s = 0; s < trabalhador->resolvedor->num_suspeitos; s++) {
+        if (trabalhador->evidencias[s] >= PISTAS_MINIMAS) {
+            trabalhador->acusavel_por_suspeito[s]++;
+        }
+    }
+}
 
-    printf("\nACUSADO: %s\n", acusado);
-    printf("ANALISANDO as pistas coletadas...\n");
+/**
+ * @brief Enumera todos os caminhos da subárvore de uma tarefa (DFS iterativa).
+ *
+ * Quando a fila da thread está quase vazia, a subárvore direita de um nó com
+ * dois filhos vira uma nova tarefa (com cópia do caminho atual como prefixo),
+ * ficando disponível para ser roubada por threads ociosas.
+ */
+void executarTarefaResolvedor(TrabalhadorResolvedor *trabalhador, TarefaResolvedor *tarefa) {
+    Resolvedor *resolvedor = trabalhador->resolvedor;
+    FilaTrabalho *fila = &resolvedor->filas[trabalhador->indice];
 
-    // Requisito: Contar as pistas que apontam para o acusado
-    int total_pistas = contarPistasParaSuspeito(raiz_pistas, acusado);
+    for (int i = 0; i < tarefa->tam_prefixo; i++) {
+        aplicarPistaResolvedor(trabalhador, tarefa->prefixo[i]);
+    }
 
-    printf("Pistas que apontam para %s: %d\n", acusado, total_pistas);
+    // Pilha de quadros: sala e se a pista dela foi aplicada (fase de saída)
+    int cap_pilha = 64, topo = 0;
+    Sala **salas = (Sala**)mallocContado(cap_pilha * sizeof(Sala*));
+    signed char *saindo = (signed char*)mallocContado(cap_pilha);
+    if (salas == NULL || saindo == NULL) {
+        perror("Erro ao alocar memoria para o resolvedor.");
+        exit(EXIT_FAILURE);
+    }
+    salas[topo] = tarefa->sala;
+    saindo[topo++] = 0;
 
-    // Requisito: Verificar se, pelo menos, duas pistas sustentam a acusação
-    if (total_pistas >= PISTAS_MINIMAS) {
-        printf("\n=> [VEREDITO: CULPADO!] A acusacao e sustentada por %d pistas.\n", total_pistas);
-        printf("A justica foi feita! Parabens, Detetive.\n");
-    } else {
-        printf("\n=> [VEREDITO: INSUFICIENTE!] Apenas %d pistas apoiam a acusacao.\n", total_pistas);
-        printf("Nao ha provas suficientes. O culpado escapou! Continue a investigar.\n");
+    while (topo > 0) {
+        Sala *sala = salas[topo - 1];
+        if (saindo[topo - 1]) {
+            // Saída: desfaz a pista desta sala (-1 no quadro indica sala sem pista)
+            if (saindo[topo - 1] > 0) {
+                reverterPistaResolvedor(trabalhador);
+            }
+            topo--;
+            continue;
+        }
+
+        trabalhador->salas_visitadas++;
+        int id = idPistaResolvedor(resolvedor, sala->pista_estatica);
+        if (id >= 0) {
+            aplicarPistaResolvedor(trabalhador, id);
+        }
+        saindo[topo - 1] = id >= 0 ? 1 : -1;
+
+        Sala *esquerda = sala->esquerda, *direita = sala->direita;
+        if (esquerda == NULL && direita == NULL) {
+            avaliarCaminho(trabalhador);
+            continue;
+        }
+        if (esquerda != NULL && direita != NULL && __atomic_load_n(&fila->qtd, __ATOMIC_RELAXED) < TAREFAS_MINIMAS_FILA) {
+            TarefaResolvedor nova = { direita, NULL, trabalhador->tam_caminho };
+            nova.prefixo = (int*)mallocContado((nova.tam_prefixo > 0 ? nova.tam_prefixo : 1) * sizeof(int));
+            if (nova.prefixo == NULL) {
+                perror("Erro ao alocar memoria para o resolvedor.");
+                exit(EXIT_FAILURE);
+            }
+            memcpy(nova.prefixo, trabalhador->caminho, nova.tam_prefixo * sizeof(int));
+            __atomic_add_fetch(&resolvedor->pendentes, 1, __ATOMIC_SEQ_CST);
+            empilharTarefa(fila, nova);
+            direita = NULL;
+        }
+        if (topo + 2 > cap_pilha) {
+            cap_pilha *= 2;
+            salas = (Sala**)reallocContado(salas, cap_pilha * sizeof(Sala*));
+            saindo = (signed char*)reallocContado(saindo, cap_pilha);
+            if (salas == NULL || saindo == NULL) {
+                perror("Erro ao alocar memoria para o resolvedor.");
+                exit(EXIT_FAILURE);
+            }
+        }
+        if (direita != NULL) {
+            salas[topo] = direita;
+            saindo[topo++] = 0;
+        }
+        if (esquerda != NULL) {
+            salas[topo] = esquerda;
+            saindo[topo++] = 0;
+        }
+    }
+    freeContado(salas);
+    freeContado(saindo);
+
+    for (int i = 0; i < tarefa->tam_prefixo; i++) {
+        reverterPistaResolvedor(trabalhador);
+    }
+}
+
+/**
+ * @brief Laço de uma thread: consome a própria fila e rouba das outras quando ela esvazia.
+ */
+void* cicloResolvedor(void *argumento) {
+    TrabalhadorResolvedor *trabalhador = (TrabalhadorResolvedor*)argumento;
+    Resolvedor *resolvedor = trabalhador->resolvedor;
+    TarefaResolvedor tarefa;
+
+    while (1) {
+        int obtida = retirarTarefa(&resolvedor->filas[trabalhador->indice], &tarefa, 0);
+        for (int k = 1; !obtida && k < resolvedor->num_threads; k++) {
+            int vitima = (trabalhador->indice + k) % resolvedor->num_threads;
+            obtida = retirarTarefa(&resolvedor->filas[vitima], &tarefa, 1);
+            trabalhador->tarefas_roubadas += obtida;
+        }
+        if (obtida) {
+            TELEMETRIA_INICIO(marca_tarefa);
+            executarTarefaResolvedor(trabalhador, &tarefa);
+            TELEMETRIA_FIM(marca_tarefa, "resolvedor.tarefa");
+            freeContado(tarefa.prefixo);
+            __atomic_sub_fetch(&resolvedor->pendentes, 1, __ATOMIC_SEQ_CST);
+        } else if (__atomic_load_n(&resolvedor->pendentes, __ATOMIC_SEQ_CST) == 0) {
+            break; // Nenhuma tarefa em execução pode gerar outras
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Enumera todos os caminhos raiz-folha do mapa e relata quais suspeitos ficam acusáveis.
+ *
+ * Cada thread mantém a própria contagem de evidências do caminho que percorre
+ * (sem tocar em raiz_pistas nem nas flags das salas), então o mapa e a Hash
+ * são apenas lidos durante a enumeração.
+ * @param num_threads Quantidade de threads (0 = todos os núcleos disponíveis).
+ * @return int 1 se existe ao menos um caminho com suspeito acusável (caso resolvível).
+ */
+int resolverMansao(Sala *raiz, int num_threads) {
+    Resolvedor resolvedor;
+    prepararResolvedor(&resolvedor, num_threads);
+    TrabalhadorResolvedor trabalhadores[MAX_THREADS_RESOLVEDOR];
+    pthread_t threads[MAX_THREADS_RESOLVEDOR];
+    memset(trabalhadores, 0, sizeof(trabalhadores));
+
+    for (int t = 0; t < resolvedor.num_threads; t++) {
+        trabalhadores[t].resolvedor = &resolvedor;
+        trabalhadores[t].indice = t;
+        trabalhadores[t].vistas = (int*)callocContado(resolvedor.num_pistas + 1, sizeof(int));
+        trabalhadores[t].evidencias = (int*)callocContado(resolvedor.num_suspeitos + 1, sizeof(int));
+        trabalhadores[t].acusavel_por_suspeito = (long long*)callocContado(resolvedor.num_suspeitos + 1, sizeof(long long));
+        if (trabalhadores[t].vistas == NULL || trabalhadores[t].evidencias == NULL ||
+            trabalhadores[t].acusavel_por_suspeito == NULL) {
+            perror("Erro ao alocar memoria para o resolvedor.");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    double inicio = tempoAtual();
+    if (raiz != NULL) {
+        resolvedor.pendentes = 1;
+        empilharTarefa(&resolvedor.filas[0], (TarefaResolvedor){ raiz, NULL, 0 });
+    }
+    int criadas[MAX_THREADS_RESOLVEDOR] = {0};
+    for (int t = 1; t < resolvedor.num_threads; t++) {
+        criadas[t] = pthread_create(&threads[t], NULL, cicloResolvedor, &trabalhadores[t]) == 0;
     }
+    cicloResolvedor(&trabalhadores[0]);
+    for (int t = 1; t < resolvedor.num_threads; t++) {
+        if (criadas[t]) {
+            pthread_join(threads[t], NULL);
+        }
+    }
+    double segundos = tempoAtual() - inicio;
+
+    // Soma os resultados parciais de cada thread
+    long long caminhos = 0, resolviveis = 0, ambiguos = 0, salas = 0, roubadas = 0;
+    for (int t = 0; t < resolvedor.num_threads; t++) {
+        caminhos += trabalhadores[t].caminhos;
+        resolviveis += trabalhadores[t].resolviveis;
+        ambiguos += trabalhadores[t].ambiguos;
+        salas += trabalhadores[t].salas_visitadas;
+        roubadas += trabalhadores[t].tarefas_roubadas;
+    }
+
+    printf("\n********************************************************\n");
+    printf("            RESOLVEDOR EXAUSTIVO DA MANSAO\n");
+    printf("********************************************************\n");
+    printf("Comodos visitados: %lld | Caminhos (raiz -> fim): %lld\n", salas, caminhos);
+    printf("Threads: %d | Tarefas roubadas: %lld | Tempo: %.3f s\n", resolvedor.num_threads, roubadas, segundos);
+    printf("Caminhos com acusacao sustentavel (>= %d pistas): %lld (%.1f%%)\n", PISTAS_MINIMAS,
+           resolviveis, caminhos > 0 ? 100.0 * resolviveis / caminhos : 0.0);
+    printf("Caminhos com mais de um suspeito acusavel: %lld\n", ambiguos);
+    printf("--------------------------------------------------------\n");
+    for (int s = 0; s < resolvedor.num_suspeitos; s++) {
+        long long total = 0;
+        for (int t = 0; t < resolvedor.num_threads; t++) {
+            total += trabalhadores[t].acusavel_por_suspeito[s];
+        }
+        printf("%-20s acusavel em %lld caminho(s) (%.1f%%)\n", resolvedor.suspeitos[s], total,
+               caminhos > 0 ? 100.0 * total / caminhos : 0.0);
+    }
+    printf("--------------------------------------------------------\n");
+    printf("=> Caso %s.\n", resolviveis == 0 ? "SEM SOLUCAO em nenhum caminho" :
+           (resolviveis == caminhos ? "resolvivel em TODOS os caminhos" : "resolvivel em parte dos caminhos"));
     printf("********************************************************\n");
+
+    for (int t = 0; t < resolvedor.num_threads; t++) {
+        freeContado(trabalhadores[t].vistas);
+        freeContado(trabalhadores[t].evidencias);
+        freeContado(trabalhadores[t].acusavel_por_suspeito);
+        freeContado(trabalhadores[t].caminho);
+        freeContado(resolvedor.filas[t].tarefas);
+        pthread_mutex_destroy(&resolvedor.filas[t].trava);
+    }
+    freeContado(resolvedor.textos_pista);
+    freeContado(resolvedor.suspeito_da_pista);
+    freeContado(resolvedor.suspeitos);
+    MapaTextoId_liberar(&resolvedor.ids);
+    return resolviveis > 0;
 }
 
 // ------------------------------------------
-// 9. FUNÇÃO PRINCIPAL DE EXPLORAÇÃO
+// 17. FUNÇÃO PRINCIPAL DE EXPLORAÇÃO
 // ------------------------------------------
 
 /**
  * @brief Controla a navegação do jogador, coleta de pistas e interage com a Hash/BST.
  *
  * Requisito: Navega pela arvore e ativa o sistema de pistas.
+ * @param inicio Sala onde a exploração começa (Hall de Entrada ou sala restaurada).
  */
-void explorarSalas(Sala *raiz) {
-    Sala *atual = raiz;
+void explorarSalas(Sala *inicio) {
+    Sala *atual = inicio;
     char opcao;
+    char comando_passo = '\0'; // Comando em andamento (medido só no gerador de carga)
+    double inicio_passo = 0.0;
     
     printf("\n>>> Detective Quest - Desafio Final: Julgamento <<<\n");
     printf("Explore, colete pistas e sustente sua acusacao.\n\n");
@@ -383,9 +2700,19 @@ void explorarSalas(Sala *raiz) {
         // Lógica de coleta de pista
         if (atual->pista_coletada == 0 && atual->pista_estatica[0] != '\0') {
             
-            // 1. Insere na BST (Pistas coletadas)
+            // 1. Insere na BST (nova versão das pistas coletadas) e no índice de busca
+            double inicio_coleta = medicao_carga != NULL ? tempoAtual() : 0.0;
+            TELEMETRIA_INICIO(marca_insercao);
             raiz_pistas = inserirPista(raiz_pistas, atual->pista_estatica);
-            
+            TELEMETRIA_FIM(marca_insercao, "bst.inserir");
+            TELEMETRIA_CONTAR("bst.profundidade", profundidadePista(raiz_pistas, atual->pista_estatica));
+            int ja_ativa = pistaAtivaNoIndice(&indice_pistas, atual->pista_estatica);
+            int id_indice = adicionarAoIndice(&indice_pistas, atual->pista_estatica);
+            registrarColeta(&historico, atual, ja_ativa ? -1 : id_indice);
+            if (medicao_carga != NULL) {
+                registrarPasso(medicao_carga, 'c', tempoAtual() - inicio_coleta);
+            }
+
             // 2. Marca a pista como coletada para evitar duplicidade
             atual->pista_coletada = 1; 
             
@@ -414,19 +2741,41 @@ void explorarSalas(Sala *raiz) {
             caminhos_disponiveis = 1;
         }
 
+        if (grafo_mansao != NULL && atual->id >= 0) {
+            int passagens = grafo_mansao->inicio_saidas[atual->id + 1] - grafo_mansao->inicio_saidas[atual->id];
+            if (passagens > 0) {
+                printf(" [V] Passagens (volta e atalhos): %d saida(s)\n", passagens);
+                caminhos_disponiveis = 1;
+            }
+        }
+
         if (!caminhos_disponiveis) {
             printf("[FIM DE CAMINHO] Nenhuma saida adicional.\n");
         }
 
+        printf(" [P] Rota ate a pista mais proxima.\n");
+        printf(" [M] Alcance da mansao a partir daqui.\n");
+        printf(" [B] Buscar nas pistas coletadas.\n");
+        printf(" [G] Gravar a investigacao (%s).\n", arquivo_snapshot);
+        printf(" [R] Ramificar (guardar este ponto) | [X] Desfazer ate o ultimo ponto | [W] Comparar ramo\n");
         printf(" [S] SAIR do Jogo e Iniciar o Julgamento.\n");
         printf("--------------------------------------------------------\n");
-        printf("Sua escolha (e/d/s): ");
+        printf("Sua escolha (e/d/v/p/m/b/g/r/x/w/s): ");
 
-        if (scanf(" %c", &opcao) != 1) {
-            while (getchar() != '\n');
+        // Na carga, o passo anterior termina quando o próximo comando é pedido
+        if (medicao_carga != NULL && comando_passo != '\0') {
+            registrarPasso(medicao_carga, comando_passo, tempoAtual() - inicio_passo);
+        }
+        if (fscanf(entrada_jogo, " %c", &opcao) != 1) {
+            int c;
+            while ((c = fgetc(entrada_jogo)) != '\n' && c != EOF);
             opcao = 's';
         }
         opcao = tolower(opcao);
+        if (medicao_carga != NULL) {
+            comando_passo = opcao;
+            inicio_passo = tempoAtual();
+        }
 
         if (opcao == 'e') {
             if (atual->esquerda != NULL) {
@@ -440,6 +2789,33 @@ void explorarSalas(Sala *raiz) {
             } else {
                 printf("[ALERTA] Nao ha caminho a direita.\n");
             }
+        } else if (opcao == 'v') {
+            atual = seguirPassagem(atual);
+        } else if (opcao == 'p') {
+            exibirRotaPistaMaisProxima(atual);
+        } else if (opcao == 'm') {
+            exibirAlcanceMansao(atual);
+        } else if (opcao == 'b') {
+            buscarPistasInterativo(&indice_pistas);
+        } else if (opcao == 'g') {
+            if (salvarInvestigacao(arquivo_snapshot, atual)) {
+                printf("[GRAVADO] Investigacao salva em '%s'. Retome com --carregar %s.\n", arquivo_snapshot, arquivo_snapshot);
+            } else {
+                printf("[ERRO] Nao foi possivel gravar a investigacao em '%s'.\n", arquivo_snapshot);
+            }
+        } else if (opcao == 'r') {
+            ramificarInvestigacao(&historico, atual);
+            printf("[RAMO] Ponto de ramificacao %d criado em '%s'.\n", historico.qtd_pontos, atual->nome);
+        } else if (opcao == 'x') {
+            Sala *retorno = desfazerRamificacao(&historico);
+            if (retorno != NULL) {
+                atual = retorno;
+                printf("[RAMO] Investigacao desfeita ate o ponto em '%s'.\n", atual->nome);
+            } else {
+                printf("[ALERTA] Nao ha ramificacao para desfazer.\n");
+            }
+        } else if (opcao == 'w') {
+            compararRamificacao(&historico);
         } else if (opcao == 's') {
             break;
         } else {
@@ -450,38 +2826,493 @@ void explorarSalas(Sala *raiz) {
 }
 
 // ------------------------------------------
-// 10. FUNÇÃO PRINCIPAL (MAIN)
+// 18. GERADOR DE CARGA (Sessões Automáticas)
+// ------------------------------------------
+
+/**
+ * @brief Comparador de durações para qsort.
+ */
+int compararTempos(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Acrescenta um texto ao fim da sessão em montagem.
+ */
+void acrescentarTexto(TextoSessao *sessao, const char *texto) {
+    for (; *texto != '\0'; texto++) {
+        TextoSessao_acrescentar(sessao, *texto);
+    }
+}
+
+/**
+ * @brief Reúne as pistas e os suspeitos distintos da Tabela Hash para o sorteio das sessões.
+ */
+void coletarTextosDaHash(VetorTextos *pistas, VetorTextos *suspeitos) {
+    for (int b = 0; b < TAMANHO_HASH; b++) {
+        for (HashNode *no = tabela_suspeitos.tabela[b]; no != NULL; no = no->proximo) {
+            VetorTextos_acrescentar(pistas, no->pista);
+            int repetido = 0;
+            for (int i = 0; i < suspeitos->qtd && !repetido; i++) {
+                repetido = strcmp(suspeitos->itens[i], no->suspeito) == 0;
+            }
+            if (!repetido) {
+                VetorTextos_acrescentar(suspeitos, no->suspeito);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Sorteia um termo de busca a partir de uma palavra da pista (às vezes como prefixo 'abc*').
+ */
+void sortearTermo(const char *pista, unsigned int *estado, char *termo, size_t tamanho) {
+    int palavras = 0;
+    for (const char *c = pista; *c != '\0'; c++) {
+        if (*c != ' ' && (c == pista || c[-1] == ' ')) {
+            palavras++;
+        }
+    }
+    int alvo = palavras > 0 ? (int)(proximoAleatorio(estado) % palavras) : 0;
+    while (*pista == ' ') {
+        pista++;
+    }
+    for (; alvo > 0; alvo--) {
+        pista = strchr(pista, ' ');
+        while (*pista == ' ') {
+            pista++;
+        }
+    }
+    size_t comprimento = strcspn(pista, " ");
+    if (comprimento > tamanho - 2) {
+        comprimento = tamanho - 2;
+    }
+    if (comprimento > 3 && proximoAleatorio(estado) % 3 == 0) {
+        comprimento = comprimento / 2;
+        memcpy(termo, pista, comprimento);
+        termo[comprimento++] = '*';
+    } else {
+        memcpy(termo, pista, comprimento);
+    }
+    termo[comprimento] = '\0';
+}
+
+/**
+ * @brief Monta uma sessão sorteada: o que um jogador digitaria até acusar alguém.
+ *
+ * Acompanha a sala em que o jogador estaria (e os pontos de ramificação) para só
+ * pedir saídas que existem; ao chegar num fim de caminho, desfaz até o último ponto
+ * ou encerra a exploração. O comando de gravação não é sorteado.
+ */
+void sortearSessao(TextoSessao *sessao, Sala *inicio, const VetorTextos *pistas,
+                   const VetorTextos *suspeitos, unsigned int *estado) {
+    Sala *atual = inicio;
+    Sala *pontos[PASSOS_SESSAO_CARGA];
+    int qtd_pontos = 0;
+    int passos = 1 + (int)(proximoAleatorio(estado) % PASSOS_SESSAO_CARGA);
+    char termo[MAX_PISTA];
+
+    sessao->qtd = 0;
+    for (int i = 0; i < passos; i++) {
+        unsigned int sorteio = proximoAleatorio(estado) % 100;
+        int tem_saida = atual->esquerda != NULL || atual->direita != NULL;
+        if (sorteio < 70) {
+            if (tem_saida) {
+                int esquerda = atual->direita == NULL ||
+                               (atual->esquerda != NULL && proximoAleatorio(estado) % 2 == 0);
+                acrescentarTexto(sessao, esquerda ? "e\n" : "d\n");
+                atual = esquerda ? atual->esquerda : atual->direita;
+            } else if (qtd_pontos > 0) {
+                acrescentarTexto(sessao, "x\n");
+                atual = pontos[--qtd_pontos];
+            } else {
+                break; // Fim de caminho sem ramificação aberta
+            }
+        } else if (sorteio < 76) {
+            acrescentarTexto(sessao, "p\n");
+        } else if (sorteio < 78) {
+            acrescentarTexto(sessao, "m\n");
+        } else if (sorteio < 86 && pistas->qtd > 0) {
+            sortearTermo(pistas->itens[proximoAleatorio(estado) % pistas->qtd], estado, termo, sizeof(termo));
+            acrescentarTexto(sessao, "b\n");
+            acrescentarTexto(sessao, termo);
+            acrescentarTexto(sessao, "\n");
+        } else if (sorteio < 92) {
+            acrescentarTexto(sessao, "r\n");
+            pontos[qtd_pontos++] = atual;
+        } else if (sorteio < 96) {
+            acrescentarTexto(sessao, "x\n");
+            if (qtd_pontos > 0) {
+                atual = pontos[--qtd_pontos];
+            }
+        } else {
+            acrescentarTexto(sessao, "w\n");
+        }
+    }
+
+    acrescentarTexto(sessao, "s\n");
+    if (suspeitos->qtd > 0) {
+        acrescentarTexto(sessao, suspeitos->itens[proximoAleatorio(estado) % suspeitos->qtd]);
+    }
+    acrescentarTexto(sessao, "\n");
+}
+
+/**
+ * @brief Lê sessões gravadas: comandos como digitados no jogo, sessões separadas por linhas "---".
+ *
+ * @param limites Recebe pares (início, tamanho) de cada sessão dentro do texto.
+ * @return char* O texto do arquivo (liberar com free), ou NULL se não puder ser lido.
+ */
+char* carregarSessoesGravadas(const char *arquivo, VetorInteiros *limites) {
+    FILE *f = fopen(arquivo, "rb");
+    if (f == NULL) {
+        return NULL;
+    }
+    TextoSessao texto;
+    TextoSessao_iniciar(&texto);
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+        TextoSessao_acrescentar(&texto, (char)c);
+    }
+    fclose(f);
+    TextoSessao_acrescentar(&texto, '\n'); // Garante que a última linha termina
+
+    int inicio_sessao = 0;
+    for (int i = 0; i < texto.qtd; ) {
+        int fim_linha = i;
+        while (texto.itens[fim_linha] != '\n') {
+            fim_linha++;
+        }
+        int comprimento = fim_linha - i;
+        if (comprimento > 0 && texto.itens[fim_linha - 1] == '\r') {
+            comprimento--;
+        }
+        int separador = comprimento == 3 && memcmp(texto.itens + i, "---", 3) == 0;
+        if (separador || fim_linha + 1 == texto.qtd) {
+            int fim_sessao = separador ? i : fim_linha + 1;
+            int vazia = 1;
+            for (int j = inicio_sessao; j < fim_sessao && vazia; j++) {
+                vazia = isspace((unsigned char)texto.itens[j]);
+            }
+            if (!vazia) {
+                VetorInteiros_acrescentar(limites, inicio_sessao);
+                VetorInteiros_acrescentar(limites, fim_sessao - inicio_sessao);
+            }
+            inicio_sessao = fim_linha + 1;
+        }
+        i = fim_linha + 1;
+    }
+    return texto.itens;
+}
+
+/**
+ * @brief Devolve coletas, versões da BST, índice e histórico ao estado anterior à carga.
+ *
+ * A versão inicial das pistas é vazia ou vem do snapshot mapeado; em ambos os casos
+ * nenhum nó dela está na arena, que pode ser liberada inteira.
+ */
+void reiniciarSessao(PistaNode *raiz_inicial) {
+    for (int i = 0; i < historico.qtd_coletas; i++) {
+        historico.coletas[i].sala->pista_coletada = 0;
+    }
+    liberarHistorico(&historico);
+    liberarPistas();
+    raiz_pistas = raiz_inicial;
+    liberarIndice(&indice_pistas);
+    inicializarIndice(&indice_pistas);
+    indexarPistasRestauradas(raiz_inicial);
+}
+
+/**
+ * @brief Heap em uso pelo programa, em KB (0 se o alocador não informa).
+ */
+long heapEmUsoKB() {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    return (long)(mallinfo2().uordblks / 1024);
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Pico de memória residente do processo até agora, em KB.
+ */
+long picoMemoriaKB() {
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    return uso.ru_maxrss;
+}
+
+/**
+ * @brief Exibe uma linha de percentis (ordem mais próxima) de uma lista de durações.
+ */
+void exibirPercentis(const char *nome, VetorTempos *tempos) {
+    qsort(tempos->itens, tempos->qtd, sizeof(double), compararTempos);
+    double p[3];
+    const double fracoes[3] = { 0.50, 0.90, 0.99 };
+    for (int i = 0; i < 3; i++) {
+        int posicao = (int)(fracoes[i] * tempos->qtd + 0.999999) - 1;
+        p[i] = tempos->itens[posicao < 0 ? 0 : posicao];
+    }
+    printf("  %-12s %9d %10.1f %10.1f %10.1f %10.1f\n", nome, tempos->qtd,
+           p[0] * 1e6, p[1] * 1e6, p[2] * 1e6, tempos->itens[tempos->qtd - 1] * 1e6);
+}
+
+/**
+ * @brief Roda sessões de exploração e julgamento sem jogador e relata latência e memória.
+ *
+ * Cada sessão percorre os mesmos caminhos do jogo (explorarSalas e verificarSuspeitoFinal),
+ * lendo os comandos de um texto em memória, com a saída do jogo descartada. Entre as
+ * sessões, o estado da investigação volta ao inicial.
+ * @param inicio Sala onde cada sessão começa.
+ * @param num_sessoes Quantidade de sessões.
+ * @param arquivo_sessoes Sessões gravadas, repetidas em ciclo (NULL: sessões sorteadas).
+ * @param semente Semente do sorteio das sessões.
+ * @return int 1 se a carga rodou, 0 em caso de erro.
+ */
+int executarCarga(Sala *inicio, int num_sessoes, const char *arquivo_sessoes, unsigned int semente) {
+    static const char *NOMES_PASSOS[] = { "esquerda", "direita", "passagem", "rota", "alcance", "busca", "gravar",
+                                          "ramificar", "desfazer", "comparar", "invalido", "coleta",
+                                          "julgamento" };
+    VetorInteiros limites;
+    VetorInteiros_iniciar(&limites);
+    char *gravadas = NULL;
+    if (arquivo_sessoes != NULL) {
+        gravadas = carregarSessoesGravadas(arquivo_sessoes, &limites);
+        if (gravadas == NULL || limites.qtd == 0) {
+            printf("[ERRO] Nenhuma sessao em '%s'.\n", arquivo_sessoes);
+            freeContado(gravadas);
+            VetorInteiros_liberar(&limites);
+            return 0;
+        }
+    }
+
+    VetorTextos pistas, suspeitos;
+    VetorTextos_iniciar(&pistas);
+    VetorTextos_iniciar(&suspeitos);
+    coletarTextosDaHash(&pistas, &suspeitos);
+    TextoSessao sessao;
+    TextoSessao_iniciar(&sessao);
+    MedicaoCarga medicao;
+    for (int t = 0; t < (int)sizeof(TIPOS_PASSO) - 1; t++) {
+        VetorTempos_iniciar(&medicao.tempos[t]);
+    }
+
+    PistaNode *raiz_inicial = raiz_pistas;
+    unsigned int estado = semente;
+    ContagemAlocacoes antes = alocacoes;
+    long heap_antes = heapEmUsoKB();
+    long pico_antes = picoMemoriaKB();
+
+    // A saída do jogo vai para /dev/null durante as sessões
+    fflush(stdout);
+    int saida_original = dup(STDOUT_FILENO);
+    int descarte = open("/dev/null", O_WRONLY);
+    if (saida_original < 0 || descarte < 0) {
+        perror("Erro ao descartar a saida do jogo");
+        exit(EXIT_FAILURE);
+    }
+    dup2(descarte, STDOUT_FILENO);
+    close(descarte);
+
+    double inicio_carga = tempoAtual();
+    int executadas = 0;
+    for (; executadas < num_sessoes; executadas++) {
+        char *texto;
+        size_t tamanho;
+        if (gravadas != NULL) {
+            int s = executadas % (limites.qtd / 2);
+            texto = gravadas + limites.itens[2 * s];
+            tamanho = (size_t)limites.itens[2 * s + 1];
+        } else {
+            sortearSessao(&sessao, inicio, &pistas, &suspeitos, &estado);
+            texto = sessao.itens;
+            tamanho = (size_t)sessao.qtd;
+        }
+        entrada_jogo = fmemopen(texto, tamanho, "r");
+        if (entrada_jogo == NULL) {
+            break;
+        }
+
+        medicao_carga = &medicao;
+        explorarSalas(inicio);
+        double inicio_julgamento = tempoAtual();
+        verificarSuspeitoFinal();
+        registrarPasso(&medicao, 'j', tempoAtual() - inicio_julgamento);
+        medicao_carga = NULL;
+
+        fclose(entrada_jogo);
+        reiniciarSessao(raiz_inicial);
+    }
+    double segundos = tempoAtual() - inicio_carga;
+
+    fflush(stdout);
+    dup2(saida_original, STDOUT_FILENO);
+    close(saida_original);
+    entrada_jogo = stdin;
+
+    // Relatório: percentis por tipo de passo e uso de memória
+    VetorTempos comandos;
+    VetorTempos_iniciar(&comandos);
+    for (int t = 0; TIPOS_PASSO[t] != '\0'; t++) {
+        if (TIPOS_PASSO[t] != 'c' && TIPOS_PASSO[t] != 'j') {
+            for (int i = 0; i < medicao.tempos[t].qtd; i++) {
+                VetorTempos_acrescentar(&comandos, medicao.tempos[t].itens[i]);
+            }
+        }
+    }
+    if (gravadas != NULL) {
+        printf("\n[CARGA] %d sessao(oes) gravadas em '%s' (%d distinta(s)), %d comando(s) em %.2f s.\n",
+               executadas, arquivo_sessoes, limites.qtd / 2, comandos.qtd, segundos);
+    } else {
+        printf("\n[CARGA] %d sessao(oes) sorteadas (semente %u), %d comando(s) em %.2f s.\n",
+               executadas, semente, comandos.qtd, segundos);
+    }
+    printf("  %-12s %9s %10s %10s %10s %10s\n", "PASSO", "QTD", "P50 (us)", "P90 (us)", "P99 (us)", "MAX (us)");
+    for (int t = 0; TIPOS_PASSO[t] != '\0'; t++) {
+        if (medicao.tempos[t].qtd > 0) {
+            exibirPercentis(NOMES_PASSOS[t], &medicao.tempos[t]);
+        }
+    }
+    if (comandos.qtd > 0) {
+        exibirPercentis("comandos", &comandos);
+    }
+
+    long long chamadas = (alocacoes.mallocs - antes.mallocs) + (alocacoes.callocs - antes.callocs) +
+                         (alocacoes.reallocs - antes.reallocs);
+    printf("[MEMORIA] Alocacoes: %lld malloc, %lld calloc, %lld realloc, %lld free (%.1f por sessao).\n",
+           alocacoes.mallocs - antes.mallocs, alocacoes.callocs - antes.callocs,
+           alocacoes.reallocs - antes.reallocs, alocacoes.frees - antes.frees,
+           executadas > 0 ? (double)chamadas / executadas : 0.0);
+
+    // O heap "depois" é medido sem as listas de latência: só o que as sessões deixaram
+    VetorTempos_liberar(&comandos);
+    for (int t = 0; t < (int)sizeof(TIPOS_PASSO) - 1; t++) {
+        VetorTempos_liberar(&medicao.tempos[t]);
+    }
+    TextoSessao_liberar(&sessao);
+    VetorTextos_liberar(&pistas);
+    VetorTextos_liberar(&suspeitos);
+    VetorInteiros_liberar(&limites);
+    freeContado(gravadas);
+    printf("[MEMORIA] Heap em uso: %ld KB antes, %ld KB depois | pico residente: %ld KB antes, %ld KB depois.\n",
+           heap_antes, heapEmUsoKB(), pico_antes, picoMemoriaKB());
+    return executadas == num_sessoes;
+}
+
+// ------------------------------------------
+// 19. FUNÇÃO PRINCIPAL (MAIN)
 // ------------------------------------------
 
-int main() {
+int main(int argc, char *argv[]) {
+    int salas_procedurais = 0; // 0: usa o mapa fixo
+    unsigned int semente = (unsigned int)time(NULL);
+    const char *arquivo_carregar = NULL;
+    int modo_resolvedor = 0, threads_resolvedor = 0;
+    int sessoes_carga = 0;
+    const char *arquivo_sessoes = NULL;
+    int status = EXIT_SUCCESS;
+
+    entrada_jogo = stdin;
+
+    // Argumentos: --mansao N gera uma mansão procedural com N cômodos; --semente S fixa o sorteio;
+    // --carregar ARQ retoma uma investigação gravada (e passa a gravar nela);
+    // --resolver [T] enumera todos os caminhos do mapa com T threads e encerra;
+    // --carga N roda N sessões automáticas (sorteadas, ou de --sessoes ARQ) e relata latência e memória
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--mansao") == 0 && i + 1 < argc) {
+            salas_procedurais = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            semente = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--carregar") == 0 && i + 1 < argc) {
+            arquivo_carregar = argv[++i];
+            arquivo_snapshot = arquivo_carregar;
+        } else if (strcmp(argv[i], "--resolver") == 0) {
+            modo_resolvedor = 1;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) {
+                threads_resolvedor = atoi(argv[++i]);
+            }
+        } else if (strcmp(argv[i], "--carga") == 0 && i + 1 < argc) {
+            sessoes_carga = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--sessoes") == 0 && i + 1 < argc) {
+            arquivo_sessoes = argv[++i];
+        }
+    }
+
     // 1. Inicializa as estruturas
     inicializarHash();
-    
-    // 2. Monta o Mapa (Árvore Binária)
-    Sala *mapa = montarMapa();
-
-    // 3. Preenche a Tabela Hash (Associação Pista -> Suspeito)
-    // OBS: O culpado é a Camila (apontada por 3 pistas)
-    inserirNaHash("A altura do culpado e acima de 1.80m.", "Carlos");
-    inserirNaHash("O culpado fuma charutos cubanos.", "Carlos");
-    inserirNaHash("O culpado possui uma alergia a amendoim.", "Camila");
-    inserirNaHash("O culpado tem um relogio suico de ouro.", "Camila");
-    inserirNaHash("A arma do crime e um castical de bronze.", "Cris");
-    inserirNaHash("O culpado deixou um lenco bordado com a letra 'C'.", "Camila");
-    inserirNaHash("A digital do culpado esta na lamina da faca.", "Cris");
-    printf("\nRegistro de suspeitos e pistas na Tabela Hash concluido.\n");
-
-    // 4. Inicia a Exploração
-    explorarSalas(mapa);
-    
-    // 5. Fase de Julgamento
-    verificarSuspeitoFinal();
+    inicializarIndice(&indice_pistas);
+
+    Sala *mapa;
+    Sala *inicio;
+    if (arquivo_carregar != NULL) {
+        // 2/3. Restaura Hash, pistas coletadas, mapa e grafo do snapshot
+        double tempo_inicio = tempoAtual();
+        mapa = carregarInvestigacao(arquivo_carregar, &inicio);
+        if (mapa == NULL) {
+            printf("[ERRO] Snapshot '%s' ausente ou invalido.\n", arquivo_carregar);
+            liberarIndice(&indice_pistas);
+            return EXIT_FAILURE;
+        }
+        double ms = (tempoAtual() - tempo_inicio) * 1e3;
+        indexarPistasRestauradas(raiz_pistas);
+        printf("\nInvestigacao restaurada de '%s': %d comodos em %.2f ms.\n",
+               arquivo_carregar, grafo_mansao->num_salas, ms);
+    } else {
+        // 2. Preenche a Tabela Hash (Associação Pista -> Suspeito)
+        // OBS: O culpado é a Camila (apontada por 3 pistas)
+        inserirNaHash("A altura do culpado e acima de 1.80m.", "Carlos");
+        inserirNaHash("O culpado fuma charutos cubanos.", "Carlos");
+        inserirNaHash("O culpado possui uma alergia a amendoim.", "Camila");
+        inserirNaHash("O culpado tem um relogio suico de ouro.", "Camila");
+        inserirNaHash("A arma do crime e um castical de bronze.", "Cris");
+        inserirNaHash("O culpado deixou um lenco bordado com a letra 'C'.", "Camila");
+        inserirNaHash("A digital do culpado esta na lamina da faca.", "Cris");
+        printf("\nRegistro de suspeitos e pistas na Tabela Hash concluido.\n");
+
+        // 3. Monta o Mapa (Árvore Binária) e o grafo de navegação (CSR)
+        if (salas_procedurais > 0) {
+            double tempo_inicio = tempoAtual();
+            mapa = gerarMansaoProcedural(salas_procedurais, semente);
+            int num_extras = salas_procedurais / 4;
+            Passagem *extras = gerarPassagensAleatorias(salas_procedurais, num_extras, semente);
+            grafo_mansao = construirGrafo(mapa, extras, num_extras);
+            freeContado(extras);
+            printf("Mansao procedural: %d comodos, %d passagens (semente %u, %.1f ms).\n",
+                   grafo_mansao->num_salas, grafo_mansao->num_saidas, semente, (tempoAtual() - tempo_inicio) * 1e3);
+        } else {
+            mapa = montarMapa();
+            grafo_mansao = construirGrafo(mapa, NULL, 0);
+        }
+        inicio = mapa;
+    }
+
+    if (modo_resolvedor) {
+        // 4/5. Validação automática: todos os caminhos, sem exploração interativa
+        resolverMansao(mapa, threads_resolvedor);
+    } else if (sessoes_carga > 0) {
+        // 4/5. Gerador de carga: exploração e julgamento automáticos, sem prompts
+        if (!executarCarga(inicio, sessoes_carga, arquivo_sessoes, semente)) {
+            status = EXIT_FAILURE;
+        }
+    } else {
+        // 4. Inicia a Exploração
+        explorarSalas(inicio);
+
+        // 5. Fase de Julgamento
+        verificarSuspeitoFinal();
+    }
     
     // 6. Limpeza de Memória
+    liberarGrafo(grafo_mansao);
     liberarMapa(mapa);
-    liberarPistas(raiz_pistas);
+    liberarPistas();
     liberarHash();
+    liberarIndice(&indice_pistas);
+    liberarHistorico(&historico);
+    descarregarSnapshot();
     
     printf("\nSistema encerrado e toda a memoria dinamica liberada.\n");
-    return 0;
-}
\ No newline at end of file
+    return status;
+}
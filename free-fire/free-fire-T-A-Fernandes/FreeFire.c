@@ -1,18 +1,72 @@
 // -------------------------------
 // Bibliotecas
 // -------------------------------
+#define _GNU_SOURCE // clock_gettime, sysconf, syscall (perf_event_open)
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include <limits.h>
 #include <time.h> 
+#include <unistd.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86 // Kernels SSE4.1/AVX2 com escolha em tempo de execução
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include "../../comum/estruturas.h" // Vetor dinâmico e mapas (hash e ordenado) compartilhados pelos três programas
+#include "../../comum/telemetria.h"  // Contadores e intervalos (só com -DTELEMETRIA)
 
 // -------------------------------
 // CONSTANTES
 // -------------------------------
 // Define limites e tamanhos de strings
-#define MAX_COMPONENTES 10  // Quantidade máxima de componentes na mochila
+#define CAPACIDADE_INICIAL 10 // Capacidade inicial da mochila (cresce sob demanda)
+#define ALINHAMENTO_ARENA 64  // Alinhamento dos blocos da arena (linha de cache)
+#define CAPACIDADE_INICIAL_HASH 16 // Capacidade inicial da tabela hash de nomes (potência de 2)
+#define MAX_LOTE 64           // Máximo de nomes por descarte em lote no menu
 #define TAM_NOME 30         // Tamanho máximo do nome de um componente
 #define TAM_TIPO 20         // Tamanho máximo do tipo de um componente
+#define PRIORIDADE_MIN 1    // Faixa válida de prioridade
+#define PRIORIDADE_MAX 5
+#define LIMIAR_INSERCAO 16  // Trechos até este tamanho usam Insertion Sort nos métodos rápidos
+#define TAM_CHAVE_COMPOSTA 27 // Bytes da chave normalizada da ordenação composta
+#define LIMIAR_PARALELO 65536 // Abaixo disso a ordenação paralela usa o caminho serial
+#define MAX_THREADS 64      // Limite de threads da ordenação paralela
+#define MAX_TAREFAS_PARALELAS (2 * MAX_THREADS) // Tarefas por rodada (fatias de intercalação)
+#define LIMITE_BENCH_QUADRATICO 10000 // Maior n medido para Bubble, Insertion e Selection Sort
+#define LIMITE_BENCH_LINEAR 100000    // Maior n medido para a busca sequencial
+#define CONSULTAS_BENCH 1000          // Buscas por medição
+#define BENCH_MAXIMO_PADRAO 10000000  // Maior inventário do --bench sem argumento
+#define TAM_BUFFER_ES (1 << 20)       // Buffer de leitura/escrita da importação e exportação
+#define MAGICA_BINARIO "FFMC"         // Identificador do formato binário da mochila
+#define VERSAO_BINARIO 1
+#define MAGICA_DIARIO "FFWL"          // Identificador do diário de escrita antecipada
+#define VERSAO_DIARIO 2
+#define TAM_BUFFER_DIARIO (1 << 20)   // Cada metade do buffer do diário (maior grupo por fdatasync)
+#define LIMITE_REGISTROS_DIARIO (1 << 20) // Registros no diário antes de um ponto de verificação
+#define ESPERA_GRUPO_DIARIO_US 2000   // Quanto a escritora espera para juntar registros num fdatasync
+#define MIN_COMPACTACAO_POOL (64 * 1024) // Espaço morto mínimo antes de compactar o pool de nomes
+#define MAX_LISTAGEM_FILTRO 20        // Componentes exibidos pelo filtro de prioridade
+#define TAM_LINHA_ROTEIRO 256         // Maior argumento de um comando do modo roteiro
+#define MAX_DISTANCIA_BUSCA 3         // Maior distância de edição aceita na busca aproximada
+#define MIN_LAPIDES_TRIGRAMAS 1024    // Lápides toleradas no índice de trigramas antes de considerar refazê-lo
+#define LIMITE_DP_CARGA (1 << 20)     // Maior limite de espaços resolvido por programação dinâmica
+#define LIMITE_BYTES_DECISAO (128.0 * 1024 * 1024) // Bits de decisão da programação dinâmica
+#define LIMITE_NOS_CARGA 50000000LL   // Nós do branch-and-bound antes de devolver a melhor carga achada
 
 // -------------------------------
 // ESTRUTURA DE DADOS: COMPONENTE
@@ -25,13 +79,258 @@ typedef struct {
     int qtd;               // Quantidade
 } Componente;
 
+// Campo usado como chave de ordenação e dos índices secundários
+// (CAMPO_NOME_SEM_CASO: nome sem diferenciar maiúsculas, só para o índice de busca)
+typedef enum { CAMPO_NOME, CAMPO_TIPO, CAMPO_PRIORIDADE, CAMPO_NOME_SEM_CASO } CampoOrdenacao;
+#define NUM_CAMPOS 3  // Campos oferecidos nas ordenações e listagens
+#define NUM_INDICES 4 // Treaps mantidas (os campos + nome sem caso)
+
+// -------------------------------
+// ESTRUTURA DE DADOS: ARENA E MOCHILA
+// -------------------------------
+// Arena: bloco único reservado de uma vez; alocações por incremento de ponteiro
+typedef struct {
+    char *base;
+    size_t tamanho;
+    size_t usado;
+    size_t ultimo; // Início da última alocação (a única que pode crescer no lugar)
+} Arena;
+
+// Índices secundários: uma treap por campo, com as posições da mochila como nós
+typedef struct {
+    int raiz[NUM_INDICES];
+    int *esq[NUM_INDICES]; // Filho esquerdo de cada posição, por índice
+    int *dir[NUM_INDICES]; // Filho direito de cada posição, por índice
+    uint32_t *peso;        // Prioridade aleatória da treap (compartilhada pelos índices)
+    int *pilha;            // Caminho do percurso em ordem (reaproveitado pelas consultas)
+    int capacidade;
+} IndicesMochila;
+
+// Tabela hash de nomes: posição de cada componente pelo nome (endereçamento aberto).
+// Uma entrada por nome distinto; os repetidos ficam numa lista duplamente
+// encadeada a partir da posição guardada na entrada.
+typedef struct {
+    uint32_t *hashes; // Hash do nome de cada entrada
+    int *slots;       // Primeira posição com o nome (-1 = entrada vazia)
+    int capacidade;   // Potência de 2
+    int qtd;          // Nomes distintos
+    int *proximo;     // Próxima posição com o mesmo nome (-1 = fim), por posição
+    int *anterior;    // Posição anterior com o mesmo nome (-1 = é a da entrada)
+    int capacidadeCadeias;
+} TabelaNomes;
+
+// Uma rodada do pool, copiada sob a trava por quem vai trabalhar nela
+typedef struct {
+    void (*funcao)(void *contexto, int tarefa);
+    void *contexto;
+    int totalTarefas;
+    unsigned geracao;
+} RodadaPool;
+
+// Pool de threads: executa rodadas de tarefas numeradas (laço paralelo)
+typedef struct {
+    pthread_t *threads;
+    pid_t *tids;               // Id de cada thread auxiliar no kernel (contadores de hardware)
+    int qtdThreads;            // Total de threads, contando a chamadora
+    int iniciadas;             // Auxiliares que já registraram o id
+    pthread_mutex_t trava;
+    pthread_cond_t temTrabalho, terminou;
+    void (*funcao)(void *contexto, int tarefa);
+    void *contexto;
+    int totalTarefas;
+    uint64_t proximaTarefa;    // Geração da rodada (32 bits altos) e próxima tarefa livre
+    int concluidas;
+    unsigned geracao;          // Muda a cada rodada
+    int encerrar;
+} PoolThreads;
+
+// Cabeçalho do arquivo binário (seguido de 'quantidade' registros de Componente)
+typedef struct {
+    char magica[4];            // MAGICA_BINARIO
+    uint32_t versao;
+    uint32_t tamanhoRegistro;  // sizeof(Componente) de quem gravou
+    uint32_t geracao;          // Geração do ponto de verificação (0 = exportação comum)
+    uint64_t quantidade;
+} CabecalhoBinario;
+
+// Cabeçalho do diário de escrita antecipada (seguido de registros RegistroDiario)
+typedef struct {
+    char magica[4];            // MAGICA_DIARIO
+    uint32_t versao;
+    uint32_t tamanhoRegistro;  // sizeof(RegistroDiario) de quem gravou
+    uint32_t geracao;          // Ponto de verificação sobre o qual o diário se aplica
+} CabecalhoDiario;
+
+// Alterações registradas no diário
+typedef enum {
+    DIARIO_ADICIONAR = 1,
+    DIARIO_REMOVER,
+    DIARIO_PRIORIDADE,
+    DIARIO_ORDENAR,   // Ordenação do vetor inteiro (nome do roteiro em componente.nome)
+    DIARIO_MARCAR,    // Posição que sai no próximo descarte em lote
+    DIARIO_COMPACTAR  // Fecha o lote: remove as marcadas (slot = quantas) mantendo a ordem
+} OperacaoDiario;
+
+// Registro de tamanho fixo do diário
+typedef struct {
+    uint32_t operacao;     // OperacaoDiario
+    int32_t slot;          // Posição adicionada, removida, alterada ou marcada
+    Componente componente; // Componente adicionado (ou com a nova prioridade)
+    uint32_t verificacao;  // Soma de verificação dos campos acima (detecta gravação pela metade)
+} RegistroDiario;
+
+// Diário de escrita antecipada: os registros entram no buffer ativo e a thread
+// escritora grava e sincroniza de uma vez tudo o que acumulou (commit em grupo)
+typedef struct {
+    int fd;
+    char diretorio[PATH_MAX];
+    char caminhoDiario[PATH_MAX];
+    char caminhoPonto[PATH_MAX]; // Ponto de verificação (binário da mochila)
+    uint32_t geracao;
+    char *buffer[2];             // Buffer ativo e o que está sendo gravado
+    int ativo;
+    size_t usado;                // Bytes no buffer ativo
+    long long registros;         // Registros no diário atual
+    long long enfileirados;      // Registros entregues à thread escritora (total)
+    long long duraveis;          // Desses, quantos já passaram por fdatasync
+    long long grupos;            // Gravações com fdatasync feitas
+    pthread_t escritor;
+    pthread_mutex_t trava;
+    pthread_cond_t temDados, gravou;
+    int gravando;
+    int urgente;                 // Alguém espera a sincronização: grava sem esperar o grupo
+    int sincrono;                // --wal-sincrono: cada alteração espera o próprio fdatasync
+    int encerrar;
+    int falhou;                  // Erro de gravação: as alterações deixaram de ser duráveis
+    int avisado;
+} DiarioMochila;
+
+// Colunas da mochila (struct-of-arrays) para varreduras vetorizadas
+typedef struct {
+    int *prioridade;       // prioridade[posição]
+    int *qtd;              // qtd[posição]
+    uint32_t *nome;        // Deslocamento do nome de cada posição no pool
+    char *pool;            // Nomes concatenados, terminados em '\0'
+    size_t usadoPool, capacidadePool;
+    size_t desperdicioPool; // Bytes de nomes que já saíram da mochila
+    int capacidade;
+} ColunasMochila;
+
+// Entradas cujo nome contém um trigrama (índice de busca aproximada)
+DEFINIR_VETOR(ListaTrigrama, int)
+
+// Trigrama -> entradas (mapa hash do núcleo comum)
+DEFINIR_MAPA_HASH(MapaTrigramas, uint32_t, ListaTrigrama, hashDeInteiro, inteirosIguais)
+
+// Listas em que uma entrada apareceu na consulta atual
+typedef struct {
+    int consulta; // Consulta a que 'acertos' se refere
+    int acertos;
+} MarcaEntrada;
+
+// Índice de trigramas dos nomes distintos em minúsculas (busca aproximada)
+typedef struct {
+    char (*nome)[TAM_NOME]; // Nome de cada entrada, em minúsculas
+    unsigned char *tamanho; // Comprimento do nome (filtro barato antes da distância)
+    int *vivos;             // Componentes com este nome (0 = lápide)
+    MarcaEntrada *marcas;   // Contagem de listas da consulta atual
+    int *achados;           // Entradas no raio da consulta atual e suas distâncias
+    int *distAchados;       // (reaproveitados entre consultas)
+    int qtd;
+    int capacidade;
+    int lapides;
+    int *hashEntradas;      // Nome -> entrada (-1 = vazio; potência de 2)
+    int capacidadeHash;
+    MapaTrigramas listas;   // Trigrama -> entradas
+    int consulta;           // Número da consulta atual
+    int desatualizada;      // Carga em lote: refazer na próxima consulta
+} IndiceTrigramas;
+
+// Heap de máximo indexado com as posições mais críticas da mochila
+typedef struct {
+    int *heap;     // Posições da mochila em ordem de heap
+    int *posHeap;  // posHeap[posição] = índice no heap (-1 = fora)
+    int qtd;
+    int capacidade;
+} HeapCriticos;
+
+// Resumo de um tipo: componentes, soma das quantidades e histograma das prioridades
+typedef struct {
+    char *tipo;           // Cópia do texto do tipo (também é a chave no mapa)
+    int componentes;
+    long long totalQtd;
+    int porPrioridade[PRIORIDADE_MAX - PRIORIDADE_MIN + 1];
+} ResumoTipo;
+
+// Tipo -> resumo em ordem alfabética (mapa ordenado do núcleo comum)
+DEFINIR_MAPA_ORDENADO(ResumosPorTipo, const char *, ResumoTipo, ordemDeTextos)
+
+// Mochila: vetor dinâmico de componentes. Fica fora do DEFINIR_VETOR do núcleo
+// comum: o vetor pode morar na arena (--arena) e os vetores indexados por posição
+// (índices, colunas e heap) crescem junto com ele em reservarMochila, todos com a
+// mesma capacidade
+typedef struct {
+    Componente *itens;
+    int qtd;        // Quantidade de componentes na mochila
+    int capacidade; // Espaço reservado
+    Arena *arena;   // Arena de apoio (NULL = heap)
+    int naArena;    // 1 se 'itens' está dentro da arena
+    IndicesMochila *indices; // Índices secundários (NULL = desativados)
+    TabelaNomes *tabelaNomes; // Nome -> posição (NULL = desativada)
+    ColunasMochila *colunas;  // Espelho em colunas (NULL = desativado)
+    HeapCriticos *criticos;   // Fila de prioridade (NULL = desativada)
+    IndiceTrigramas *trigramas; // Busca aproximada por nome (NULL = desativada)
+    ResumosPorTipo *resumos;    // Agregado por tipo (NULL = desativado)
+    DiarioMochila *diario;      // Diário de escrita antecipada (NULL = desativado)
+} Mochila;
+
 // -------------------------------
 // VARIÁVEIS GLOBAIS
 // -------------------------------
 // Armazena os componentes adicionados
-Componente mochila[MAX_COMPONENTES];
-int qtdComponentes = 0;       // Quantidade de componentes atualmente na mochila
+Mochila mochila;
+Arena *arenaMochila = NULL;   // Arena opcional (--arena MB)
+FILE *saidaAvisos;            // Mensagens da importação e do diário (stderr no modo roteiro)
 int ordenadoPorNome = 0;      // Flag para indicar se a lista está ordenada por nome
+_Thread_local long long movimentos = 0; // Elementos (componentes ou chaves) gravados pelas ordenações
+
+void reservarMochila(Mochila *m, int capacidade);
+void crescerIndices(Mochila *m, int capacidade);
+void encolherIndices(Mochila *m, int capacidade);
+void indexarSlot(Mochila *m, int slot);
+void desindexarSlot(Mochila *m, int slot);
+void liberarIndices(Mochila *m);
+void liberarTabelaNomes(Mochila *m);
+void crescerColunas(Mochila *m, int capacidade);
+void encolherColunas(Mochila *m, int capacidade);
+void gravarColunas(Mochila *m, int slot);
+void apagarDasColunas(Mochila *m, int slot);
+void liberarColunas(Mochila *m);
+int posicaoMenorPrioridade(const int *p, int n);
+void crescerHeap(Mochila *m, int capacidade);
+void encolherHeap(Mochila *m, int capacidade);
+void inserirNoHeap(Mochila *m, int slot);
+void removerDoHeap(Mochila *m, int slot);
+void reconstruirHeap(Mochila *m);
+void liberarHeap(Mochila *m);
+void somarAoResumo(Mochila *m, int slot);
+void subtrairDoResumo(Mochila *m, int slot);
+void reconstruirResumos(Mochila *m);
+void liberarResumos(Mochila *m);
+void inserirNoIndiceTrigramas(IndiceTrigramas *t, const char *nome);
+void removerDoIndiceTrigramas(IndiceTrigramas *t, const char *nome);
+void liberarIndiceTrigramas(Mochila *m);
+void invalidarIndiceTrigramas(Mochila *m);
+int buscarNaTabelaNomes(const Mochila *m, const char *nome, const unsigned char *marcado);
+int enfileirarAlteracao(Mochila *m, OperacaoDiario operacao, int slot);
+int concluirNoDiario(Mochila *m);
+int sincronizarDiario(DiarioMochila *d);
+int registrarNoDiario(Mochila *m, OperacaoDiario operacao, int slot);
+int registrarOrdenacao(Mochila *m, const char *especificacao);
+int registrarDescarteEmLote(Mochila *m, const unsigned char *marcado, int qtd, int removidos);
+int ordenarPorEspecificacao(Componente lista[], int n, const char *especificacao, char *registro, int *comparacoes);
+int pontoDeVerificacao(Mochila *m);
+void liberarDiario(Mochila *m);
 
 // -------------------------------
 // FUNÇÕES AUXILIARES
@@ -52,6 +351,15 @@ int lerInt() {
     return atoi(linha); // Converte a string lida para inteiro
 }
 
+// Posição da prioridade na faixa válida (0 a PRIORIDADE_MAX - PRIORIDADE_MIN), saturando valores fora dela
+int chavePrioridade(int prioridade) {
+    if (prioridade < PRIORIDADE_MIN)
+        return 0;
+    if (prioridade > PRIORIDADE_MAX)
+        return PRIORIDADE_MAX - PRIORIDADE_MIN;
+    return prioridade - PRIORIDADE_MIN;
+}
+
 // Exibe todos os componentes da mochila de forma formatada
 void mostrarComponentes(Componente lista[], int n) {
     if (n == 0) {
@@ -59,7 +367,7 @@ void mostrarComponentes(Componente lista[], int n) {
         return;
     }
 
-    printf("\n--- INVENTÁRIO DE COMPONENTES (%d/%d) ---\n", n, MAX_COMPONENTES);
+    printf("\n--- INVENTÁRIO DE COMPONENTES (%d itens) ---\n", n);
     printf("-------------------------------------------------------------------------------\n");
     printf("%-25s | %-15s | %-10s | %-5s\n", "NOME", "TIPO", "PRIORIDADE", "QTD");
     printf("-------------------------------------------------------------------------------\n");
@@ -70,6 +378,222 @@ void mostrarComponentes(Componente lista[], int n) {
     printf("-------------------------------------------------------------------------------\n");
 }
 
+// -------------------------------
+// MOCHILA DINÂMICA
+// -------------------------------
+// A mochila cresce sob demanda (dobrando a capacidade, inserção amortizada O(1)).
+// Opcionalmente os itens ficam numa arena pré-reservada: enquanto o vetor for a
+// última alocação da arena, crescer e encolher não copia nada. Quando sobra
+// mais de 3/4 da capacidade, a mochila e os vetores por posição encolhem.
+
+// Aloca memória ou encerra o programa com mensagem de erro
+void *alocar(size_t bytes) {
+    void *p = malloc(bytes > 0 ? bytes : 1);
+    if (p == NULL) {
+        printf("\n❌ Memória insuficiente.\n");
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// Cria uma arena com o tamanho informado (em bytes)
+Arena *criarArena(size_t tamanho) {
+    Arena *arena = alocar(sizeof(Arena));
+    arena->base = alocar(tamanho);
+    arena->tamanho = tamanho;
+    arena->usado = 0;
+    arena->ultimo = 0;
+    return arena;
+}
+
+// Reserva um bloco na arena (NULL se não houver espaço)
+void *arenaAlocar(Arena *arena, size_t bytes) {
+    size_t inicio = (arena->usado + ALINHAMENTO_ARENA - 1) & ~(size_t)(ALINHAMENTO_ARENA - 1);
+    if (inicio > arena->tamanho || bytes > arena->tamanho - inicio)
+        return NULL;
+    arena->ultimo = inicio;
+    arena->usado = inicio + bytes;
+    return arena->base + inicio;
+}
+
+// Redimensiona um bloco da arena: no lugar se for a última alocação, senão copia para um novo
+void *arenaRealocar(Arena *arena, void *bloco, size_t antigo, size_t novo) {
+    if (bloco == arena->base + arena->ultimo && arena->ultimo + novo <= arena->tamanho) {
+        arena->usado = arena->ultimo + novo;
+        return bloco;
+    }
+    void *p = arenaAlocar(arena, novo);
+    if (p != NULL && bloco != NULL)
+        memcpy(p, bloco, antigo < novo ? antigo : novo);
+    return p;
+}
+
+// Libera a arena inteira de uma vez
+void liberarArena(Arena *arena) {
+    if (arena == NULL)
+        return;
+    free(arena->base);
+    free(arena);
+}
+
+// Prepara uma mochila vazia (arena pode ser NULL para usar o heap)
+void iniciarMochila(Mochila *m, int capacidade, Arena *arena) {
+    m->itens = NULL;
+    m->qtd = 0;
+    m->capacidade = 0;
+    m->arena = arena;
+    m->naArena = 0;
+    m->indices = NULL;
+    m->tabelaNomes = NULL;
+    m->colunas = NULL;
+    m->criticos = NULL;
+    m->trigramas = NULL;
+    m->resumos = NULL;
+    m->diario = NULL;
+    reservarMochila(m, capacidade);
+}
+
+// Garante espaço para pelo menos 'capacidade' componentes
+void reservarMochila(Mochila *m, int capacidade) {
+    if (capacidade <= m->capacidade)
+        return;
+
+    size_t bytes = (size_t)capacidade * sizeof(Componente);
+    Componente *novos = NULL;
+
+    // Tenta a arena primeiro (se o vetor ainda não saiu dela)
+    if (m->arena != NULL && (m->itens == NULL || m->naArena))
+        novos = arenaRealocar(m->arena, m->itens, (size_t)m->capacidade * sizeof(Componente), bytes);
+
+    if (novos != NULL) {
+        m->naArena = 1;
+    } else if (m->naArena) { // Arena esgotada: migra para o heap
+        novos = alocar(bytes);
+        memcpy(novos, m->itens, (size_t)m->qtd * sizeof(Componente));
+        m->naArena = 0;
+    } else {
+        novos = realloc(m->itens, bytes);
+        if (novos == NULL) {
+            printf("\n❌ Memória insuficiente.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    m->itens = novos;
+    m->capacidade = capacidade;
+    crescerIndices(m, capacidade);
+    crescerColunas(m, capacidade);
+    crescerHeap(m, capacidade);
+}
+
+// Encolhe um bloco do heap (se o realloc falhar, o bloco antigo continua servindo)
+void *encolherBloco(void *bloco, size_t bytes) {
+    void *novo = realloc(bloco, bytes);
+    return novo != NULL ? novo : bloco;
+}
+
+// Devolve a capacidade além de 'capacidade' (nunca abaixo da quantidade de itens),
+// junto com a dos vetores indexados por posição
+void encolherMochila(Mochila *m, int capacidade) {
+    if (capacidade < m->qtd)
+        capacidade = m->qtd;
+    if (capacidade < 1)
+        capacidade = 1; // Nada de realloc com 0 bytes
+    if (capacidade >= m->capacidade)
+        return;
+
+    size_t bytes = (size_t)capacidade * sizeof(Componente);
+    if (m->naArena) {
+        // Só é possível devolver espaço se o vetor for a última alocação da arena
+        if ((char *)m->itens != m->arena->base + m->arena->ultimo)
+            return;
+        m->arena->usado = m->arena->ultimo + bytes;
+    } else {
+        m->itens = encolherBloco(m->itens, bytes);
+    }
+
+    m->capacidade = capacidade;
+    encolherIndices(m, capacidade);
+    encolherColunas(m, capacidade);
+    encolherHeap(m, capacidade);
+}
+
+// Encolhe a mochila à metade quando menos de 1/4 da capacidade está em uso
+// (a folga evita alternar entre crescer e encolher)
+void aliviarMochila(Mochila *m) {
+    if (m->capacidade > CAPACIDADE_INICIAL && m->qtd < m->capacidade / 4)
+        encolherMochila(m, m->qtd * 2 > CAPACIDADE_INICIAL ? m->qtd * 2 : CAPACIDADE_INICIAL);
+}
+
+// Libera os itens da mochila (a arena, se houver, é liberada à parte)
+void liberarMochila(Mochila *m) {
+    liberarDiario(m); // Antes de tudo: grava o que ainda estiver pendente
+    if (!m->naArena)
+        free(m->itens);
+    liberarIndices(m);
+    liberarTabelaNomes(m);
+    liberarColunas(m);
+    liberarHeap(m);
+    liberarIndiceTrigramas(m);
+    liberarResumos(m);
+    m->itens = NULL;
+    m->qtd = 0;
+    m->capacidade = 0;
+    m->naArena = 0;
+}
+
+// Insere um componente no final da mochila e devolve a posição ocupada
+int anexarComponente(Mochila *m, const Componente *c) {
+    if (m->qtd == m->capacidade) {
+        if (m->capacidade > INT_MAX / 2) {
+            printf("\n❌ Mochila atingiu o limite de componentes.\n");
+            exit(EXIT_FAILURE);
+        }
+        reservarMochila(m, m->capacidade < CAPACIDADE_INICIAL ? CAPACIDADE_INICIAL : m->capacidade * 2);
+    }
+    m->itens[m->qtd] = *c;
+    indexarSlot(m, m->qtd);
+    ordenadoPorNome = 0; // Marca como não ordenado
+    int slot = m->qtd++;
+    registrarNoDiario(m, DIARIO_ADICIONAR, slot);
+    return slot;
+}
+
+// Procura um componente pelo nome (tabela hash, O(1) esperado; sem ela, busca sequencial)
+int posicaoPorNome(const Mochila *m, const char *nome) {
+    if (m->tabelaNomes != NULL)
+        return buscarNaTabelaNomes(m, nome, NULL);
+    for (int i = 0; i < m->qtd; i++)
+        if (strcmp(m->itens[i].nome, nome) == 0)
+            return i;
+    return -1;
+}
+
+// Remove o componente da posição informada: o último componente ocupa a vaga,
+// então só uma posição muda e os índices são atualizados em O(log n)
+void removerComponente(Mochila *m, int posicao) {
+    int ultimo = m->qtd - 1;
+    desindexarSlot(m, posicao);
+    if (posicao != ultimo) {
+        desindexarSlot(m, ultimo);
+        m->itens[posicao] = m->itens[ultimo];
+        indexarSlot(m, posicao);
+        ordenadoPorNome = 0; // A ordem física mudou
+    }
+    m->qtd--;
+    registrarNoDiario(m, DIARIO_REMOVER, posicao);
+    aliviarMochila(m);
+}
+
+// Remove o primeiro componente com o nome informado; devolve 1 se removeu
+int removerComponentePorNome(Mochila *m, const char *nome) {
+    int posicao = posicaoPorNome(m, nome);
+    if (posicao < 0)
+        return 0;
+    removerComponente(m, posicao);
+    return 1;
+}
+
 // -------------------------------
 // FUNÇÕES DE ORDENAÇÃO
 // -------------------------------
@@ -86,6 +610,7 @@ void bubbleSortNome(Componente lista[], int n, int *comparacoes) {
                 temp = lista[j];
                 lista[j] = lista[j + 1];
                 lista[j + 1] = temp; // Troca de posição
+                movimentos += 3;
             }
         }
     }
@@ -104,190 +629,4669 @@ void insertionSortTipo(Componente lista[], int n, int *comparacoes) {
         while (j >= 0 && strcmp(lista[j].tipo, key.tipo) > 0) { // Compara tipos
             (*comparacoes)++;
             lista[j + 1] = lista[j]; // Desloca elemento para a direita
+            movimentos++;
             j--;
         }
         lista[j + 1] = key; // Insere elemento na posição correta
+        movimentos += 2;
     }
     ordenadoPorNome = 0; // Ordenação não é por nome
 }
 
 // Selection Sort -> Ordena por prioridade (menor para maior)
+// A busca do mínimo varre uma coluna só com as prioridades (kernel SIMD) em vez
+// dos componentes inteiros; as escolhas e a contagem de comparações são as mesmas.
 void selectionSortPrioridade(Componente lista[], int n, int *comparacoes) {
     int minIndex;
     Componente temp;
+    int *prioridades = alocar((size_t)(n > 0 ? n : 1) * sizeof(int));
     *comparacoes = 0;
 
+    for (int i = 0; i < n; i++)
+        prioridades[i] = lista[i].prioridade;
+
     for (int i = 0; i < n - 1; i++) {
-        minIndex = i;
-        for (int j = i + 1; j < n; j++) {
-            (*comparacoes)++;
-            if (lista[j].prioridade < lista[minIndex].prioridade)
-                minIndex = j; // Encontra menor prioridade
-        }
+        minIndex = i + posicaoMenorPrioridade(prioridades + i, n - i); // Encontra menor prioridade
+        *comparacoes += n - 1 - i;
         temp = lista[i];
         lista[i] = lista[minIndex];
         lista[minIndex] = temp; // Troca posições
+        prioridades[minIndex] = temp.prioridade; // A coluna acompanha a troca
+        prioridades[i] = lista[i].prioridade;
+        movimentos += 3;
     }
+    free(prioridades);
     ordenadoPorNome = 0; // Ordenação não é por nome
 }
 
 // -------------------------------
-// BUSCA BINÁRIA (por nome)
+// ORDENAÇÃO RÁPIDA (O(n log n) E LINEAR)
 // -------------------------------
-int buscaBinariaPorNome(Componente lista[], int n, char nomeBusca[]) {
-    if (!ordenadoPorNome) { // Verifica se a lista está ordenada
-        printf("\n⚠️ A busca binária requer que a mochila esteja ordenada por NOME.\n");
-        return -1;
-    }
+// Os métodos abaixo não trocam os componentes durante a ordenação: ordenam um
+// vetor compacto de chaves (os 16 primeiros bytes do campo + índice do componente)
+// e, no final, copiam cada componente uma única vez para a posição definitiva.
+// Os contadores de comparações continuam valendo para a análise de desempenho.
 
-    int inicio = 0, fim = n - 1, meio;
-    int comparacoes = 0;
+// Chave compacta: prefixo do campo em big-endian (compara como inteiros) + posição do componente
+typedef struct {
+    uint64_t prefixo[2];
+    int indice;
+} ChaveOrdem;
 
-    while (inicio <= fim) {
-        meio = (inicio + fim) / 2;
-        comparacoes++;
-        int resultado = strcmp(lista[meio].nome, nomeBusca);
-        if (resultado == 0) { // Encontrou componente
-            printf("\n✅ Componente encontrado!\n");
-            printf("Nome: %s\nTipo: %s\nPrioridade: %d\nQuantidade: %d\n",
-                   lista[meio].nome, lista[meio].tipo, lista[meio].prioridade, lista[meio].qtd);
-            printf("🔍 Comparações realizadas: %d\n", comparacoes);
-            return meio;
-        } else if (resultado < 0) {
-            inicio = meio + 1; // Busca na metade direita
-        } else {
-            fim = meio - 1;    // Busca na metade esquerda
-        }
-    }
+// Tempo monotônico em milissegundos (para exibir a duração das ordenações)
+double tempoMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
 
-    printf("\n❌ Componente não encontrado.\n");
-    return -1;
+// Texto do campo (NULL para campos numéricos)
+const char *textoCampo(const Componente *c, CampoOrdenacao campo) {
+    if (campo == CAMPO_NOME || campo == CAMPO_NOME_SEM_CASO) return c->nome;
+    if (campo == CAMPO_TIPO) return c->tipo;
+    return NULL;
 }
 
-// -------------------------------
-// CRUD DE COMPONENTES
-// -------------------------------
+// Empacota os 16 primeiros bytes de uma string em duas palavras (zeros após o '\0');
+// semCaso compara em minúsculas, como strcasecmp
+void prefixoTexto(const char *s, uint64_t prefixo[2], int semCaso) {
+    int i = 0;
+    prefixo[0] = prefixo[1] = 0;
+    for (; i < 16 && s[i] != '\0'; i++) {
+        unsigned char c = (unsigned char)s[i];
+        prefixo[i / 8] |= (uint64_t)(semCaso ? tolower(c) : c) << (56 - 8 * (i % 8));
+    }
+}
 
-// Adiciona um componente à mochila
-void adicionarComponente() {
-    if (qtdComponentes >= MAX_COMPONENTES) { // Verifica limite
-        printf("\n⚠️ Mochila cheia! Não é possível adicionar mais componentes.\n");
-        return;
+// Preenche as chaves das posições [inicio, fim)
+void preencherChaves(const Componente lista[], ChaveOrdem chaves[], int inicio, int fim, CampoOrdenacao campo) {
+    for (int i = inicio; i < fim; i++) {
+        const char *texto = textoCampo(&lista[i], campo);
+        if (texto) {
+            prefixoTexto(texto, chaves[i].prefixo, campo == CAMPO_NOME_SEM_CASO);
+        } else { // Prioridade: desloca o sinal para comparar como sem sinal; byte final zero = chave completa
+            chaves[i].prefixo[0] = (uint64_t)((uint32_t)lista[i].prioridade ^ 0x80000000u) << 32;
+            chaves[i].prefixo[1] = 0;
+        }
+        chaves[i].indice = i;
     }
+}
 
-    Componente novo;
-    printf("\n--- Coletando Novo Componente ---\n");
-    printf("Nome do componente: ");
-    lerString(novo.nome, TAM_NOME);
-    printf("Tipo do componente (Estrutural, Eletronico, Energia): ");
-    lerString(novo.tipo, TAM_TIPO);
-    printf("Quantidade: ");
-    novo.qtd = lerInt();
-    printf("Prioridade (1 a 5): ");
-    novo.prioridade = lerInt();
+// Monta o vetor de chaves na ordem atual da lista
+ChaveOrdem *criarChaves(const Componente lista[], int n, CampoOrdenacao campo) {
+    ChaveOrdem *chaves = alocar((size_t)n * sizeof(ChaveOrdem));
+    preencherChaves(lista, chaves, 0, n, campo);
+    return chaves;
+}
 
-    mochila[qtdComponentes++] = novo; // Adiciona à mochila
-    ordenadoPorNome = 0;             // Marca como não ordenado
+// Compara duas chaves; só consulta o componente quando os 16 primeiros bytes empatam
+int compararChaves(const Componente lista[], CampoOrdenacao campo,
+                   const ChaveOrdem *a, const ChaveOrdem *b, int *comparacoes) {
+    (*comparacoes)++;
+    if (a->prefixo[0] != b->prefixo[0])
+        return a->prefixo[0] < b->prefixo[0] ? -1 : 1;
+    if (a->prefixo[1] != b->prefixo[1])
+        return a->prefixo[1] < b->prefixo[1] ? -1 : 1;
+    if ((a->prefixo[1] & 0xFF) == 0) // Texto terminou dentro do prefixo: chaves iguais
+        return 0;
+    const char *x = textoCampo(&lista[a->indice], campo) + 16, *y = textoCampo(&lista[b->indice], campo) + 16;
+    return campo == CAMPO_NOME_SEM_CASO ? strcasecmp(x, y) : strcmp(x, y);
+}
 
-    printf("\n✅ Componente \"%s\" adicionado com sucesso!\n", novo.nome);
+// Reorganiza a lista conforme as chaves ordenadas (cada componente é movido uma vez)
+void aplicarOrdem(Componente lista[], const ChaveOrdem chaves[], int n) {
+    Componente *copia = alocar((size_t)n * sizeof(Componente));
+    for (int i = 0; i < n; i++)
+        copia[i] = lista[chaves[i].indice];
+    memcpy(lista, copia, (size_t)n * sizeof(Componente));
+    movimentos += 2LL * n;
+    free(copia);
 }
 
-// Remove um componente da mochila pelo nome
-void descartarComponente() {
-    if (qtdComponentes == 0) {
-        printf("\n⚠️ Mochila vazia! Nenhum componente para remover.\n");
+// Insertion Sort sobre chaves (usado nos trechos pequenos dos métodos rápidos)
+void insertionSortChaves(const Componente lista[], ChaveOrdem v[], int n,
+                         CampoOrdenacao campo, int *comparacoes) {
+    for (int i = 1; i < n; i++) {
+        ChaveOrdem chave = v[i];
+        int j = i - 1;
+        while (j >= 0 && compararChaves(lista, campo, &v[j], &chave, comparacoes) > 0) {
+            v[j + 1] = v[j];
+            movimentos++;
+            j--;
+        }
+        v[j + 1] = chave;
+        movimentos += 2;
+    }
+}
+
+// Merge Sort (estável) sobre chaves; aux deve ter n posições
+void mergeSortChaves(const Componente lista[], ChaveOrdem v[], ChaveOrdem aux[], int n,
+                     CampoOrdenacao campo, int *comparacoes) {
+    if (n <= LIMIAR_INSERCAO) {
+        insertionSortChaves(lista, v, n, campo, comparacoes);
         return;
     }
+    int meio = n / 2;
+    mergeSortChaves(lista, v, aux, meio, campo, comparacoes);
+    mergeSortChaves(lista, v + meio, aux, n - meio, campo, comparacoes);
 
-    char nomeBusca[TAM_NOME];
-    printf("\n--- DESCARTAR COMPONENTE ---\n");
-    printf("Informe o nome do componente: ");
-    lerString(nomeBusca, TAM_NOME);
+    // Metades já em ordem: nada a intercalar
+    if (compararChaves(lista, campo, &v[meio - 1], &v[meio], comparacoes) <= 0)
+        return;
+
+    int i = 0, j = meio, k = 0;
+    while (i < meio && j < n) {
+        if (compararChaves(lista, campo, &v[j], &v[i], comparacoes) < 0) // Empate fica com a esquerda
+            aux[k++] = v[j++];
+        else
+            aux[k++] = v[i++];
+    }
+    while (i < meio)
+        aux[k++] = v[i++];
+    // O restante da direita já está no lugar
+    memcpy(v, aux, (size_t)k * sizeof(ChaveOrdem));
+    movimentos += 2LL * k;
+}
 
-    for (int i = 0; i < qtdComponentes; i++) {
-        if (strcmp(mochila[i].nome, nomeBusca) == 0) { // Encontrou
-            for (int j = i; j < qtdComponentes - 1; j++)
-                mochila[j] = mochila[j + 1]; // Desloca os elementos
-            qtdComponentes--;
-            printf("\n🗑️ Componente '%s' descartado!\n", nomeBusca);
+// Heap Sort sobre chaves (fallback do Introsort quando a recursão fica profunda demais)
+void heapSortChaves(const Componente lista[], ChaveOrdem v[], int n,
+                    CampoOrdenacao campo, int *comparacoes) {
+    for (int inicio = n / 2 - 1, fim = n; fim > 1;) {
+        int raiz;
+        if (inicio >= 0) {
+            raiz = inicio--; // Fase 1: constrói o heap de máximo
+        } else {
+            ChaveOrdem temp = v[0]; // Fase 2: move o máximo para o fim
+            v[0] = v[--fim];
+            v[fim] = temp;
+            movimentos += 3;
+            raiz = 0;
+        }
+        while (2 * raiz + 1 < fim) {
+            int filho = 2 * raiz + 1;
+            if (filho + 1 < fim && compararChaves(lista, campo, &v[filho + 1], &v[filho], comparacoes) > 0)
+                filho++;
+            if (compararChaves(lista, campo, &v[filho], &v[raiz], comparacoes) <= 0)
+                break;
+            ChaveOrdem temp = v[raiz];
+            v[raiz] = v[filho];
+            v[filho] = temp;
+            movimentos += 3;
+            raiz = filho;
+        }
+    }
+}
+
+// Introsort sobre chaves: Quicksort com mediana de três, Heap Sort ao esgotar a
+// profundidade e Insertion Sort nos trechos pequenos. Não é estável.
+void introSortChaves(const Componente lista[], ChaveOrdem v[], int n, int profundidade,
+                     CampoOrdenacao campo, int *comparacoes) {
+    while (n > LIMIAR_INSERCAO) {
+        if (profundidade-- == 0) {
+            heapSortChaves(lista, v, n, campo, comparacoes);
             return;
         }
+
+        // Mediana de três (início, meio, fim) como pivô
+        ChaveOrdem *a = &v[0], *b = &v[n / 2], *c = &v[n - 1], *med;
+        if (compararChaves(lista, campo, a, b, comparacoes) < 0) {
+            if (compararChaves(lista, campo, b, c, comparacoes) < 0)
+                med = b;
+            else
+                med = compararChaves(lista, campo, a, c, comparacoes) < 0 ? c : a;
+        } else {
+            if (compararChaves(lista, campo, a, c, comparacoes) < 0)
+                med = a;
+            else
+                med = compararChaves(lista, campo, b, c, comparacoes) < 0 ? c : b;
+        }
+        ChaveOrdem pivo = *med;
+
+        // Partição de Hoare
+        int i = -1, j = n;
+        while (1) {
+            do i++; while (compararChaves(lista, campo, &v[i], &pivo, comparacoes) < 0);
+            do j--; while (compararChaves(lista, campo, &v[j], &pivo, comparacoes) > 0);
+            if (i >= j)
+                break;
+            ChaveOrdem temp = v[i];
+            v[i] = v[j];
+            v[j] = temp;
+            movimentos += 3;
+        }
+
+        // Recursão no lado menor, laço no maior (pilha O(log n))
+        int esquerda = j + 1;
+        if (esquerda < n - esquerda) {
+            introSortChaves(lista, v, esquerda, profundidade, campo, comparacoes);
+            v += esquerda;
+            n -= esquerda;
+        } else {
+            introSortChaves(lista, v + esquerda, n - esquerda, profundidade, campo, comparacoes);
+            n = esquerda;
+        }
     }
-    printf("\n❌ Componente não encontrado.\n");
+    insertionSortChaves(lista, v, n, campo, comparacoes);
 }
 
-// -------------------------------
-// MENU PRINCIPAL
-// -------------------------------
-void menu() {
-    int opcao, comparacoes;
+// Profundidade máxima do Introsort: 2 * log2(n)
+int profundidadeIntroSort(int n) {
+    int profundidade = 0;
+    while (n > 1) {
+        n >>= 1;
+        profundidade += 2;
+    }
+    return profundidade;
+}
 
-    do {
-        printf("\n==================================================================\n");
-        printf("PLANO DE FUGA – CODIGO DA ILHA (NIVEL MESTRE)\n");
-        printf("==================================================================\n");
-        printf("Itens na Mochila: %d/%d\n", qtdComponentes, MAX_COMPONENTES);
-        printf("Status da ordenação por nome: %s\n\n", ordenadoPorNome ? "ORDENADO" : "NAO ORDENADO");
-        printf("1. Adicionar Componente\n");
-        printf("2. Descartar Componente\n");
-        printf("3. Listar Componentes (Inventario)\n");
-        printf("4. Organizar Mochila (Ordenar componentes)\n");
-        printf("5. Busca Binaria por componente-chave (por nome)\n");
-        printf("0. ATIVAR TORRE DE FUGA (Sair)\n");
-        printf("-------------------------------------------------------------------\n");
-        printf("Escolha uma opção: ");
-        opcao = lerInt();
+// Caractere d do nome (os 16 primeiros vêm do prefixo, sem tocar no componente)
+unsigned char caractereNome(const Componente lista[], const ChaveOrdem *chave, int d) {
+    if (d < 16)
+        return (unsigned char)(chave->prefixo[d / 8] >> (56 - 8 * (d % 8)));
+    return (unsigned char)lista[chave->indice].nome[d];
+}
 
-        switch (opcao) {
-            case 1: adicionarComponente(); break;
-            case 2: descartarComponente(); break;
-            case 3: mostrarComponentes(mochila, qtdComponentes); break;
+// Radix Sort MSD por nome: distribui pelo caractere d e ordena cada balde pelo próximo.
+// O contador soma os caracteres inspecionados na distribuição e as comparações dos trechos pequenos.
+void radixMSDChaves(const Componente lista[], ChaveOrdem v[], ChaveOrdem aux[], int n, int d, int *comparacoes) {
+    if (n <= LIMIAR_INSERCAO || d >= TAM_NOME - 1) {
+        insertionSortChaves(lista, v, n, CAMPO_NOME, comparacoes);
+        return;
+    }
 
-            case 4: {
-                int escolha;
-                printf("\nEscolha o método de ordenação:\n");
-                printf("1. Bubble Sort (por nome)\n");
-                printf("2. Insertion Sort (por tipo)\n");
-                printf("3. Selection Sort (por prioridade)\n");
-                printf("Opção: ");
-                escolha = lerInt();
+    int contagem[257] = {0}; // Balde 0: nomes que terminaram antes do caractere d
+    for (int i = 0; i < n; i++)
+        contagem[caractereNome(lista, &v[i], d) + 1]++;
+    *comparacoes += n;
+    for (int c = 0; c < 256; c++)
+        contagem[c + 1] += contagem[c];
 
-                switch (escolha) {
-                    case 1: bubbleSortNome(mochila, qtdComponentes, &comparacoes); break;
-                    case 2: insertionSortTipo(mochila, qtdComponentes, &comparacoes); break;
-                    case 3: selectionSortPrioridade(mochila, qtdComponentes, &comparacoes); break;
-                    default: printf("\n❌ Opção inválida.\n");
-                }
-                break;
-            }
+    int inicio[256];
+    memcpy(inicio, contagem, sizeof(inicio));
+    for (int i = 0; i < n; i++)
+        aux[inicio[caractereNome(lista, &v[i], d)]++] = v[i];
+    memcpy(v, aux, (size_t)n * sizeof(ChaveOrdem));
+    movimentos += 2LL * n;
 
-            case 5: {
-                if (!ordenadoPorNome) { // Busca binária exige ordenação
-                    printf("\nALERTA: A busca binaria requer que a mochila esteja ordenada por NOME.\n");
-                    printf("Use a opção 4 para organizar a mochila primeiro\n\n");
-                    printf("Pressione Enter para continuar...");
-                    char tmp[4];
-                    fgets(tmp, sizeof(tmp), stdin);
-                    break;
-                }
-                char nomeBusca[TAM_NOME];
-                printf("\nDigite o nome do componente-chave: ");
-                lerString(nomeBusca, TAM_NOME);
-                buscaBinariaPorNome(mochila, qtdComponentes, nomeBusca);
-                break;
-            }
+    // O balde 0 já está resolvido (nomes idênticos até aqui)
+    for (int c = 1; c < 256; c++) {
+        int tamanho = contagem[c + 1] - contagem[c];
+        if (tamanho > 1)
+            radixMSDChaves(lista, v + contagem[c], aux, tamanho, d + 1, comparacoes);
+    }
+}
 
-            case 0: printf("\n🚀 Torre de Fuga ativada! Missão concluída.\n"); break;
-            default: printf("\n❌ Opção inválida! Tente novamente.\n");
-        }
+// Merge Sort -> Ordena por nome (estável, O(n log n))
+void mergeSortNome(Componente lista[], int n, int *comparacoes) {
+    ChaveOrdem *chaves = criarChaves(lista, n, CAMPO_NOME);
+    ChaveOrdem *aux = alocar((size_t)n * sizeof(ChaveOrdem));
+    *comparacoes = 0;
+    mergeSortChaves(lista, chaves, aux, n, CAMPO_NOME, comparacoes);
+    aplicarOrdem(lista, chaves, n);
+    free(chaves);
+    free(aux);
+    ordenadoPorNome = 1; // Marca como ordenado por nome
+}
 
-    } while (opcao != 0);
+// Introsort -> Ordena por tipo (O(n log n) no pior caso)
+void introSortTipo(Componente lista[], int n, int *comparacoes) {
+    ChaveOrdem *chaves = criarChaves(lista, n, CAMPO_TIPO);
+    *comparacoes = 0;
+    introSortChaves(lista, chaves, n, profundidadeIntroSort(n), CAMPO_TIPO, comparacoes);
+    aplicarOrdem(lista, chaves, n);
+    free(chaves);
+    ordenadoPorNome = 0; // Ordenação não é por nome
+}
+
+// Counting Sort -> Ordena por prioridade (estável, O(n + 5), sem comparações)
+void countingSortPrioridade(Componente lista[], int n, int *comparacoes) {
+    int contagem[PRIORIDADE_MAX - PRIORIDADE_MIN + 2] = {0};
+    Componente *copia = alocar((size_t)n * sizeof(Componente));
+    *comparacoes = 0;
+
+    for (int i = 0; i < n; i++)
+        contagem[chavePrioridade(lista[i].prioridade) + 1]++;
+    for (int p = 0; p < PRIORIDADE_MAX - PRIORIDADE_MIN + 1; p++)
+        contagem[p + 1] += contagem[p];
+    for (int i = 0; i < n; i++)
+        copia[contagem[chavePrioridade(lista[i].prioridade)]++] = lista[i];
+
+    memcpy(lista, copia, (size_t)n * sizeof(Componente));
+    movimentos += 2LL * n;
+    free(copia);
+    ordenadoPorNome = 0; // Ordenação não é por nome
+}
+
+// Radix Sort MSD -> Ordena por nome (linear no total de caracteres distintivos)
+void radixSortNome(Componente lista[], int n, int *comparacoes) {
+    ChaveOrdem *chaves = criarChaves(lista, n, CAMPO_NOME);
+    ChaveOrdem *aux = alocar((size_t)n * sizeof(ChaveOrdem));
+    *comparacoes = 0;
+    radixMSDChaves(lista, chaves, aux, n, 0, comparacoes);
+    aplicarOrdem(lista, chaves, n);
+    free(chaves);
+    free(aux);
+    ordenadoPorNome = 1; // Marca como ordenado por nome
 }
 
 // -------------------------------
-// FUNÇÃO PRINCIPAL
+// ORDENAÇÃO COMPOSTA (várias colunas)
 // -------------------------------
-int main() {
-    menu(); // Inicia o menu principal
-    return 0;
+// As colunas, na ordem pedida, viram uma sequência de bytes: texto seguido de
+// '\0' (o texto mais curto vem antes) e prioridade em 4 bytes big-endian com o
+// sinal deslocado; colunas decrescentes têm os bytes invertidos. Comparar as
+// sequências com memcmp equivale a comparar as colunas. Cada componente guarda
+// uma janela de TAM_CHAVE_COMPOSTA bytes da sequência e o Radix Sort MSD ordena
+// por byte; um balde que esgota a janela sem desempatar recebe a janela
+// seguinte e continua, então os campos nunca são comparados diretamente
+// (exceto nos trechos pequenos do Insertion Sort). A distribuição é estável:
+// empates mantêm a ordem anterior.
+
+// Colunas da ordem composta
+typedef struct {
+    CampoOrdenacao campo[NUM_CAMPOS];
+    int decrescente[NUM_CAMPOS];
+    int colunas;
+} OrdemComposta;
+
+// Chave normalizada + posição do componente
+typedef struct {
+    uint8_t bytes[TAM_CHAVE_COMPOSTA];
+    uint8_t completa; // A sequência do componente termina dentro desta janela
+    int indice;
+} ChaveComposta;
+
+// Interpreta a ordem no formato "tpn" (t = tipo, p = prioridade, n = nome;
+// '-' antes da letra = decrescente). Devolve 0 se for inválida.
+int interpretarOrdemComposta(const char *texto, OrdemComposta *ordem) {
+    int usado[NUM_CAMPOS] = {0}, decrescente = 0;
+    ordem->colunas = 0;
+    for (; *texto; texto++) {
+        char c = (char)tolower((unsigned char)*texto);
+        if (c == ' ' || c == ',')
+            continue;
+        if (c == '-') {
+            decrescente = 1;
+            continue;
+        }
+        CampoOrdenacao campo;
+        if (c == 'n') campo = CAMPO_NOME;
+        else if (c == 't') campo = CAMPO_TIPO;
+        else if (c == 'p') campo = CAMPO_PRIORIDADE;
+        else return 0;
+        if (usado[campo])
+            return 0;
+        usado[campo] = 1;
+        ordem->campo[ordem->colunas] = campo;
+        ordem->decrescente[ordem->colunas++] = decrescente;
+        decrescente = 0;
+    }
+    return ordem->colunas > 0 && !decrescente;
+}
+
+// Escreve a ordem na forma curta que interpretarOrdemComposta lê ("t-pn"); 'destino'
+// precisa de 2 * NUM_CAMPOS + 1 bytes
+void descreverOrdemComposta(const OrdemComposta *ordem, char *destino) {
+    static const char letras[NUM_CAMPOS] = {'n', 't', 'p'};
+    for (int k = 0; k < ordem->colunas; k++) {
+        if (ordem->decrescente[k])
+            *destino++ = '-';
+        *destino++ = letras[ordem->campo[k]];
+    }
+    *destino = '\0';
+}
+
+// Grava a janela [deslocamento, deslocamento + TAM_CHAVE_COMPOSTA) da sequência
+// de bytes do componente (zeros depois do fim) e diz se a sequência acaba nela
+int montarChaveComposta(const Componente *c, const OrdemComposta *ordem, int deslocamento,
+                        uint8_t bytes[TAM_CHAVE_COMPOSTA]) {
+    int pos = 0, fim = deslocamento + TAM_CHAVE_COMPOSTA;
+    memset(bytes, 0, TAM_CHAVE_COMPOSTA);
+    for (int k = 0; k < ordem->colunas; k++) {
+        uint8_t inverter = ordem->decrescente[k] ? 0xFF : 0x00;
+        if (ordem->campo[k] == CAMPO_PRIORIDADE) {
+            uint32_t valor = (uint32_t)c->prioridade ^ 0x80000000u;
+            for (int b = 3; b >= 0; b--, pos++)
+                if (pos >= deslocamento && pos < fim)
+                    bytes[pos - deslocamento] = (uint8_t)(valor >> (8 * b)) ^ inverter;
+        } else {
+            const char *s = textoCampo(c, ordem->campo[k]);
+            int tamanho = (int)strlen(s) + 1; // Com o '\0'
+            for (int i = deslocamento > pos ? deslocamento - pos : 0; i < tamanho && pos + i < fim; i++)
+                bytes[pos + i - deslocamento] = (uint8_t)s[i] ^ inverter;
+            pos += tamanho;
+        }
+    }
+    return pos <= fim;
+}
+
+// Compara dois componentes coluna a coluna, pelos campos completos
+int compararColunas(const Componente *x, const Componente *y, const OrdemComposta *ordem) {
+    for (int k = 0; k < ordem->colunas; k++) {
+        int r;
+        if (ordem->campo[k] == CAMPO_PRIORIDADE)
+            r = (x->prioridade > y->prioridade) - (x->prioridade < y->prioridade);
+        else
+            r = strcmp(textoCampo(x, ordem->campo[k]), textoCampo(y, ordem->campo[k]));
+        if (r != 0)
+            return ordem->decrescente[k] ? -r : r;
+    }
+    return 0;
+}
+
+// Compara duas chaves a partir do byte d (os anteriores já são iguais); empate em
+// janelas que não encerram a sequência vai aos campos
+int compararChavesCompostas(const Componente lista[], const OrdemComposta *ordem,
+                            const ChaveComposta *a, const ChaveComposta *b, int d, int *comparacoes) {
+    (*comparacoes)++;
+    int r = memcmp(a->bytes + d, b->bytes + d, TAM_CHAVE_COMPOSTA - d);
+    if (r != 0 || (a->completa && b->completa))
+        return r;
+    return compararColunas(&lista[a->indice], &lista[b->indice], ordem);
+}
+
+// Insertion Sort das chaves que já empatam até o byte d
+void insertionSortComposto(const Componente lista[], const OrdemComposta *ordem, ChaveComposta v[], int n,
+                           int d, int *comparacoes) {
+    for (int i = 1; i < n; i++) {
+        ChaveComposta chave = v[i];
+        int j = i - 1;
+        while (j >= 0 && compararChavesCompostas(lista, ordem, &v[j], &chave, d, comparacoes) > 0) {
+            v[j + 1] = v[j];
+            movimentos++;
+            j--;
+        }
+        v[j + 1] = chave;
+        movimentos += 2;
+    }
+}
+
+// Radix Sort MSD pelos bytes da janela 'deslocamento' a partir do byte d
+void radixComposto(const Componente lista[], const OrdemComposta *ordem, ChaveComposta v[], ChaveComposta aux[],
+                   int n, int deslocamento, int d, int *comparacoes) {
+    int contagem[257];
+    for (;; d++) {
+        if (n <= LIMIAR_INSERCAO) {
+            insertionSortComposto(lista, ordem, v, n, d, comparacoes);
+            return;
+        }
+        if (d == TAM_CHAVE_COMPOSTA) { // Janelas idênticas: iguais se todas acabaram, senão próxima janela
+            int completas = 1;
+            for (int i = 0; i < n && completas; i++)
+                completas = v[i].completa;
+            if (completas)
+                return;
+            deslocamento += TAM_CHAVE_COMPOSTA;
+            for (int i = 0; i < n; i++)
+                v[i].completa = (uint8_t)montarChaveComposta(&lista[v[i].indice], ordem, deslocamento, v[i].bytes);
+            d = 0;
+        }
+        memset(contagem, 0, sizeof(contagem));
+        for (int i = 0; i < n; i++)
+            contagem[v[i].bytes[d] + 1]++;
+        *comparacoes += n;
+        if (contagem[v[0].bytes[d] + 1] < n)
+            break; // Há mais de um balde neste byte
+        // Todos com o mesmo byte: segue para o próximo sem mover nada
+    }
+
+    for (int c = 0; c < 256; c++)
+        contagem[c + 1] += contagem[c];
+    int inicio[256];
+    memcpy(inicio, contagem, sizeof(inicio));
+    for (int i = 0; i < n; i++)
+        aux[inicio[v[i].bytes[d]]++] = v[i];
+    memcpy(v, aux, (size_t)n * sizeof(ChaveComposta));
+    movimentos += 2LL * n;
+
+    for (int c = 0; c < 256; c++) {
+        int tamanho = contagem[c + 1] - contagem[c];
+        if (tamanho > 1)
+            radixComposto(lista, ordem, v + contagem[c], aux, tamanho, deslocamento, d + 1, comparacoes);
+    }
+}
+
+// Ordena a lista pela ordem composta (estável)
+void ordenarComposto(Componente lista[], int n, const OrdemComposta *ordem, int *comparacoes) {
+    ChaveComposta *chaves = alocar((size_t)(n > 0 ? n : 1) * sizeof(ChaveComposta));
+    ChaveComposta *aux = alocar((size_t)(n > 0 ? n : 1) * sizeof(ChaveComposta));
+    for (int i = 0; i < n; i++) {
+        chaves[i].completa = (uint8_t)montarChaveComposta(&lista[i], ordem, 0, chaves[i].bytes);
+        chaves[i].indice = i;
+    }
+    *comparacoes = 0;
+    radixComposto(lista, ordem, chaves, aux, n, 0, 0, comparacoes);
+
+    Componente *copia = alocar((size_t)(n > 0 ? n : 1) * sizeof(Componente));
+    for (int i = 0; i < n; i++)
+        copia[i] = lista[chaves[i].indice];
+    memcpy(lista, copia, (size_t)n * sizeof(Componente));
+    movimentos += 2LL * n;
+    free(copia);
+    free(chaves);
+    free(aux);
+    // Nome crescente como primeira coluna deixa o vetor pronto para a busca binária
+    ordenadoPorNome = ordem->campo[0] == CAMPO_NOME && !ordem->decrescente[0];
+}
+
+// Tipo, prioridade e nome (usada no benchmark)
+void compostaTipoPrioridadeNome(Componente lista[], int n, int *comparacoes) {
+    OrdemComposta ordem;
+    interpretarOrdemComposta("tpn", &ordem);
+    ordenarComposto(lista, n, &ordem, comparacoes);
+}
+
+// -------------------------------
+// ORDENAÇÃO PARALELA (Merge Sort em pool de threads)
+// -------------------------------
+// O vetor de chaves é dividido em um bloco por thread, cada bloco é ordenado
+// com o Merge Sort serial e os blocos são intercalados aos pares. Cada
+// intercalação é repartida entre as threads por busca binária (co-ranking),
+// então todas trabalham até a última rodada. Abaixo de LIMIAR_PARALELO
+// componentes, ou com uma única thread, cai no caminho serial.
+
+PoolThreads *poolOrdenacao = NULL; // Criado sob demanda
+int threadsOrdenacao = 0;          // 0 = número de núcleos disponíveis (--threads N)
+
+// Número de threads efetivo para as ordenações paralelas
+int threadsConfiguradas() {
+    if (threadsOrdenacao > 0)
+        return threadsOrdenacao < MAX_THREADS ? threadsOrdenacao : MAX_THREADS;
+    long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+    return nucleos > 0 ? (int)(nucleos < MAX_THREADS ? nucleos : MAX_THREADS) : 1;
+}
+
+// Copia a rodada atual (chamada com a trava do pool)
+RodadaPool rodadaAtual(const PoolThreads *pool) {
+    RodadaPool rodada = { pool->funcao, pool->contexto, pool->totalTarefas, pool->geracao };
+    return rodada;
+}
+
+// Processa tarefas da rodada copiada até acabarem; devolve quantas executou. A
+// geração vai junto do contador, então quem acordar atrasado não pega tarefas
+// de uma rodada posterior com a função e o contexto da anterior.
+int consumirTarefas(PoolThreads *pool, const RodadaPool *rodada) {
+    int feitas = 0;
+    uint64_t atual = __atomic_load_n(&pool->proximaTarefa, __ATOMIC_ACQUIRE);
+    while ((uint32_t)(atual >> 32) == rodada->geracao && (int)(uint32_t)atual < rodada->totalTarefas) {
+        if (!__atomic_compare_exchange_n(&pool->proximaTarefa, &atual, atual + 1, 1, __ATOMIC_ACQ_REL,
+                                         __ATOMIC_ACQUIRE))
+            continue; // Outra thread pegou essa tarefa; 'atual' já tem o valor novo
+        TELEMETRIA_INICIO(marcaTarefa);
+        rodada->funcao(rodada->contexto, (int)(uint32_t)atual);
+        TELEMETRIA_FIM(marcaTarefa, "pool.tarefa");
+        feitas++;
+        atual = __atomic_load_n(&pool->proximaTarefa, __ATOMIC_ACQUIRE);
+    }
+    return feitas;
+}
+
+// Laço das threads auxiliares: esperam uma nova rodada e ajudam a consumi-la
+void *trabalhadorPool(void *arg) {
+    PoolThreads *pool = arg;
+    unsigned vista = 0;
+    pthread_mutex_lock(&pool->trava);
+#ifdef __linux__
+    pool->tids[++pool->iniciadas] = (pid_t)syscall(SYS_gettid);
+#else
+    pool->iniciadas++;
+#endif
+    pthread_cond_signal(&pool->terminou);
+    while (1) {
+        while (pool->geracao == vista && !pool->encerrar)
+            pthread_cond_wait(&pool->temTrabalho, &pool->trava);
+        if (pool->encerrar)
+            break;
+        vista = pool->geracao;
+        RodadaPool rodada = rodadaAtual(pool);
+        pthread_mutex_unlock(&pool->trava);
+
+        int feitas = consumirTarefas(pool, &rodada);
+
+        pthread_mutex_lock(&pool->trava);
+        // Tarefas pegas seguram a rodada aberta, então ela ainda é a atual
+        pool->concluidas += feitas;
+        if (feitas > 0 && pool->concluidas == pool->totalTarefas)
+            pthread_cond_signal(&pool->terminou);
+    }
+    pthread_mutex_unlock(&pool->trava);
+    return NULL;
+}
+
+// Cria um pool com 'threads' threads no total (a chamadora conta como uma)
+PoolThreads *criarPool(int threads) {
+    PoolThreads *pool = alocar(sizeof(PoolThreads));
+    memset(pool, 0, sizeof(PoolThreads));
+    pool->qtdThreads = threads;
+    pool->threads = alocar((size_t)threads * sizeof(pthread_t));
+    pool->tids = alocar((size_t)threads * sizeof(pid_t));
+    pthread_mutex_init(&pool->trava, NULL);
+    pthread_cond_init(&pool->temTrabalho, NULL);
+    pthread_cond_init(&pool->terminou, NULL);
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, trabalhadorPool, pool) != 0) {
+            printf("\n❌ Não foi possível criar as threads de ordenação.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    pthread_mutex_lock(&pool->trava); // Os ids ficam prontos antes do primeiro uso
+    while (pool->iniciadas < threads - 1)
+        pthread_cond_wait(&pool->terminou, &pool->trava);
+    pthread_mutex_unlock(&pool->trava);
+    return pool;
+}
+
+// Encerra as threads e libera o pool
+void liberarPool(PoolThreads *pool) {
+    if (pool == NULL)
+        return;
+    pthread_mutex_lock(&pool->trava);
+    pool->encerrar = 1;
+    pthread_cond_broadcast(&pool->temTrabalho);
+    pthread_mutex_unlock(&pool->trava);
+    for (int i = 1; i < pool->qtdThreads; i++)
+        pthread_join(pool->threads[i], NULL);
+    pthread_mutex_destroy(&pool->trava);
+    pthread_cond_destroy(&pool->temTrabalho);
+    pthread_cond_destroy(&pool->terminou);
+    free(pool->threads);
+    free(pool->tids);
+    free(pool);
+}
+
+// Executa funcao(contexto, 0..tarefas-1) distribuindo as tarefas pelo pool e espera o fim
+void paraleloPara(PoolThreads *pool, int tarefas, void (*funcao)(void *, int), void *contexto) {
+    if (tarefas <= 0)
+        return;
+    pthread_mutex_lock(&pool->trava);
+    pool->funcao = funcao;
+    pool->contexto = contexto;
+    pool->totalTarefas = tarefas;
+    pool->concluidas = 0;
+    pool->geracao++;
+    __atomic_store_n(&pool->proximaTarefa, (uint64_t)pool->geracao << 32, __ATOMIC_RELEASE);
+    RodadaPool rodada = rodadaAtual(pool);
+    pthread_cond_broadcast(&pool->temTrabalho);
+    pthread_mutex_unlock(&pool->trava);
+
+    int feitas = consumirTarefas(pool, &rodada); // A chamadora também trabalha
+
+    pthread_mutex_lock(&pool->trava);
+    pool->concluidas += feitas;
+    while (pool->concluidas < pool->totalTarefas)
+        pthread_cond_wait(&pool->terminou, &pool->trava);
+    pthread_mutex_unlock(&pool->trava);
+}
+
+// Pool com o número de threads pedido (recriado se o número mudar)
+PoolThreads *obterPool(int threads) {
+    if (poolOrdenacao != NULL && poolOrdenacao->qtdThreads != threads) {
+        liberarPool(poolOrdenacao);
+        poolOrdenacao = NULL;
+    }
+    if (poolOrdenacao == NULL)
+        poolOrdenacao = criarPool(threads);
+    return poolOrdenacao;
+}
+
+// Estado compartilhado por uma ordenação paralela
+typedef struct {
+    const Componente *lista;
+    Componente *destino;
+    ChaveOrdem *chaves, *aux;
+    CampoOrdenacao campo;
+    int n;
+    int blocos;         // Blocos da fase inicial (um por thread)
+    int *limites;       // Início de cada sequência ordenada (blocos + 1 posições)
+    int largura;        // Rodada atual: quantas sequências são intercaladas por par
+    int pedaco;         // Tamanho de cada fatia de saída nas intercalações
+    int *inicioTarefa;  // Primeira tarefa de cada par na rodada atual
+    int pares;
+    const ChaveOrdem *origem;
+    ChaveOrdem *saida;
+    int comparacoes[MAX_TAREFAS_PARALELAS]; // Um contador por tarefa (sem disputa)
+    long long movimentos[MAX_TAREFAS_PARALELAS];
+} OrdenacaoParalela;
+
+// Tarefa: monta as chaves de uma fatia
+void tarefaCriarChaves(void *contexto, int tarefa) {
+    OrdenacaoParalela *op = contexto;
+    int inicio = (int)((long)op->n * tarefa / op->blocos), fim = (int)((long)op->n * (tarefa + 1) / op->blocos);
+    preencherChaves(op->lista, op->chaves, inicio, fim, op->campo);
+}
+
+// Tarefa: ordena um bloco com o Merge Sort serial
+void tarefaOrdenarBloco(void *contexto, int tarefa) {
+    OrdenacaoParalela *op = contexto;
+    int inicio = op->limites[tarefa], fim = op->limites[tarefa + 1];
+    long long antes = movimentos; // Contador desta thread
+    op->comparacoes[tarefa] = 0;
+    mergeSortChaves(op->lista, op->chaves + inicio, op->aux + inicio, fim - inicio, op->campo, &op->comparacoes[tarefa]);
+    op->movimentos[tarefa] = movimentos - antes;
+    movimentos = antes; // A chamadora soma as tarefas no fim; as dela não contam duas vezes
+}
+
+// Quantos elementos de a entram nas k primeiras posições da intercalação estável de a e b
+int coRank(const OrdenacaoParalela *op, const ChaveOrdem *a, int na, const ChaveOrdem *b, int nb, int k, int *comparacoes) {
+    int baixo = k > nb ? k - nb : 0, alto = k < na ? k : na;
+    while (baixo < alto) {
+        int i = baixo + (alto - baixo) / 2;
+        // a[i] vem antes de b[k-i-1] (empate favorece a)? Então i é pequeno demais
+        if (compararChaves(op->lista, op->campo, &a[i], &b[k - i - 1], comparacoes) <= 0)
+            baixo = i + 1;
+        else
+            alto = i;
+    }
+    return baixo;
+}
+
+// Tarefa: produz uma fatia da intercalação de um par de sequências
+void tarefaIntercalar(void *contexto, int tarefa) {
+    OrdenacaoParalela *op = contexto;
+    int par = 0;
+    while (par + 1 < op->pares && op->inicioTarefa[par + 1] <= tarefa)
+        par++;
+
+    int s = par * 2 * op->largura; // Primeira sequência do par
+    int inicio = op->limites[s];
+    int meio = op->limites[s + op->largura < op->blocos ? s + op->largura : op->blocos];
+    int fim = op->limites[s + 2 * op->largura < op->blocos ? s + 2 * op->largura : op->blocos];
+    const ChaveOrdem *a = op->origem + inicio, *b = op->origem + meio;
+    int na = meio - inicio, nb = fim - meio;
+
+    int *comparacoes = &op->comparacoes[tarefa];
+    *comparacoes = 0;
+    int k0 = (tarefa - op->inicioTarefa[par]) * op->pedaco;
+    int k1 = k0 + op->pedaco < na + nb ? k0 + op->pedaco : na + nb;
+    int i = coRank(op, a, na, b, nb, k0, comparacoes), j = k0 - i;
+    int iFim = coRank(op, a, na, b, nb, k1, comparacoes), jFim = k1 - iFim;
+
+    ChaveOrdem *saida = op->saida + inicio + k0;
+    while (i < iFim && j < jFim) {
+        if (compararChaves(op->lista, op->campo, &b[j], &a[i], comparacoes) < 0)
+            *saida++ = b[j++];
+        else
+            *saida++ = a[i++];
+    }
+    while (i < iFim)
+        *saida++ = a[i++];
+    while (j < jFim)
+        *saida++ = b[j++];
+}
+
+// Tarefa: copia uma fatia dos componentes para a posição final
+void tarefaAplicarOrdem(void *contexto, int tarefa) {
+    OrdenacaoParalela *op = contexto;
+    int inicio = (int)((long)op->n * tarefa / op->blocos), fim = (int)((long)op->n * (tarefa + 1) / op->blocos);
+    for (int i = inicio; i < fim; i++)
+        op->destino[i] = op->lista[op->chaves[i].indice];
+}
+
+// Tarefa: devolve uma fatia da cópia ordenada para a lista
+void tarefaCopiarDeVolta(void *contexto, int tarefa) {
+    OrdenacaoParalela *op = contexto;
+    int inicio = (int)((long)op->n * tarefa / op->blocos), fim = (int)((long)op->n * (tarefa + 1) / op->blocos);
+    memcpy((Componente *)op->lista + inicio, op->destino + inicio, (size_t)(fim - inicio) * sizeof(Componente));
+}
+
+// Soma os contadores das tarefas da última rodada
+int somarComparacoes(const OrdenacaoParalela *op, int tarefas) {
+    int total = 0;
+    for (int t = 0; t < tarefas; t++)
+        total += op->comparacoes[t];
+    return total;
+}
+
+// Merge Sort paralelo -> Ordena por qualquer campo (estável) usando 'threads' threads
+void mergeSortParalelo(Componente lista[], int n, CampoOrdenacao campo, int threads, int *comparacoes) {
+    if (threads > MAX_THREADS)
+        threads = MAX_THREADS;
+    if (threads <= 1 || n < LIMIAR_PARALELO) { // Caminho serial
+        ChaveOrdem *chaves = criarChaves(lista, n, campo);
+        ChaveOrdem *aux = alocar((size_t)n * sizeof(ChaveOrdem));
+        *comparacoes = 0;
+        mergeSortChaves(lista, chaves, aux, n, campo, comparacoes);
+        aplicarOrdem(lista, chaves, n);
+        free(chaves);
+        free(aux);
+        ordenadoPorNome = campo == CAMPO_NOME;
+        return;
+    }
+
+    PoolThreads *pool = obterPool(threads);
+    OrdenacaoParalela *op = alocar(sizeof(OrdenacaoParalela));
+    op->lista = lista;
+    op->campo = campo;
+    op->n = n;
+    op->blocos = threads;
+    op->chaves = alocar((size_t)n * sizeof(ChaveOrdem));
+    op->aux = alocar((size_t)n * sizeof(ChaveOrdem));
+    op->limites = alocar((size_t)(threads + 1) * sizeof(int));
+    op->inicioTarefa = alocar((size_t)threads * sizeof(int));
+    for (int b = 0; b <= threads; b++)
+        op->limites[b] = (int)((long)n * b / threads);
+    *comparacoes = 0;
+
+    // Fase 1: chaves e blocos ordenados em paralelo
+    paraleloPara(pool, threads, tarefaCriarChaves, op);
+    paraleloPara(pool, threads, tarefaOrdenarBloco, op);
+    *comparacoes += somarComparacoes(op, threads);
+    for (int t = 0; t < threads; t++)
+        movimentos += op->movimentos[t];
+
+    // Fase 2: intercalações aos pares, cada uma fatiada entre as threads
+    op->origem = op->chaves;
+    op->saida = op->aux;
+    op->pedaco = n / threads + 1;
+    for (op->largura = 1; op->largura < threads; op->largura *= 2) {
+        int tarefas = 0;
+        op->pares = (threads + 2 * op->largura - 1) / (2 * op->largura);
+        for (int p = 0; p < op->pares; p++) {
+            int s = p * 2 * op->largura;
+            int fim = op->limites[s + 2 * op->largura < threads ? s + 2 * op->largura : threads];
+            op->inicioTarefa[p] = tarefas;
+            tarefas += (fim - op->limites[s] + op->pedaco - 1) / op->pedaco;
+        }
+        paraleloPara(pool, tarefas, tarefaIntercalar, op);
+        *comparacoes += somarComparacoes(op, tarefas);
+        movimentos += n; // Cada rodada grava todas as chaves uma vez
+
+        ChaveOrdem *temp = (ChaveOrdem *)op->origem; // Troca os papéis dos buffers
+        op->origem = op->saida;
+        op->saida = temp;
+    }
+    op->chaves = (ChaveOrdem *)op->origem;
+    op->aux = op->saida;
+
+    // Fase 3: cada componente vai uma vez para a posição final
+    op->destino = alocar((size_t)n * sizeof(Componente));
+    paraleloPara(pool, threads, tarefaAplicarOrdem, op);
+    paraleloPara(pool, threads, tarefaCopiarDeVolta, op);
+    movimentos += 2LL * n;
+
+    free(op->destino);
+    free(op->chaves);
+    free(op->aux);
+    free(op->limites);
+    free(op->inicioTarefa);
+    free(op);
+    ordenadoPorNome = campo == CAMPO_NOME;
+}
+
+// -------------------------------
+// TABELA HASH POR NOME
+// -------------------------------
+// Endereçamento aberto com sondagem linear: nome -> posição na mochila.
+// A remoção desloca as entradas seguintes para trás, sem deixar lápides.
+// Nomes repetidos não disputam a sondagem: entram na lista do nome, em O(1).
+
+// FNV-1a de 32 bits
+uint32_t hashNome(const char *nome) {
+    uint32_t h = 2166136261u;
+    for (; *nome; nome++)
+        h = (h ^ (unsigned char)*nome) * 16777619u;
+    return h;
+}
+
+// (Re)cria a tabela vazia com a capacidade informada (potência de 2)
+void prepararTabelaNomes(TabelaNomes *t, int capacidade) {
+    free(t->hashes);
+    free(t->slots);
+    t->hashes = alocar((size_t)capacidade * sizeof(uint32_t));
+    t->slots = alocar((size_t)capacidade * sizeof(int));
+    memset(t->slots, 0xFF, (size_t)capacidade * sizeof(int)); // -1 = entrada vazia
+    t->capacidade = capacidade;
+    t->qtd = 0;
+}
+
+// Insere a entrada sem verificar a carga
+void inserirEntradaNome(TabelaNomes *t, uint32_t h, int slot) {
+    int mascara = t->capacidade - 1, i = (int)(h & (uint32_t)mascara);
+    while (t->slots[i] >= 0)
+        i = (i + 1) & mascara;
+    t->hashes[i] = h;
+    t->slots[i] = slot;
+    t->qtd++;
+}
+
+// Garante as listas de repetidos para posições até capacidade - 1
+void crescerCadeiasNomes(TabelaNomes *t, int capacidade) {
+    if (capacidade <= t->capacidadeCadeias)
+        return;
+    t->proximo = realloc(t->proximo, (size_t)capacidade * sizeof(int));
+    t->anterior = realloc(t->anterior, (size_t)capacidade * sizeof(int));
+    if (t->proximo == NULL || t->anterior == NULL) {
+        printf("\n❌ Memória insuficiente.\n");
+        exit(EXIT_FAILURE);
+    }
+    t->capacidadeCadeias = capacidade;
+}
+
+// Índice da entrada do nome na tabela (-1 se ausente)
+int entradaDaTabelaNomes(const Mochila *m, const char *nome, uint32_t h) {
+    const TabelaNomes *t = m->tabelaNomes;
+    int mascara = t->capacidade - 1;
+    for (int i = (int)(h & (uint32_t)mascara); t->slots[i] >= 0; i = (i + 1) & mascara)
+        if (t->hashes[i] == h && strcmp(m->itens[t->slots[i]].nome, nome) == 0)
+            return i;
+    return -1;
+}
+
+// Registra o nome do componente da posição informada (dobra a tabela acima de 50% de carga)
+void inserirNaTabelaNomes(const Mochila *m, int slot) {
+    TabelaNomes *t = m->tabelaNomes;
+    if (slot >= t->capacidadeCadeias)
+        crescerCadeiasNomes(t, slot + 1 > 2 * t->capacidadeCadeias ? slot + 1 : 2 * t->capacidadeCadeias);
+    uint32_t h = hashNome(m->itens[slot].nome);
+    int i = entradaDaTabelaNomes(m, m->itens[slot].nome, h);
+    if (i >= 0) { // Nome repetido: entra logo depois da primeira posição
+        int primeira = t->slots[i];
+        t->proximo[slot] = t->proximo[primeira];
+        t->anterior[slot] = primeira;
+        if (t->proximo[primeira] >= 0)
+            t->anterior[t->proximo[primeira]] = slot;
+        t->proximo[primeira] = slot;
+        return;
+    }
+    t->proximo[slot] = t->anterior[slot] = -1;
+    if (2 * (t->qtd + 1) > t->capacidade) {
+        uint32_t *hashes = t->hashes;
+        int *slots = t->slots, capacidade = t->capacidade;
+        t->hashes = NULL;
+        t->slots = NULL;
+        prepararTabelaNomes(t, capacidade * 2);
+        for (int e = 0; e < capacidade; e++)
+            if (slots[e] >= 0)
+                inserirEntradaNome(t, hashes[e], slots[e]);
+        free(hashes);
+        free(slots);
+    }
+    inserirEntradaNome(t, h, slot);
+}
+
+// Retira da tabela a posição informada
+void removerDaTabelaNomes(const Mochila *m, int slot) {
+    TabelaNomes *t = m->tabelaNomes;
+    if (slot >= t->capacidadeCadeias) // Posição não registrada (não deveria acontecer)
+        return;
+    int anterior = t->anterior[slot], proximo = t->proximo[slot];
+    if (anterior >= 0) { // Repetida: só sai da lista
+        t->proximo[anterior] = proximo;
+        if (proximo >= 0)
+            t->anterior[proximo] = anterior;
+        return;
+    }
+
+    int mascara = t->capacidade - 1;
+    int i = (int)(hashNome(m->itens[slot].nome) & (uint32_t)mascara);
+    while (t->slots[i] != slot) {
+        if (t->slots[i] < 0) // Posição não registrada (não deveria acontecer)
+            return;
+        i = (i + 1) & mascara;
+    }
+    if (proximo >= 0) { // A próxima repetida passa a representar o nome
+        t->slots[i] = proximo;
+        t->anterior[proximo] = -1;
+        return;
+    }
+
+    // Desloca para trás as entradas cuja sondagem passou por i
+    for (int j = (i + 1) & mascara; t->slots[j] >= 0; j = (j + 1) & mascara) {
+        int ideal = (int)(t->hashes[j] & (uint32_t)mascara);
+        // A entrada j pode ocupar i se o caminho ideal -> j passa por i
+        if (((j - ideal) & mascara) >= ((j - i) & mascara)) {
+            t->hashes[i] = t->hashes[j];
+            t->slots[i] = t->slots[j];
+            i = j;
+        }
+    }
+    t->slots[i] = -1;
+    t->qtd--;
+}
+
+// Procura um nome na tabela, ignorando posições marcadas (marcado pode ser NULL); -1 se ausente
+int buscarNaTabelaNomes(const Mochila *m, const char *nome, const unsigned char *marcado) {
+    const TabelaNomes *t = m->tabelaNomes;
+    int i = entradaDaTabelaNomes(m, nome, hashNome(nome));
+    if (i < 0)
+        return -1;
+    int slot = t->slots[i];
+    while (slot >= 0 && marcado != NULL && marcado[slot])
+        slot = t->proximo[slot];
+    return slot;
+}
+
+// Reconstrói a tabela a partir do conteúdo atual da mochila
+void reconstruirTabelaNomes(Mochila *m) {
+    TabelaNomes *t = m->tabelaNomes;
+    if (t == NULL)
+        return;
+    int capacidade = CAPACIDADE_INICIAL_HASH;
+    while (capacidade < 2 * m->qtd)
+        capacidade *= 2;
+    prepararTabelaNomes(t, capacidade);
+    crescerCadeiasNomes(t, m->capacidade);
+    for (int i = 0; i < m->qtd; i++)
+        inserirNaTabelaNomes(m, i);
+}
+
+// Cria a tabela hash de nomes da mochila
+void ativarTabelaNomes(Mochila *m) {
+    if (m->tabelaNomes != NULL)
+        return;
+    m->tabelaNomes = alocar(sizeof(TabelaNomes));
+    memset(m->tabelaNomes, 0, sizeof(TabelaNomes));
+    reconstruirTabelaNomes(m);
+}
+
+// Libera a tabela hash de nomes
+void liberarTabelaNomes(Mochila *m) {
+    if (m->tabelaNomes == NULL)
+        return;
+    free(m->tabelaNomes->hashes);
+    free(m->tabelaNomes->slots);
+    free(m->tabelaNomes->proximo);
+    free(m->tabelaNomes->anterior);
+    free(m->tabelaNomes);
+    m->tabelaNomes = NULL;
+}
+
+// -------------------------------
+// ÍNDICES SECUNDÁRIOS (nome, tipo, prioridade e nome sem caso)
+// -------------------------------
+// Cada índice é uma treap cujos nós são as próprias posições da mochila,
+// ordenadas por (campo, posição). Inserções e remoções custam O(log n), então
+// buscas e listagens ordenadas ficam sempre disponíveis sem reordenar o vetor.
+
+uint32_t estadoPesos = 2463534242u; // Semente do gerador xorshift dos pesos da treap
+
+uint32_t proximoPeso() {
+    estadoPesos ^= estadoPesos << 13;
+    estadoPesos ^= estadoPesos >> 17;
+    estadoPesos ^= estadoPesos << 5;
+    return estadoPesos;
+}
+
+// Compara dois componentes da mochila por campo; empate resolvido pela posição
+int compararSlots(const Mochila *m, CampoOrdenacao campo, int a, int b) {
+    const Componente *x = &m->itens[a], *y = &m->itens[b];
+    int r;
+    if (campo == CAMPO_PRIORIDADE)
+        r = (x->prioridade > y->prioridade) - (x->prioridade < y->prioridade);
+    else if (campo == CAMPO_NOME_SEM_CASO)
+        r = strcasecmp(x->nome, y->nome);
+    else
+        r = strcmp(textoCampo(x, campo), textoCampo(y, campo));
+    return r != 0 ? r : (a > b) - (a < b);
+}
+
+// Une duas treaps (todas as chaves de 'a' antes das de 'b')
+int unirTreap(IndicesMochila *ind, CampoOrdenacao campo, int a, int b) {
+    if (a < 0) return b;
+    if (b < 0) return a;
+    if (ind->peso[a] > ind->peso[b]) {
+        ind->dir[campo][a] = unirTreap(ind, campo, ind->dir[campo][a], b);
+        return a;
+    }
+    ind->esq[campo][b] = unirTreap(ind, campo, a, ind->esq[campo][b]);
+    return b;
+}
+
+// Divide a treap em chaves menores que 'slot' (*menores) e maiores (*maiores)
+void dividirTreap(const Mochila *m, CampoOrdenacao campo, int raiz, int slot, int *menores, int *maiores) {
+    IndicesMochila *ind = m->indices;
+    if (raiz < 0) {
+        *menores = *maiores = -1;
+    } else if (compararSlots(m, campo, raiz, slot) < 0) {
+        dividirTreap(m, campo, ind->dir[campo][raiz], slot, &ind->dir[campo][raiz], maiores);
+        *menores = raiz;
+    } else {
+        dividirTreap(m, campo, ind->esq[campo][raiz], slot, menores, &ind->esq[campo][raiz]);
+        *maiores = raiz;
+    }
+}
+
+// Insere a posição em um índice
+void inserirNoIndice(const Mochila *m, CampoOrdenacao campo, int slot) {
+    IndicesMochila *ind = m->indices;
+    int menores, maiores;
+    ind->esq[campo][slot] = ind->dir[campo][slot] = -1;
+    dividirTreap(m, campo, ind->raiz[campo], slot, &menores, &maiores);
+    ind->raiz[campo] = unirTreap(ind, campo, unirTreap(ind, campo, menores, slot), maiores);
+}
+
+// Remove a posição de um índice
+void removerDoIndice(const Mochila *m, CampoOrdenacao campo, int slot) {
+    IndicesMochila *ind = m->indices;
+    int *ligacao = &ind->raiz[campo];
+    while (*ligacao != slot) {
+        if (*ligacao < 0) // Posição não indexada (não deveria acontecer)
+            return;
+        ligacao = compararSlots(m, campo, slot, *ligacao) < 0 ? &ind->esq[campo][*ligacao]
+                                                                : &ind->dir[campo][*ligacao];
+    }
+    *ligacao = unirTreap(ind, campo, ind->esq[campo][slot], ind->dir[campo][slot]);
+}
+
+// Acompanha o crescimento da mochila (chamada por reservarMochila)
+void crescerIndices(Mochila *m, int capacidade) {
+    IndicesMochila *ind = m->indices;
+    if (ind == NULL || capacidade <= ind->capacidade)
+        return;
+    for (int c = 0; c < NUM_INDICES; c++) {
+        ind->esq[c] = realloc(ind->esq[c], (size_t)capacidade * sizeof(int));
+        ind->dir[c] = realloc(ind->dir[c], (size_t)capacidade * sizeof(int));
+        if (ind->esq[c] == NULL || ind->dir[c] == NULL) {
+            printf("\n❌ Memória insuficiente.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    ind->peso = realloc(ind->peso, (size_t)capacidade * sizeof(uint32_t));
+    ind->pilha = realloc(ind->pilha, (size_t)capacidade * sizeof(int));
+    if (ind->peso == NULL || ind->pilha == NULL) {
+        printf("\n❌ Memória insuficiente.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = ind->capacidade; i < capacidade; i++)
+        ind->peso[i] = proximoPeso();
+    ind->capacidade = capacidade;
+}
+
+// Devolve o espaço dos índices além de 'capacidade' (a mochila encolheu)
+void encolherIndices(Mochila *m, int capacidade) {
+    IndicesMochila *ind = m->indices;
+    if (ind == NULL || capacidade >= ind->capacidade)
+        return;
+    for (int c = 0; c < NUM_INDICES; c++) {
+        ind->esq[c] = encolherBloco(ind->esq[c], (size_t)capacidade * sizeof(int));
+        ind->dir[c] = encolherBloco(ind->dir[c], (size_t)capacidade * sizeof(int));
+    }
+    ind->peso = encolherBloco(ind->peso, (size_t)capacidade * sizeof(uint32_t));
+    ind->pilha = encolherBloco(ind->pilha, (size_t)capacidade * sizeof(int));
+    ind->capacidade = capacidade;
+}
+
+// Indexa um componente recém-colocado na posição informada
+void indexarSlot(Mochila *m, int slot) {
+    if (m->colunas != NULL)
+        gravarColunas(m, slot);
+    if (m->criticos != NULL)
+        inserirNoHeap(m, slot);
+    if (m->resumos != NULL)
+        somarAoResumo(m, slot);
+    if (m->trigramas != NULL && !m->trigramas->desatualizada)
+        inserirNoIndiceTrigramas(m->trigramas, m->itens[slot].nome);
+    if (m->tabelaNomes != NULL)
+        inserirNaTabelaNomes(m, slot);
+    if (m->indices == NULL)
+        return;
+    for (int c = 0; c < NUM_INDICES; c++)
+        inserirNoIndice(m, (CampoOrdenacao)c, slot);
+}
+
+// Retira dos índices o componente da posição informada (antes de sobrescrevê-lo)
+void desindexarSlot(Mochila *m, int slot) {
+    if (m->colunas != NULL)
+        apagarDasColunas(m, slot);
+    if (m->criticos != NULL)
+        removerDoHeap(m, slot);
+    if (m->resumos != NULL)
+        subtrairDoResumo(m, slot);
+    if (m->trigramas != NULL && !m->trigramas->desatualizada)
+        removerDoIndiceTrigramas(m->trigramas, m->itens[slot].nome);
+    if (m->tabelaNomes != NULL)
+        removerDaTabelaNomes(m, slot);
+    if (m->indices == NULL)
+        return;
+    for (int c = 0; c < NUM_INDICES; c++)
+        removerDoIndice(m, (CampoOrdenacao)c, slot);
+}
+
+// Monta uma treap a partir das posições já ordenadas, em O(n) (árvore cartesiana pelos pesos)
+int montarTreapOrdenada(IndicesMochila *ind, CampoOrdenacao campo, const ChaveOrdem ordem[], int n) {
+    int *pilha = alocar((size_t)(n > 0 ? n : 1) * sizeof(int));
+    int topo = 0;
+    for (int i = 0; i < n; i++) {
+        int slot = ordem[i].indice, ultimo = -1;
+        ind->esq[campo][slot] = ind->dir[campo][slot] = -1;
+        while (topo > 0 && ind->peso[pilha[topo - 1]] < ind->peso[slot])
+            ultimo = pilha[--topo];
+        ind->esq[campo][slot] = ultimo;
+        if (topo > 0)
+            ind->dir[campo][pilha[topo - 1]] = slot;
+        pilha[topo++] = slot;
+    }
+    int raiz = topo > 0 ? pilha[0] : -1;
+    free(pilha);
+    return raiz;
+}
+
+// Reconstrói os índices do zero (após ordenar ou carregar o vetor inteiro)
+void reconstruirIndices(Mochila *m) {
+    IndicesMochila *ind = m->indices;
+    if (ind == NULL)
+        return;
+    crescerIndices(m, m->capacidade);
+
+    ChaveOrdem *aux = alocar((size_t)(m->qtd > 0 ? m->qtd : 1) * sizeof(ChaveOrdem));
+    int comparacoes = 0;
+    for (int c = 0; c < NUM_INDICES; c++) {
+        // Merge Sort é estável: empates ficam na ordem das posições, como na treap
+        ChaveOrdem *chaves = criarChaves(m->itens, m->qtd, (CampoOrdenacao)c);
+        mergeSortChaves(m->itens, chaves, aux, m->qtd, (CampoOrdenacao)c, &comparacoes);
+        ind->raiz[c] = montarTreapOrdenada(ind, (CampoOrdenacao)c, chaves, m->qtd);
+        free(chaves);
+    }
+    free(aux);
+}
+
+// Cria os índices secundários da mochila e indexa o conteúdo atual
+void ativarIndices(Mochila *m) {
+    if (m->indices != NULL)
+        return;
+    m->indices = alocar(sizeof(IndicesMochila));
+    memset(m->indices, 0, sizeof(IndicesMochila));
+    reconstruirIndices(m);
+}
+
+// Libera os índices secundários
+void liberarIndices(Mochila *m) {
+    IndicesMochila *ind = m->indices;
+    if (ind == NULL)
+        return;
+    for (int c = 0; c < NUM_INDICES; c++) {
+        free(ind->esq[c]);
+        free(ind->dir[c]);
+    }
+    free(ind->peso);
+    free(ind->pilha);
+    free(ind);
+    m->indices = NULL;
+}
+
+// Busca um componente pelo nome no índice (O(log n), sem exigir a mochila ordenada)
+int buscaIndexadaPorNome(const Mochila *m, const char nomeBusca[], int *comparacoes) {
+    const IndicesMochila *ind = m->indices;
+    int no = ind ? ind->raiz[CAMPO_NOME] : -1;
+    *comparacoes = 0;
+    while (no >= 0) {
+        (*comparacoes)++;
+        int resultado = strcmp(nomeBusca, m->itens[no].nome);
+        if (resultado == 0)
+            return no;
+        no = resultado < 0 ? ind->esq[CAMPO_NOME][no] : ind->dir[CAMPO_NOME][no];
+    }
+    return -1;
+}
+
+// Lista os componentes na ordem de um índice (percurso em ordem, sem recursão)
+void mostrarPorIndice(const Mochila *m, CampoOrdenacao campo) {
+    const IndicesMochila *ind = m->indices;
+    if (m->qtd == 0 || ind == NULL) {
+        printf("\nA mochila está vazia!\n");
+        return;
+    }
+
+    static const char *nomesCampos[] = {"NOME", "TIPO", "PRIORIDADE", "NOME (SEM CASO)"};
+    printf("\n--- INVENTÁRIO POR %s (%d itens) ---\n", nomesCampos[campo], m->qtd);
+    printf("-------------------------------------------------------------------------------\n");
+    printf("%-25s | %-15s | %-10s | %-5s\n", "NOME", "TIPO", "PRIORIDADE", "QTD");
+    printf("-------------------------------------------------------------------------------\n");
+
+    int *pilha = alocar((size_t)m->qtd * sizeof(int));
+    int topo = 0, no = ind->raiz[campo];
+    while (no >= 0 || topo > 0) {
+        while (no >= 0) {
+            pilha[topo++] = no;
+            no = ind->esq[campo][no];
+        }
+        no = pilha[--topo];
+        const Componente *c = &m->itens[no];
+        printf("%-25s | %-15s | %-10d | %-5d\n", c->nome, c->tipo, c->prioridade, c->qtd);
+        no = ind->dir[campo][no];
+    }
+    free(pilha);
+    printf("-------------------------------------------------------------------------------\n");
+}
+
+// -------------------------------
+// COLUNAS (STRUCT-OF-ARRAYS) E KERNELS SIMD
+// -------------------------------
+// Espelho da mochila em colunas contíguas: prioridade[] e qtd[] (varridas sem
+// trazer nome e tipo para o cache) e um pool de nomes. As colunas acompanham a
+// mochila pelos mesmos ganchos dos índices. Os kernels usam AVX2 ou SSE4.1
+// conforme a CPU (detectado uma vez) e têm versão escalar para as sobras e
+// para outras arquiteturas.
+
+int nivelSimd = -1; // -1 = não detectado, 0 = escalar, 1 = SSE4.1, 2 = AVX2
+
+// Detecta o melhor conjunto de instruções disponível
+int detectarSimd() {
+    if (nivelSimd < 0) {
+        nivelSimd = 0;
+#ifdef SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            nivelSimd = 2;
+        else if (__builtin_cpu_supports("sse4.1"))
+            nivelSimd = 1;
+#endif
+    }
+    return nivelSimd;
+}
+
+// Versões escalares (também tratam as sobras dos vetores)
+int filtrarPrioridadeEscalar(const int *p, int inicio, int n, int minimo, int maximo, int *saida, int k) {
+    for (int i = inicio; i < n; i++)
+        if (p[i] >= minimo && p[i] <= maximo)
+            saida[k++] = i;
+    return k;
+}
+
+void minMaxEscalar(const int *p, int inicio, int n, int *menor, int *maior) {
+    for (int i = inicio; i < n; i++) {
+        if (p[i] < *menor) *menor = p[i];
+        if (p[i] > *maior) *maior = p[i];
+    }
+}
+
+#ifdef SIMD_X86
+__attribute__((target("avx2")))
+int filtrarPrioridadeAVX2(const int *p, int n, int minimo, int maximo, int *saida) {
+    __m256i vMin = _mm256_set1_epi32(minimo), vMax = _mm256_set1_epi32(maximo);
+    int i = 0, k = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+        __m256i fora = _mm256_or_si256(_mm256_cmpgt_epi32(vMin, v), _mm256_cmpgt_epi32(v, vMax));
+        unsigned mascara = ~(unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(fora)) & 0xFFu;
+        while (mascara) {
+            saida[k++] = i + __builtin_ctz(mascara);
+            mascara &= mascara - 1;
+        }
+    }
+    return filtrarPrioridadeEscalar(p, i, n, minimo, maximo, saida, k);
+}
+
+__attribute__((target("avx2")))
+long long somarAVX2(const int *q, int n) {
+    __m256i acumulado = _mm256_setzero_si256(); // Quatro somas de 64 bits
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(q + i));
+        acumulado = _mm256_add_epi64(acumulado, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        acumulado = _mm256_add_epi64(acumulado, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    long long partes[4];
+    _mm256_storeu_si256((__m256i *)partes, acumulado);
+    long long total = partes[0] + partes[1] + partes[2] + partes[3];
+    for (; i < n; i++)
+        total += q[i];
+    return total;
+}
+
+__attribute__((target("avx2")))
+void minMaxAVX2(const int *p, int n, int *menor, int *maior) {
+    __m256i vMenor = _mm256_set1_epi32(INT_MAX), vMaior = _mm256_set1_epi32(INT_MIN);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+        vMenor = _mm256_min_epi32(vMenor, v);
+        vMaior = _mm256_max_epi32(vMaior, v);
+    }
+    int a[8], b[8];
+    _mm256_storeu_si256((__m256i *)a, vMenor);
+    _mm256_storeu_si256((__m256i *)b, vMaior);
+    for (int j = 0; j < 8; j++) { // Junta as faixas dos vetores
+        if (a[j] < *menor) *menor = a[j];
+        if (b[j] > *maior) *maior = b[j];
+    }
+    minMaxEscalar(p, i, n, menor, maior);
+}
+
+__attribute__((target("avx2")))
+int primeiraOcorrenciaAVX2(const int *p, int n, int valor) {
+    __m256i alvo = _mm256_set1_epi32(valor);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i iguais = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(p + i)), alvo);
+        unsigned mascara = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(iguais));
+        if (mascara)
+            return i + __builtin_ctz(mascara);
+    }
+    for (; i < n; i++)
+        if (p[i] == valor)
+            return i;
+    return -1;
+}
+
+__attribute__((target("sse4.1")))
+int filtrarPrioridadeSSE(const int *p, int n, int minimo, int maximo, int *saida) {
+    __m128i vMin = _mm_set1_epi32(minimo), vMax = _mm_set1_epi32(maximo);
+    int i = 0, k = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        __m128i fora = _mm_or_si128(_mm_cmpgt_epi32(vMin, v), _mm_cmpgt_epi32(v, vMax));
+        unsigned mascara = ~(unsigned)_mm_movemask_ps(_mm_castsi128_ps(fora)) & 0xFu;
+        while (mascara) {
+            saida[k++] = i + __builtin_ctz(mascara);
+            mascara &= mascara - 1;
+        }
+    }
+    return filtrarPrioridadeEscalar(p, i, n, minimo, maximo, saida, k);
+}
+
+__attribute__((target("sse4.1")))
+long long somarSSE(const int *q, int n) {
+    __m128i acumulado = _mm_setzero_si128(); // Duas somas de 64 bits
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(q + i));
+        acumulado = _mm_add_epi64(acumulado, _mm_cvtepi32_epi64(v));
+        acumulado = _mm_add_epi64(acumulado, _mm_cvtepi32_epi64(_mm_srli_si128(v, 8)));
+    }
+    long long partes[2];
+    _mm_storeu_si128((__m128i *)partes, acumulado);
+    long long total = partes[0] + partes[1];
+    for (; i < n; i++)
+        total += q[i];
+    return total;
+}
+
+__attribute__((target("sse4.1")))
+void minMaxSSE(const int *p, int n, int *menor, int *maior) {
+    __m128i vMenor = _mm_set1_epi32(INT_MAX), vMaior = _mm_set1_epi32(INT_MIN);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        vMenor = _mm_min_epi32(vMenor, v);
+        vMaior = _mm_max_epi32(vMaior, v);
+    }
+    int a[4], b[4];
+    _mm_storeu_si128((__m128i *)a, vMenor);
+    _mm_storeu_si128((__m128i *)b, vMaior);
+    for (int j = 0; j < 4; j++) { // Junta as faixas dos vetores
+        if (a[j] < *menor) *menor = a[j];
+        if (b[j] > *maior) *maior = b[j];
+    }
+    minMaxEscalar(p, i, n, menor, maior);
+}
+
+__attribute__((target("sse4.1")))
+int primeiraOcorrenciaSSE(const int *p, int n, int valor) {
+    __m128i alvo = _mm_set1_epi32(valor);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i iguais = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(p + i)), alvo);
+        unsigned mascara = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(iguais));
+        if (mascara)
+            return i + __builtin_ctz(mascara);
+    }
+    for (; i < n; i++)
+        if (p[i] == valor)
+            return i;
+    return -1;
+}
+#endif
+
+// Grava em 'saida' as posições com prioridade em [minimo, maximo]; devolve quantas
+int filtrarPorPrioridade(const int *p, int n, int minimo, int maximo, int *saida) {
+#ifdef SIMD_X86
+    if (detectarSimd() == 2) return filtrarPrioridadeAVX2(p, n, minimo, maximo, saida);
+    if (nivelSimd == 1) return filtrarPrioridadeSSE(p, n, minimo, maximo, saida);
+#endif
+    return filtrarPrioridadeEscalar(p, 0, n, minimo, maximo, saida, 0);
+}
+
+// Soma das quantidades (em 64 bits)
+long long somarQuantidades(const int *q, int n) {
+#ifdef SIMD_X86
+    if (detectarSimd() == 2) return somarAVX2(q, n);
+    if (nivelSimd == 1) return somarSSE(q, n);
+#endif
+    long long total = 0;
+    for (int i = 0; i < n; i++)
+        total += q[i];
+    return total;
+}
+
+// Menor e maior prioridade (INT_MAX/INT_MIN se n == 0)
+void minMaxPrioridade(const int *p, int n, int *menor, int *maior) {
+    *menor = INT_MAX;
+    *maior = INT_MIN;
+#ifdef SIMD_X86
+    if (detectarSimd() == 2) { minMaxAVX2(p, n, menor, maior); return; }
+    if (nivelSimd == 1) { minMaxSSE(p, n, menor, maior); return; }
+#endif
+    minMaxEscalar(p, 0, n, menor, maior);
+}
+
+// Posição da primeira ocorrência da menor prioridade (a mesma escolha do Selection Sort clássico)
+int posicaoMenorPrioridade(const int *p, int n) {
+    int menor, maior;
+    if (n <= 0)
+        return -1;
+    minMaxPrioridade(p, n, &menor, &maior);
+#ifdef SIMD_X86
+    if (nivelSimd == 2) return primeiraOcorrenciaAVX2(p, n, menor);
+    if (nivelSimd == 1) return primeiraOcorrenciaSSE(p, n, menor);
+#endif
+    for (int i = 0; i < n; i++)
+        if (p[i] == menor)
+            return i;
+    return -1;
+}
+
+// Acrescenta um nome ao pool e devolve o deslocamento
+uint32_t guardarNomePool(ColunasMochila *col, const char *nome) {
+    size_t tamanho = strlen(nome) + 1;
+    if (col->usadoPool + tamanho > col->capacidadePool) {
+        size_t nova = col->capacidadePool ? col->capacidadePool * 2 : 4096;
+        while (nova < col->usadoPool + tamanho)
+            nova *= 2;
+        char *pool = realloc(col->pool, nova);
+        if (pool == NULL) {
+            printf("\n❌ Memória insuficiente.\n");
+            exit(EXIT_FAILURE);
+        }
+        col->pool = pool;
+        col->capacidadePool = nova;
+    }
+    memcpy(col->pool + col->usadoPool, nome, tamanho);
+    col->usadoPool += tamanho;
+    return (uint32_t)(col->usadoPool - tamanho);
+}
+
+// Nome da posição lido do pool
+const char *nomeNaColuna(const ColunasMochila *col, int slot) {
+    return col->pool + col->nome[slot];
+}
+
+// Acompanha o crescimento da mochila (chamada por reservarMochila)
+void crescerColunas(Mochila *m, int capacidade) {
+    ColunasMochila *col = m->colunas;
+    if (col == NULL || capacidade <= col->capacidade)
+        return;
+    col->prioridade = realloc(col->prioridade, (size_t)capacidade * sizeof(int));
+    col->qtd = realloc(col->qtd, (size_t)capacidade * sizeof(int));
+    col->nome = realloc(col->nome, (size_t)capacidade * sizeof(uint32_t));
+    if (col->prioridade == NULL || col->qtd == NULL || col->nome == NULL) {
+        printf("\n❌ Memória insuficiente.\n");
+        exit(EXIT_FAILURE);
+    }
+    col->capacidade = capacidade;
+}
+
+// Devolve o espaço das colunas além de 'capacidade' (a mochila encolheu)
+void encolherColunas(Mochila *m, int capacidade) {
+    ColunasMochila *col = m->colunas;
+    if (col == NULL || capacidade >= col->capacidade)
+        return;
+    col->prioridade = encolherBloco(col->prioridade, (size_t)capacidade * sizeof(int));
+    col->qtd = encolherBloco(col->qtd, (size_t)capacidade * sizeof(int));
+    col->nome = encolherBloco(col->nome, (size_t)capacidade * sizeof(uint32_t));
+    col->capacidade = capacidade;
+}
+
+// Refaz as colunas e o pool a partir do vetor de componentes (descarta o espaço morto do pool)
+void reconstruirColunas(Mochila *m) {
+    ColunasMochila *col = m->colunas;
+    if (col == NULL)
+        return;
+    crescerColunas(m, m->capacidade);
+    col->usadoPool = 0;
+    col->desperdicioPool = 0;
+    for (int i = 0; i < m->qtd; i++) {
+        col->prioridade[i] = m->itens[i].prioridade;
+        col->qtd[i] = m->itens[i].qtd;
+        col->nome[i] = guardarNomePool(col, m->itens[i].nome);
+    }
+}
+
+// Copia para as colunas o componente da posição informada
+void gravarColunas(Mochila *m, int slot) {
+    ColunasMochila *col = m->colunas;
+    col->prioridade[slot] = m->itens[slot].prioridade;
+    col->qtd[slot] = m->itens[slot].qtd;
+    col->nome[slot] = guardarNomePool(col, m->itens[slot].nome);
+}
+
+// A posição vai ser sobrescrita ou removida: o nome vira espaço morto no pool,
+// compactado quando passar da metade
+void apagarDasColunas(Mochila *m, int slot) {
+    ColunasMochila *col = m->colunas;
+    col->desperdicioPool += strlen(nomeNaColuna(col, slot)) + 1;
+    if (col->desperdicioPool > MIN_COMPACTACAO_POOL && 2 * col->desperdicioPool > col->usadoPool) {
+        // Recopia os nomes vivos (exceto o que está saindo, que ainda consta no vetor)
+        char *antigo = col->pool;
+        col->pool = NULL;
+        col->capacidadePool = 0;
+        col->usadoPool = 0;
+        for (int i = 0; i < m->qtd; i++)
+            col->nome[i] = i == slot ? 0 : guardarNomePool(col, antigo + col->nome[i]);
+        free(antigo);
+        col->desperdicioPool = 0;
+    }
+}
+
+// Cria as colunas da mochila a partir do conteúdo atual
+void ativarColunas(Mochila *m) {
+    if (m->colunas != NULL)
+        return;
+    m->colunas = alocar(sizeof(ColunasMochila));
+    memset(m->colunas, 0, sizeof(ColunasMochila));
+    reconstruirColunas(m);
+}
+
+// Libera as colunas
+void liberarColunas(Mochila *m) {
+    ColunasMochila *col = m->colunas;
+    if (col == NULL)
+        return;
+    free(col->prioridade);
+    free(col->qtd);
+    free(col->nome);
+    free(col->pool);
+    free(col);
+    m->colunas = NULL;
+}
+
+// Refaz todas as estruturas auxiliares depois de mudanças no vetor inteiro (ordenação, carga)
+void reconstruirAuxiliares(Mochila *m) {
+    reconstruirIndices(m);
+    reconstruirTabelaNomes(m);
+    reconstruirColunas(m);
+    reconstruirHeap(m);
+    reconstruirResumos(m);
+}
+
+// Resumo vetorizado: soma das quantidades, faixa de prioridades e filtro por prioridade
+void analisarMochila() {
+    ColunasMochila *col = mochila.colunas;
+    if (mochila.qtd == 0 || col == NULL) {
+        printf("\nA mochila está vazia!\n");
+        return;
+    }
+    static const char *niveis[] = {"escalar", "SSE4.1", "AVX2"};
+
+    printf("\nFiltrar prioridade mínima (1 a 5): ");
+    int minimo = lerInt();
+    printf("Filtrar prioridade máxima (1 a 5): ");
+    int maximo = lerInt();
+
+    int *encontrados = alocar((size_t)mochila.qtd * sizeof(int));
+    int menor, maior;
+    double inicio = tempoMs();
+    long long total = somarQuantidades(col->qtd, mochila.qtd);
+    minMaxPrioridade(col->prioridade, mochila.qtd, &menor, &maior);
+    int k = filtrarPorPrioridade(col->prioridade, mochila.qtd, minimo, maximo, encontrados);
+    double tempo = tempoMs() - inicio;
+
+    printf("\n--- ANÁLISE DA MOCHILA (%s, %.3f ms) ---\n", niveis[detectarSimd()], tempo);
+    printf("Quantidade total de peças: %lld\n", total);
+    printf("Prioridades: mínima %d, máxima %d\n", menor, maior);
+    printf("Componentes com prioridade entre %d e %d: %d\n", minimo, maximo, k);
+    for (int i = 0; i < k && i < MAX_LISTAGEM_FILTRO; i++)
+        printf("  %-25s | prioridade %d | qtd %d\n", nomeNaColuna(col, encontrados[i]),
+               col->prioridade[encontrados[i]], col->qtd[encontrados[i]]);
+    if (k > MAX_LISTAGEM_FILTRO)
+        printf("  ... e mais %d\n", k - MAX_LISTAGEM_FILTRO);
+    free(encontrados);
+}
+
+// -------------------------------
+// FILA DE PRIORIDADE (componentes críticos)
+// -------------------------------
+// Heap de máximo indexado sobre as posições da mochila: o topo é o componente
+// mais crítico (maior prioridade; empate pelo nome). posHeap[] permite remover
+// ou reposicionar qualquer posição em O(log n), então o heap acompanha as
+// inserções, descartes e mudanças de prioridade pelos mesmos ganchos dos índices.
+
+// 1 se o componente da posição a é mais crítico que o da posição b
+int maisCritico(const Mochila *m, int a, int b) {
+    const Componente *x = &m->itens[a], *y = &m->itens[b];
+    if (x->prioridade != y->prioridade)
+        return x->prioridade > y->prioridade;
+    int r = strcmp(x->nome, y->nome);
+    return r != 0 ? r < 0 : a < b;
+}
+
+// Coloca a posição no índice i do heap, atualizando o mapa inverso
+void colocarNoHeap(HeapCriticos *h, int i, int slot) {
+    h->heap[i] = slot;
+    h->posHeap[slot] = i;
+}
+
+void subirNoHeap(const Mochila *m, int i) {
+    HeapCriticos *h = m->criticos;
+    int slot = h->heap[i];
+    while (i > 0 && maisCritico(m, slot, h->heap[(i - 1) / 2])) {
+        colocarNoHeap(h, i, h->heap[(i - 1) / 2]);
+        i = (i - 1) / 2;
+    }
+    colocarNoHeap(h, i, slot);
+}
+
+void descerNoHeap(const Mochila *m, int i) {
+    HeapCriticos *h = m->criticos;
+    int slot = h->heap[i];
+    while (2 * i + 1 < h->qtd) {
+        int filho = 2 * i + 1;
+        if (filho + 1 < h->qtd && maisCritico(m, h->heap[filho + 1], h->heap[filho]))
+            filho++;
+        if (!maisCritico(m, h->heap[filho], slot))
+            break;
+        colocarNoHeap(h, i, h->heap[filho]);
+        i = filho;
+    }
+    colocarNoHeap(h, i, slot);
+}
+
+// Acompanha o crescimento da mochila (chamada por reservarMochila)
+void crescerHeap(Mochila *m, int capacidade) {
+    HeapCriticos *h = m->criticos;
+    if (h == NULL || capacidade <= h->capacidade)
+        return;
+    h->heap = realloc(h->heap, (size_t)capacidade * sizeof(int));
+    h->posHeap = realloc(h->posHeap, (size_t)capacidade * sizeof(int));
+    if (h->heap == NULL || h->posHeap == NULL) {
+        printf("\n❌ Memória insuficiente.\n");
+        exit(EXIT_FAILURE);
+    }
+    h->capacidade = capacidade;
+}
+
+// Devolve o espaço do heap além de 'capacidade' (a mochila encolheu)
+void encolherHeap(Mochila *m, int capacidade) {
+    HeapCriticos *h = m->criticos;
+    if (h == NULL || capacidade >= h->capacidade)
+        return;
+    h->heap = encolherBloco(h->heap, (size_t)capacidade * sizeof(int));
+    h->posHeap = encolherBloco(h->posHeap, (size_t)capacidade * sizeof(int));
+    h->capacidade = capacidade;
+}
+
+// Insere a posição no heap
+void inserirNoHeap(Mochila *m, int slot) {
+    HeapCriticos *h = m->criticos;
+    colocarNoHeap(h, h->qtd++, slot);
+    subirNoHeap(m, h->qtd - 1);
+}
+
+// Retira a posição do heap (o último elemento ocupa o lugar e é reposicionado)
+void removerDoHeap(Mochila *m, int slot) {
+    HeapCriticos *h = m->criticos;
+    int i = h->posHeap[slot];
+    if (i < 0)
+        return;
+    h->posHeap[slot] = -1;
+    if (--h->qtd == i)
+        return;
+    int movido = h->heap[h->qtd];
+    colocarNoHeap(h, i, movido);
+    subirNoHeap(m, i);
+    if (h->posHeap[movido] == i)
+        descerNoHeap(m, i);
+}
+
+// Refaz o heap em O(n) (heapify de baixo para cima)
+void reconstruirHeap(Mochila *m) {
+    HeapCriticos *h = m->criticos;
+    if (h == NULL)
+        return;
+    crescerHeap(m, m->capacidade);
+    h->qtd = m->qtd;
+    for (int i = 0; i < m->qtd; i++)
+        colocarNoHeap(h, i, i);
+    for (int i = m->qtd / 2 - 1; i >= 0; i--)
+        descerNoHeap(m, i);
+}
+
+// Cria o heap de componentes críticos da mochila
+void ativarHeap(Mochila *m) {
+    if (m->criticos != NULL)
+        return;
+    m->criticos = alocar(sizeof(HeapCriticos));
+    memset(m->criticos, 0, sizeof(HeapCriticos));
+    reconstruirHeap(m);
+}
+
+// Libera o heap
+void liberarHeap(Mochila *m) {
+    if (m->criticos == NULL)
+        return;
+    free(m->criticos->heap);
+    free(m->criticos->posHeap);
+    free(m->criticos);
+    m->criticos = NULL;
+}
+
+// Posição do componente mais crítico (-1 se a mochila estiver vazia)
+int maisCriticoDaMochila(const Mochila *m) {
+    return m->criticos != NULL && m->criticos->qtd > 0 ? m->criticos->heap[0] : -1;
+}
+
+// Grava em 'saida' as posições dos k componentes mais críticos, em ordem, em O(k log k):
+// um heap auxiliar de candidatos percorre só o topo do heap principal
+int topCriticos(const Mochila *m, int k, int saida[]) {
+    const HeapCriticos *h = m->criticos;
+    if (h == NULL || h->qtd == 0 || k <= 0)
+        return 0;
+    if (k > h->qtd)
+        k = h->qtd;
+
+    // Cada retirada troca um candidato por no máximo dois, e nenhum índice se repete
+    int capacidade = k < h->qtd ? k + 1 : h->qtd;
+    int *candidatos = alocar((size_t)capacidade * sizeof(int)); // Índices do heap principal
+    int qtdCandidatos = 1, n = 0;
+    candidatos[0] = 0;
+    while (n < k) {
+        int melhor = candidatos[0]; // Retira o melhor candidato
+        saida[n++] = h->heap[melhor];
+        candidatos[0] = candidatos[--qtdCandidatos];
+        for (int i = 0; 2 * i + 1 < qtdCandidatos;) {
+            int filho = 2 * i + 1;
+            if (filho + 1 < qtdCandidatos && maisCritico(m, h->heap[candidatos[filho + 1]], h->heap[candidatos[filho]]))
+                filho++;
+            if (!maisCritico(m, h->heap[candidatos[filho]], h->heap[candidatos[i]]))
+                break;
+            int temp = candidatos[i];
+            candidatos[i] = candidatos[filho];
+            candidatos[filho] = temp;
+            i = filho;
+        }
+        // Os filhos do retirado viram candidatos
+        for (int f = 2 * melhor + 1; f <= 2 * melhor + 2 && f < h->qtd && qtdCandidatos < capacidade; f++) {
+            int i = qtdCandidatos++;
+            candidatos[i] = f;
+            while (i > 0 && maisCritico(m, h->heap[candidatos[i]], h->heap[candidatos[(i - 1) / 2]])) {
+                int temp = candidatos[i];
+                candidatos[i] = candidatos[(i - 1) / 2];
+                candidatos[(i - 1) / 2] = temp;
+                i = (i - 1) / 2;
+            }
+        }
+    }
+    free(candidatos);
+    return n;
+}
+
+// Muda a prioridade de um componente mantendo índices, colunas e heap coerentes (O(log n))
+void atualizarPrioridade(Mochila *m, int slot, int prioridade) {
+    desindexarSlot(m, slot);
+    m->itens[slot].prioridade = chavePrioridade(prioridade) + PRIORIDADE_MIN;
+    indexarSlot(m, slot);
+    registrarNoDiario(m, DIARIO_PRIORIDADE, slot);
+}
+
+// Submenu dos componentes críticos: top-k, usar o mais crítico e mudar prioridade
+void menuCriticos() {
+    printf("\n1. Ver os K componentes mais críticos\n");
+    printf("2. Usar o componente mais crítico (retira da mochila)\n");
+    printf("3. Alterar a prioridade de um componente\n");
+    printf("Opção: ");
+    int escolha = lerInt();
+
+    if (escolha == 1) {
+        printf("K: ");
+        int k = lerInt();
+        if (k <= 0) {
+            printf("\n❌ K inválido.\n");
+            return;
+        }
+        if (k > mochila.qtd) // Nunca há mais críticos do que componentes
+            k = mochila.qtd;
+        if (k == 0) {
+            printf("\nA mochila está vazia!\n");
+            return;
+        }
+        int *top = alocar((size_t)k * sizeof(int));
+        int n = topCriticos(&mochila, k, top);
+        printf("\n--- %d COMPONENTE(S) MAIS CRÍTICO(S) ---\n", n);
+        for (int i = 0; i < n; i++) {
+            const Componente *c = &mochila.itens[top[i]];
+            printf("%2d. %-25s | %-15s | prioridade %d | qtd %d\n", i + 1, c->nome, c->tipo, c->prioridade, c->qtd);
+        }
+        free(top);
+    } else if (escolha == 2) {
+        int slot = maisCriticoDaMochila(&mochila);
+        if (slot < 0) {
+            printf("\nA mochila está vazia!\n");
+            return;
+        }
+        Componente usado = mochila.itens[slot];
+        removerComponente(&mochila, slot);
+        printf("\n🔧 Componente crítico '%s' (prioridade %d) retirado para a torre de fuga.\n", usado.nome, usado.prioridade);
+    } else if (escolha == 3) {
+        char nome[TAM_NOME];
+        printf("Nome do componente: ");
+        lerString(nome, TAM_NOME);
+        int slot = posicaoPorNome(&mochila, nome);
+        if (slot < 0) {
+            printf("\n❌ Componente não encontrado.\n");
+            return;
+        }
+        printf("Nova prioridade (1 a 5): ");
+        atualizarPrioridade(&mochila, slot, lerInt());
+        printf("\n✅ Prioridade de '%s' agora é %d.\n", nome, mochila.itens[slot].prioridade);
+    } else {
+        printf("\n❌ Opção inválida.\n");
+    }
+}
+
+// -------------------------------
+// RESUMO POR TIPO
+// -------------------------------
+// Mapa tipo -> (componentes, soma das quantidades, histograma de prioridades)
+// atualizado pelos mesmos ganchos dos índices: cada adição ou descarte custa
+// O(log tipos) esperado e o relatório percorre os tipos já em ordem alfabética,
+// sem ordenar nem varrer a mochila.
+// Com o histograma, a menor e a maior prioridade de um tipo continuam exatas
+// depois de descartes.
+
+// Soma o componente da posição ao resumo do seu tipo (cria o tipo se for novo)
+void somarAoResumo(Mochila *m, int slot) {
+    const Componente *c = &m->itens[slot];
+    ResumoTipo *r = ResumosPorTipo_buscar(m->resumos, c->tipo);
+    if (r == NULL) {
+        ResumoTipo vazio;
+        memset(&vazio, 0, sizeof(vazio));
+        vazio.tipo = alocar(strlen(c->tipo) + 1);
+        strcpy(vazio.tipo, c->tipo);
+        r = ResumosPorTipo_obter(m->resumos, vazio.tipo, vazio, NULL);
+    }
+    r->componentes++;
+    r->totalQtd += c->qtd;
+    r->porPrioridade[chavePrioridade(c->prioridade)]++;
+}
+
+// Retira o componente da posição do resumo do seu tipo (o tipo some quando esvazia)
+void subtrairDoResumo(Mochila *m, int slot) {
+    const Componente *c = &m->itens[slot];
+    ResumoTipo *r = ResumosPorTipo_buscar(m->resumos, c->tipo);
+    if (r == NULL) // Componente fora do resumo (não deveria acontecer)
+        return;
+    r->componentes--;
+    r->totalQtd -= c->qtd;
+    r->porPrioridade[chavePrioridade(c->prioridade)]--;
+    if (r->componentes == 0) {
+        char *tipo = r->tipo;
+        ResumosPorTipo_remover(m->resumos, tipo);
+        free(tipo);
+    }
+}
+
+// Libera as cópias dos tipos da subárvore (pela estrutura: o percurso em ordem
+// compararia chaves já liberadas)
+void liberarTiposDoResumo(ResumosPorTipo *resumos, int no) {
+    if (no < 0)
+        return;
+    liberarTiposDoResumo(resumos, resumos->nos[no].esq);
+    liberarTiposDoResumo(resumos, resumos->nos[no].dir);
+    free(resumos->nos[no].valor.tipo);
+}
+
+// Esvazia o resumo, liberando as cópias dos tipos
+void esvaziarResumos(ResumosPorTipo *resumos) {
+    liberarTiposDoResumo(resumos, resumos->raiz);
+    ResumosPorTipo_liberar(resumos);
+}
+
+// Refaz o resumo do zero (após carregar ou compactar o vetor inteiro)
+void reconstruirResumos(Mochila *m) {
+    if (m->resumos == NULL)
+        return;
+    esvaziarResumos(m->resumos);
+    for (int i = 0; i < m->qtd; i++)
+        somarAoResumo(m, i);
+}
+
+// Cria o resumo por tipo a partir do conteúdo atual
+void ativarResumos(Mochila *m) {
+    if (m->resumos != NULL)
+        return;
+    m->resumos = alocar(sizeof(ResumosPorTipo));
+    ResumosPorTipo_iniciar(m->resumos);
+    reconstruirResumos(m);
+}
+
+// Libera o resumo por tipo
+void liberarResumos(Mochila *m) {
+    if (m->resumos == NULL)
+        return;
+    esvaziarResumos(m->resumos);
+    free(m->resumos);
+    m->resumos = NULL;
+}
+
+// Resumos de todos os tipos em ordem alfabética (o chamador libera o vetor); devolve quantos
+int listarResumos(const Mochila *m, const ResumoTipo ***saida) {
+    const ResumosPorTipo *resumos = m->resumos;
+    int n = 0;
+    if (resumos == NULL) {
+        *saida = NULL;
+        return 0;
+    }
+    const ResumoTipo **lista = alocar((size_t)(resumos->qtd > 0 ? resumos->qtd : 1) * sizeof(*lista));
+    for (int no = ResumosPorTipo_primeiro(resumos); no >= 0; no = ResumosPorTipo_seguinte(resumos, no))
+        lista[n++] = &resumos->nos[no].valor;
+    *saida = lista;
+    return n;
+}
+
+// Menor e maior prioridade presentes no histograma de um tipo
+void faixaDoResumo(const ResumoTipo *r, int *menor, int *maior) {
+    int faixas = PRIORIDADE_MAX - PRIORIDADE_MIN + 1, p = 0, q = faixas - 1;
+    while (p < faixas - 1 && r->porPrioridade[p] == 0)
+        p++;
+    while (q > 0 && r->porPrioridade[q] == 0)
+        q--;
+    *menor = p + PRIORIDADE_MIN;
+    *maior = q + PRIORIDADE_MIN;
+}
+
+// Relatório por tipo: componentes, quantidade total e faixa de prioridades
+void mostrarResumoPorTipo() {
+    if (mochila.qtd == 0 || mochila.resumos == NULL) {
+        printf("\nA mochila está vazia!\n");
+        return;
+    }
+    double inicio = tempoMs();
+    const ResumoTipo **lista;
+    int n = listarResumos(&mochila, &lista);
+    double tempo = tempoMs() - inicio;
+
+    printf("\n--- RESUMO POR TIPO (%d tipos, %d itens, %.3f ms) ---\n", n, mochila.qtd, tempo);
+    printf("-------------------------------------------------------------------------------\n");
+    printf("%-15s | %-12s | %-14s | %-8s | %-8s\n", "TIPO", "COMPONENTES", "QTD TOTAL", "PRIO MIN", "PRIO MAX");
+    printf("-------------------------------------------------------------------------------\n");
+    for (int i = 0; i < n; i++) {
+        int menor, maior;
+        faixaDoResumo(lista[i], &menor, &maior);
+        printf("%-15s | %-12d | %-14lld | %-8d | %-8d\n", lista[i]->tipo, lista[i]->componentes,
+               lista[i]->totalQtd, menor, maior);
+    }
+    printf("-------------------------------------------------------------------------------\n");
+    free(lista);
+}
+
+// -------------------------------
+// CARGA ÓTIMA (mochila 0/1)
+// -------------------------------
+// Escolhe quais componentes levar sob um limite de espaços (cada peça ocupa um
+// espaço: peso = qtd) maximizando a soma de prioridade × qtd. Até LIMITE_DP_CARGA
+// espaços resolve por programação dinâmica em duas camadas, vetorizada, com um
+// bit de decisão por (item, capacidade) para reconstruir a escolha; acima disso,
+// ou se os bits não couberem em LIMITE_BYTES_DECISAO, usa branch-and-bound com
+// limite fracionário (a razão valor/peso é a própria prioridade).
+
+typedef struct {
+    int slot;
+    int peso;
+    long long valor;
+} ItemCarga;
+
+typedef enum {
+    CARGA_TUDO,        // Tudo cabe: nada a otimizar
+    CARGA_DINAMICA,    // Programação dinâmica (ótimo)
+    CARGA_BRANCH,      // Branch-and-bound completo (ótimo)
+    CARGA_APROXIMADA   // Branch-and-bound interrompido em LIMITE_NOS_CARGA (melhor encontrada)
+} MetodoCarga;
+
+// Uma camada da programação dinâmica a partir de w = inicio:
+// atual[w] = max(anterior[w], anterior[w - peso] + valor), com o bit de decisão em 'decisao'
+void camadaCargaEscalar(const int *anterior, int *atual, uint8_t *decisao, int inicio, int capacidade, int peso, int valor) {
+    for (int w = inicio; w <= capacidade; w++) {
+        int com = anterior[w - peso] + valor;
+        if (com > anterior[w]) {
+            atual[w] = com;
+            decisao[w >> 3] |= (uint8_t)(1u << (w & 7));
+        } else {
+            atual[w] = anterior[w];
+        }
+    }
+}
+
+#ifdef SIMD_X86
+// Blocos de 8 capacidades alinhados a 8: cada bloco grava um byte inteiro de decisões
+__attribute__((target("avx2")))
+int camadaCargaAVX2(const int *anterior, int *atual, uint8_t *decisao, int w, int capacidade, int peso, int valor) {
+    __m256i vValor = _mm256_set1_epi32(valor);
+    for (; w + 7 <= capacidade; w += 8) {
+        __m256i sem = _mm256_loadu_si256((const __m256i *)(anterior + w));
+        __m256i com = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(anterior + w - peso)), vValor);
+        _mm256_storeu_si256((__m256i *)(atual + w), _mm256_max_epi32(sem, com));
+        decisao[w >> 3] = (uint8_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(com, sem)));
+    }
+    return w;
+}
+
+__attribute__((target("sse4.1")))
+int camadaCargaSSE(const int *anterior, int *atual, uint8_t *decisao, int w, int capacidade, int peso, int valor) {
+    __m128i vValor = _mm_set1_epi32(valor);
+    for (; w + 7 <= capacidade; w += 8) {
+        unsigned bits = 0;
+        for (int metade = 0; metade < 2; metade++) {
+            int base = w + 4 * metade;
+            __m128i sem = _mm_loadu_si128((const __m128i *)(anterior + base));
+            __m128i com = _mm_add_epi32(_mm_loadu_si128((const __m128i *)(anterior + base - peso)), vValor);
+            _mm_storeu_si128((__m128i *)(atual + base), _mm_max_epi32(sem, com));
+            bits |= (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(com, sem))) << (4 * metade);
+        }
+        decisao[w >> 3] = (uint8_t)bits;
+    }
+    return w;
+}
+#endif
+
+// Aplica um item à tabela: copia as capacidades menores que o peso e relaxa o resto
+void camadaCarga(const int *anterior, int *atual, uint8_t *decisao, int capacidade, int peso, int valor) {
+    memcpy(atual, anterior, (size_t)peso * sizeof(int));
+    int w = peso;
+#ifdef SIMD_X86
+    if (detectarSimd() > 0) {
+        int alinhado = (peso + 7) & ~7;
+        if (alinhado > capacidade + 1)
+            alinhado = capacidade + 1;
+        camadaCargaEscalar(anterior, atual, decisao, w, alinhado - 1, peso, valor);
+        w = nivelSimd == 2 ? camadaCargaAVX2(anterior, atual, decisao, alinhado, capacidade, peso, valor)
+                           : camadaCargaSSE(anterior, atual, decisao, alinhado, capacidade, peso, valor);
+    }
+#endif
+    camadaCargaEscalar(anterior, atual, decisao, w, capacidade, peso, valor);
+}
+
+// Programação dinâmica 0/1; devolve o valor ótimo e marca os escolhidos
+long long cargaDinamica(const ItemCarga *itens, int n, int capacidade, char *escolhido) {
+    size_t bytesLinha = (size_t)capacidade / 8 + 1;
+    uint8_t *decisao = calloc((size_t)n, bytesLinha);
+    int *anterior = calloc((size_t)capacidade + 1, sizeof(int));
+    int *atual = alocar(((size_t)capacidade + 1) * sizeof(int));
+    if (decisao == NULL || anterior == NULL) {
+        printf("\n❌ Memória insuficiente.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < n; i++) {
+        camadaCarga(anterior, atual, decisao + (size_t)i * bytesLinha, capacidade, itens[i].peso, (int)itens[i].valor);
+        int *temp = anterior;
+        anterior = atual;
+        atual = temp;
+    }
+    long long melhor = anterior[capacidade];
+
+    // Reconstrução: do último item para o primeiro, seguindo os bits de decisão
+    for (int i = n - 1, w = capacidade; i >= 0; i--) {
+        const uint8_t *linha = decisao + (size_t)i * bytesLinha;
+        if (linha[w >> 3] & (1u << (w & 7))) {
+            escolhido[itens[i].slot] = 1;
+            w -= itens[i].peso;
+        }
+    }
+    free(decisao);
+    free(anterior);
+    free(atual);
+    return melhor;
+}
+
+int compararItensCarga(const void *a, const void *b) {
+    const ItemCarga *x = a, *y = b;
+    long long rx = x->valor / x->peso, ry = y->valor / y->peso; // Razão = prioridade (exata)
+    if (rx != ry)
+        return rx > ry ? -1 : 1;
+    return (y->peso > x->peso) - (y->peso < x->peso);
+}
+
+// Limite superior fracionário para os itens [i, n) com 'resto' espaços livres,
+// usando as somas prefixadas de peso e valor da ordem por razão decrescente
+long long limiteFracionario(const ItemCarga *itens, const long long *pesoAcum, const long long *valorAcum,
+                            int n, int i, long long resto) {
+    int ini = i, fim = n; // Maior k com pesoAcum[k] - pesoAcum[i] <= resto
+    while (ini < fim) {
+        int meio = ini + (fim - ini + 1) / 2;
+        if (pesoAcum[meio] - pesoAcum[i] <= resto) ini = meio;
+        else fim = meio - 1;
+    }
+    long long limite = valorAcum[ini] - valorAcum[i];
+    if (ini < n)
+        limite += (resto - (pesoAcum[ini] - pesoAcum[i])) * (itens[ini].valor / itens[ini].peso);
+    return limite;
+}
+
+// Branch-and-bound em profundidade (inclui primeiro), iterativo para aguentar milhões de itens
+MetodoCarga cargaBranchAndBound(ItemCarga *itens, int n, long long capacidade, char *escolhido, long long *valorOtimo) {
+    qsort(itens, (size_t)n, sizeof(ItemCarga), compararItensCarga);
+    long long *pesoAcum = alocar(((size_t)n + 1) * sizeof(long long));
+    long long *valorAcum = alocar(((size_t)n + 1) * sizeof(long long));
+    char *atual = alocar((size_t)n + 1);
+    char *melhor = calloc((size_t)n + 1, 1);
+    if (melhor == NULL) {
+        printf("\n❌ Memória insuficiente.\n");
+        exit(EXIT_FAILURE);
+    }
+    pesoAcum[0] = valorAcum[0] = 0;
+    for (int i = 0; i < n; i++) {
+        pesoAcum[i + 1] = pesoAcum[i] + itens[i].peso;
+        valorAcum[i + 1] = valorAcum[i] + itens[i].valor;
+    }
+
+    long long peso = 0, valor = 0, melhorValor = -1, nos = 0;
+    int i = 0;
+    MetodoCarga metodo = CARGA_BRANCH;
+    for (;;) {
+        // Avança incluindo o que couber, até o fim ou até o limite não superar a melhor
+        while (i < n && valor + limiteFracionario(itens, pesoAcum, valorAcum, n, i, capacidade - peso) > melhorValor) {
+            atual[i] = peso + itens[i].peso <= capacidade;
+            if (atual[i]) {
+                peso += itens[i].peso;
+                valor += itens[i].valor;
+            }
+            i++;
+            nos++;
+        }
+        if (i == n && valor > melhorValor) {
+            melhorValor = valor;
+            memcpy(melhor, atual, (size_t)n);
+        }
+        if (nos >= LIMITE_NOS_CARGA) {
+            metodo = CARGA_APROXIMADA;
+            break;
+        }
+        // Volta até o último item incluído e explora o ramo sem ele
+        int j = i - 1;
+        while (j >= 0 && !atual[j])
+            j--;
+        if (j < 0)
+            break;
+        atual[j] = 0;
+        peso -= itens[j].peso;
+        valor -= itens[j].valor;
+        i = j + 1;
+    }
+
+    for (int k = 0; k < n; k++)
+        if (melhor[k])
+            escolhido[itens[k].slot] = 1;
+    *valorOtimo = melhorValor;
+    free(pesoAcum);
+    free(valorAcum);
+    free(atual);
+    free(melhor);
+    return metodo;
+}
+
+// Carga ótima da mochila para 'capacidade' espaços; escolhido[posição] = 1 para os levados
+MetodoCarga otimizarCarga(const Mochila *m, long long capacidade, char *escolhido, long long *valorTotal, long long *pesoTotal) {
+    memset(escolhido, 0, (size_t)m->qtd);
+    ItemCarga *itens = alocar((size_t)(m->qtd > 0 ? m->qtd : 1) * sizeof(ItemCarga));
+    int n = 0;
+    long long somaPesos = 0;
+    for (int i = 0; i < m->qtd; i++) {
+        const Componente *c = &m->itens[i];
+        if (c->qtd <= 0 || c->qtd > capacidade || c->prioridade <= 0)
+            continue; // Não ocupa espaço, não cabe ou não vale nada
+        itens[n].slot = i;
+        itens[n].peso = c->qtd;
+        itens[n].valor = (long long)c->prioridade * c->qtd;
+        somaPesos += c->qtd;
+        n++;
+    }
+
+    MetodoCarga metodo;
+    if (somaPesos <= capacidade) {
+        for (int i = 0; i < n; i++)
+            escolhido[itens[i].slot] = 1;
+        metodo = CARGA_TUDO;
+    } else if (capacidade <= LIMITE_DP_CARGA &&
+               (double)n * (double)(capacidade / 8 + 1) <= LIMITE_BYTES_DECISAO) {
+        cargaDinamica(itens, n, (int)capacidade, escolhido);
+        metodo = CARGA_DINAMICA;
+    } else {
+        long long valor;
+        metodo = cargaBranchAndBound(itens, n, capacidade, escolhido, &valor);
+    }
+    free(itens);
+
+    *valorTotal = *pesoTotal = 0;
+    for (int i = 0; i < m->qtd; i++) {
+        if (escolhido[i]) {
+            *valorTotal += (long long)m->itens[i].prioridade * m->itens[i].qtd;
+            *pesoTotal += m->itens[i].qtd;
+        }
+    }
+    return metodo;
+}
+
+// Menu: planeja a carga ótima para um limite de espaços informado
+void planejarCarga() {
+    static const char *metodos[] = {"tudo cabe", "programação dinâmica", "branch-and-bound",
+                                    "branch-and-bound interrompido (melhor encontrada)"};
+    if (mochila.qtd == 0) {
+        printf("\nA mochila está vazia!\n");
+        return;
+    }
+    printf("\nLimite de espaços (peças) para levar: ");
+    int capacidade = lerInt();
+    if (capacidade <= 0) {
+        printf("\n❌ Limite inválido.\n");
+        return;
+    }
+
+    char *escolhido = alocar((size_t)mochila.qtd);
+    long long valor, peso;
+    double inicio = tempoMs();
+    MetodoCarga metodo = otimizarCarga(&mochila, capacidade, escolhido, &valor, &peso);
+    double tempo = tempoMs() - inicio;
+
+    printf("\n--- CARGA ÓTIMA (%s, %.3f ms) ---\n", metodos[metodo], tempo);
+    printf("Espaços usados: %lld de %d | valor total (prioridade x qtd): %lld\n", peso, capacidade, valor);
+    int listados = 0, levados = 0;
+    for (int i = 0; i < mochila.qtd; i++) {
+        if (!escolhido[i])
+            continue;
+        levados++;
+        if (listados++ < MAX_LISTAGEM_FILTRO)
+            printf("  %-25s | prioridade %d | qtd %d\n", mochila.itens[i].nome,
+                   mochila.itens[i].prioridade, mochila.itens[i].qtd);
+    }
+    if (levados > MAX_LISTAGEM_FILTRO)
+        printf("  ... e mais %d\n", levados - MAX_LISTAGEM_FILTRO);
+    printf("Componentes levados: %d de %d\n", levados, mochila.qtd);
+    free(escolhido);
+}
+
+// -------------------------------
+// BUSCA POR PREFIXO E APROXIMADA
+// -------------------------------
+// Prefixo: faixa contígua do índice de nome sem caso (descida até o primeiro
+// nome >= prefixo e percurso em ordem enquanto o prefixo casar), em
+// O(log n + resultados). Aproximada: índice de trigramas dos nomes distintos em
+// minúsculas. Cada edição destrói no máximo 3 trigramas do texto buscado, então
+// com distância k todo nome no raio contém ao menos um de quaisquer 3k + 1
+// deles: só as 3k + 1 listas mais curtas são percorridas e os candidatos são
+// conferidos pela distância de edição. Nomes descartados viram lápides e o
+// índice é refeito na próxima consulta quando elas passam da metade ou depois
+// de uma carga em lote. Maiúsculas são ignoradas só em ASCII.
+
+// Copia o nome em minúsculas
+void nomeMinusculo(const char *nome, char destino[TAM_NOME]) {
+    int i = 0;
+    for (; i < TAM_NOME - 1 && nome[i] != '\0'; i++)
+        destino[i] = (char)tolower((unsigned char)nome[i]);
+    destino[i] = '\0';
+}
+
+// Distância de edição (Levenshtein) entre dois nomes, limitada: devolve
+// limite + 1 assim que nenhuma célula da linha ficar dentro do limite. Prefixo e
+// sufixo comuns são descartados antes da tabela, que usa uma única linha.
+int distanciaEdicao(const char *a, const char *b, int limite) {
+    int la = (int)strlen(a), lb = (int)strlen(b);
+    while (la > 0 && lb > 0 && *a == *b) {
+        a++;
+        b++;
+        la--;
+        lb--;
+    }
+    while (la > 0 && lb > 0 && a[la - 1] == b[lb - 1]) {
+        la--;
+        lb--;
+    }
+    if (abs(la - lb) > limite)
+        return limite + 1;
+    if (la == 0 || lb == 0)
+        return la + lb;
+
+    int linha[TAM_NOME + 1];
+    for (int j = 0; j <= lb; j++)
+        linha[j] = j;
+    for (int i = 1; i <= la; i++) {
+        int diagonal = linha[0], menorDaLinha = i;
+        linha[0] = i;
+        for (int j = 1; j <= lb; j++) {
+            int acima = linha[j];
+            int melhor = diagonal + (a[i - 1] != b[j - 1]);
+            if (acima + 1 < melhor) melhor = acima + 1;
+            if (linha[j - 1] + 1 < melhor) melhor = linha[j - 1] + 1;
+            linha[j] = melhor;
+            diagonal = acima;
+            if (melhor < menorDaLinha) menorDaLinha = melhor;
+        }
+        if (menorDaLinha > limite)
+            return limite + 1;
+    }
+    return linha[lb] <= limite ? linha[lb] : limite + 1;
+}
+
+// Grava até 'limite' posições cujo nome casa com os 'tamanho' primeiros bytes
+// de 'texto' sem diferenciar maiúsculas, em ordem alfabética (tamanho >= TAM_NOME
+// = nome inteiro). Devolve quantas gravou.
+int faixaSemCaso(const Mochila *m, const char *texto, size_t tamanho, int saida[], int limite) {
+    const IndicesMochila *ind = m->indices;
+    if (ind == NULL || m->qtd == 0 || limite <= 0)
+        return 0;
+    const int *esq = ind->esq[CAMPO_NOME_SEM_CASO], *dir = ind->dir[CAMPO_NOME_SEM_CASO];
+    int *pilha = ind->pilha; // Nunca passa da altura da treap, que é no máximo m->qtd
+    int topo = 0, n = 0, no = ind->raiz[CAMPO_NOME_SEM_CASO];
+
+    // Desce até o primeiro nome >= texto, empilhando onde seguiu para a esquerda
+    while (no >= 0) {
+        if (strncasecmp(m->itens[no].nome, texto, tamanho) < 0) {
+            no = dir[no];
+        } else {
+            pilha[topo++] = no;
+            no = esq[no];
+        }
+    }
+    // Sucessores em ordem até o primeiro nome fora da faixa
+    while (topo > 0 && n < limite) {
+        no = pilha[--topo];
+        if (strncasecmp(m->itens[no].nome, texto, tamanho) != 0)
+            break;
+        saida[n++] = no;
+        for (no = dir[no]; no >= 0; no = esq[no])
+            pilha[topo++] = no;
+    }
+    return n;
+}
+
+// Posições cujo nome começa com 'prefixo' (sem diferenciar maiúsculas), até 'limite'
+int buscarPorPrefixo(const Mochila *m, const char *prefixo, int saida[], int limite) {
+    return faixaSemCaso(m, prefixo, strlen(prefixo), saida, limite);
+}
+
+// Chave de um trigrama (três bytes)
+uint32_t chaveTrigrama(const char *s) {
+    return (uint32_t)(unsigned char)s[0] << 16 | (uint32_t)(unsigned char)s[1] << 8 | (unsigned char)s[2];
+}
+
+// Lista de entradas do trigrama (NULL se não existe e 'criar' for 0)
+ListaTrigrama *listaDoTrigrama(IndiceTrigramas *t, uint32_t trigrama, int criar) {
+    if (!criar)
+        return MapaTrigramas_buscar(&t->listas, trigrama);
+    ListaTrigrama vazia;
+    ListaTrigrama_iniciar(&vazia);
+    return MapaTrigramas_obter(&t->listas, trigrama, vazia, NULL);
+}
+
+// Entrada do nome (já em minúsculas); com 'criar', acrescenta uma entrada nova
+// (lápide até ser contada) e a registra nas listas dos seus trigramas
+int entradaDoNome(IndiceTrigramas *t, const char chave[TAM_NOME], int criar) {
+    if (criar && (t->qtd + 1) * 10 > t->capacidadeHash * 7) {
+        int capacidade = t->capacidadeHash > 0 ? t->capacidadeHash * 2 : CAPACIDADE_INICIAL_HASH;
+        free(t->hashEntradas);
+        t->hashEntradas = alocar((size_t)capacidade * sizeof(int));
+        memset(t->hashEntradas, 0xFF, (size_t)capacidade * sizeof(int)); // Tudo -1
+        t->capacidadeHash = capacidade;
+        for (int e = 0; e < t->qtd; e++) {
+            int j = (int)(hashNome(t->nome[e]) & (uint32_t)(capacidade - 1));
+            while (t->hashEntradas[j] >= 0)
+                j = (j + 1) & (capacidade - 1);
+            t->hashEntradas[j] = e;
+        }
+    }
+    if (t->capacidadeHash == 0)
+        return -1;
+
+    int mascara = t->capacidadeHash - 1;
+    int i = (int)(hashNome(chave) & (uint32_t)mascara);
+    for (; t->hashEntradas[i] >= 0; i = (i + 1) & mascara)
+        if (strcmp(t->nome[t->hashEntradas[i]], chave) == 0)
+            return t->hashEntradas[i];
+    if (!criar)
+        return -1;
+
+    if (t->qtd == t->capacidade) {
+        int capacidade = t->capacidade > 0 ? t->capacidade * 2 : CAPACIDADE_INICIAL;
+        t->nome = realloc(t->nome, (size_t)capacidade * TAM_NOME);
+        t->tamanho = realloc(t->tamanho, (size_t)capacidade);
+        t->vivos = realloc(t->vivos, (size_t)capacidade * sizeof(int));
+        t->marcas = realloc(t->marcas, (size_t)capacidade * sizeof(MarcaEntrada));
+        t->achados = realloc(t->achados, (size_t)capacidade * sizeof(int));
+        t->distAchados = realloc(t->distAchados, (size_t)capacidade * sizeof(int));
+        if (!t->nome || !t->tamanho || !t->vivos || !t->marcas || !t->achados || !t->distAchados) {
+            printf("\n❌ Memória insuficiente.\n");
+            exit(EXIT_FAILURE);
+        }
+        t->capacidade = capacidade;
+    }
+    int e = t->qtd++;
+    memcpy(t->nome[e], chave, TAM_NOME);
+    t->tamanho[e] = (unsigned char)strlen(chave);
+    t->vivos[e] = 0;
+    t->marcas[e].consulta = 0;
+    t->lapides++;
+    t->hashEntradas[i] = e;
+
+    for (int p = 0; p + 3 <= t->tamanho[e]; p++) {
+        ListaTrigrama *l = listaDoTrigrama(t, chaveTrigrama(chave + p), 1);
+        if (l->qtd > 0 && *ListaTrigrama_ultimo(l) == e)
+            continue; // Trigrama repetido no mesmo nome
+        ListaTrigrama_acrescentar(l, e);
+    }
+    return e;
+}
+
+// Conta mais um componente com o nome (revive a lápide, se houver)
+void inserirNoIndiceTrigramas(IndiceTrigramas *t, const char *nome) {
+    char chave[TAM_NOME];
+    nomeMinusculo(nome, chave);
+    int e = entradaDoNome(t, chave, 1);
+    if (t->vivos[e]++ == 0)
+        t->lapides--;
+}
+
+// Desconta um componente com o nome (a entrada vira lápide quando zera)
+void removerDoIndiceTrigramas(IndiceTrigramas *t, const char *nome) {
+    char chave[TAM_NOME];
+    nomeMinusculo(nome, chave);
+    int e = entradaDoNome(t, chave, 0);
+    if (e >= 0 && t->vivos[e] > 0 && --t->vivos[e] == 0)
+        t->lapides++;
+}
+
+// Refaz o índice com os nomes atuais da mochila
+void reconstruirIndiceTrigramas(Mochila *m) {
+    IndiceTrigramas *t = m->trigramas;
+    t->qtd = 0;
+    t->lapides = 0;
+    t->desatualizada = 0;
+    if (t->capacidadeHash > 0)
+        memset(t->hashEntradas, 0xFF, (size_t)t->capacidadeHash * sizeof(int));
+    for (int i = 0; i < t->listas.capacidade; i++)
+        if (t->listas.hashes[i] != 0)
+            t->listas.valores[i].qtd = 0; // Mantém as chaves e a memória das listas
+    for (int i = 0; i < m->qtd; i++)
+        inserirNoIndiceTrigramas(t, m->itens[i].nome);
+}
+
+// Marca o índice para ser refeito na próxima consulta (mudanças no vetor inteiro)
+void invalidarIndiceTrigramas(Mochila *m) {
+    if (m->trigramas != NULL)
+        m->trigramas->desatualizada = 1;
+}
+
+// Cria o índice de trigramas da mochila; a construção fica para a primeira consulta
+void ativarIndiceTrigramas(Mochila *m) {
+    if (m->trigramas != NULL)
+        return;
+    m->trigramas = alocar(sizeof(IndiceTrigramas));
+    memset(m->trigramas, 0, sizeof(IndiceTrigramas));
+    m->trigramas->desatualizada = 1;
+}
+
+// Libera o índice de trigramas
+void liberarIndiceTrigramas(Mochila *m) {
+    IndiceTrigramas *t = m->trigramas;
+    if (t == NULL)
+        return;
+    for (int i = 0; i < t->listas.capacidade; i++)
+        if (t->listas.hashes[i] != 0)
+            ListaTrigrama_liberar(&t->listas.valores[i]);
+    MapaTrigramas_liberar(&t->listas);
+    free(t->hashEntradas);
+    free(t->nome);
+    free(t->tamanho);
+    free(t->vivos);
+    free(t->marcas);
+    free(t->achados);
+    free(t->distAchados);
+    free(t);
+    m->trigramas = NULL;
+}
+
+// Conta mais uma lista da entrada; ao chegar a 'minimo' listas, confere a
+// distância e guarda a entrada se estiver dentro do raio
+void conferirCandidato(IndiceTrigramas *t, int e, int minimo, const char *chave, int tamanho, int maxDistancia,
+                       int achados[], int distAchados[], int *qtdAchados) {
+    MarcaEntrada *marca = &t->marcas[e];
+    if (marca->consulta != t->consulta) {
+        marca->consulta = t->consulta;
+        marca->acertos = 0;
+    }
+    if (++marca->acertos != minimo)
+        return;
+    if (t->vivos[e] == 0 || abs(t->tamanho[e] - tamanho) > maxDistancia)
+        return;
+    int d = distanciaEdicao(chave, t->nome[e], maxDistancia);
+    if (d <= maxDistancia) {
+        achados[*qtdAchados] = e;
+        distAchados[(*qtdAchados)++] = d;
+    }
+}
+
+// Posições cujo nome está a no máximo 'maxDistancia' edições de 'texto', sem
+// diferenciar maiúsculas; mais próximas primeiro. distancias[i] recebe a
+// distância de saida[i]. Devolve quantas gravou (até 'limite').
+int buscarAproximado(Mochila *m, const char *texto, int maxDistancia, int saida[], int distancias[], int limite) {
+    IndiceTrigramas *t = m->trigramas;
+    if (t == NULL || limite <= 0)
+        return 0;
+    if (t->desatualizada || (t->lapides > MIN_LAPIDES_TRIGRAMAS && t->lapides * 2 > t->qtd))
+        reconstruirIndiceTrigramas(m);
+    if (t->qtd == 0)
+        return 0;
+
+    char chave[TAM_NOME];
+    nomeMinusculo(texto, chave);
+    int tamanho = (int)strlen(chave);
+    int *achados = t->achados, *distAchados = t->distAchados; // Cabem todas as entradas
+    int qtdAchados = 0;
+    t->consulta++;
+
+    int necessarias = 3 * maxDistancia + 1; // Cada edição destrói no máximo 3 trigramas
+    int total = tamanho - 2;
+    if (maxDistancia == 0) {
+        // Só o nome exato (sem caso): direto pela tabela de entradas
+        int e = entradaDoNome(t, chave, 0);
+        if (e >= 0)
+            conferirCandidato(t, e, 1, chave, tamanho, 0, achados, distAchados, &qtdAchados);
+    } else if (total >= necessarias) {
+        // Listas dos trigramas do texto, da mais curta para a mais longa
+        ListaTrigrama *listas[TAM_NOME];
+        int tamanhos[TAM_NOME];
+        for (int p = 0; p < total; p++) {
+            ListaTrigrama *l = listaDoTrigrama(t, chaveTrigrama(chave + p), 0);
+            int q = l ? l->qtd : 0, i = p;
+            for (; i > 0 && tamanhos[i - 1] > q; i--) {
+                listas[i] = listas[i - 1];
+                tamanhos[i] = tamanhos[i - 1];
+            }
+            listas[i] = l;
+            tamanhos[i] = q;
+        }
+        // Das 'usadas' listas percorridas, todo nome no raio está em pelo menos
+        // usadas - 3k. Listas baratas além do mínimo elevam esse piso e poupam
+        // distâncias de candidatos que só dividem um trigrama por acaso.
+        int usadas = necessarias;
+        while (usadas < total && tamanhos[usadas] <= 2 * tamanhos[necessarias - 1])
+            usadas++;
+        int minimo = usadas - 3 * maxDistancia;
+        for (int i = 0; i < usadas; i++)
+            for (int k = 0; k < tamanhos[i]; k++)
+                conferirCandidato(t, listas[i]->itens[k], minimo, chave, tamanho, maxDistancia,
+                                  achados, distAchados, &qtdAchados);
+    } else {
+        // Texto curto demais para o filtro: varre as entradas (o tamanho descarta a maioria)
+        for (int e = 0; e < t->qtd; e++)
+            conferirCandidato(t, e, 1, chave, tamanho, maxDistancia, achados, distAchados, &qtdAchados);
+    }
+
+    // Nome -> posições pelo índice sem caso, da menor distância para a maior
+    int n = 0;
+    for (int d = 0; d <= maxDistancia && n < limite; d++) {
+        for (int i = 0; i < qtdAchados && n < limite; i++) {
+            if (distAchados[i] != d)
+                continue;
+            int k = faixaSemCaso(m, t->nome[achados[i]], TAM_NOME, saida + n, limite - n);
+            for (int j = 0; j < k; j++)
+                distancias[n + j] = d;
+            n += k;
+        }
+    }
+    return n;
+}
+
+// Menu: "texto*" busca por prefixo; sem o asterisco, busca aproximada
+void buscarNomesFlexivel() {
+    char texto[TAM_NOME];
+    printf("\nNome ou prefixo terminado em * (ex.: Chip*): ");
+    lerString(texto, TAM_NOME);
+    size_t tamanho = strlen(texto);
+    if (tamanho == 0) {
+        printf("\n❌ Texto vazio.\n");
+        return;
+    }
+
+    int *saida = alocar((MAX_LISTAGEM_FILTRO + 1) * sizeof(int));
+    int distancias[MAX_LISTAGEM_FILTRO + 1];
+    int n, prefixo = texto[tamanho - 1] == '*';
+    double inicio;
+    if (prefixo) {
+        texto[tamanho - 1] = '\0';
+        inicio = tempoMs();
+        n = buscarPorPrefixo(&mochila, texto, saida, MAX_LISTAGEM_FILTRO + 1);
+    } else {
+        printf("Distância máxima de edição (0 a %d): ", MAX_DISTANCIA_BUSCA);
+        int maxDistancia = lerInt();
+        if (maxDistancia < 0 || maxDistancia > MAX_DISTANCIA_BUSCA) {
+            printf("\n❌ Distância inválida.\n");
+            free(saida);
+            return;
+        }
+        inicio = tempoMs();
+        n = buscarAproximado(&mochila, texto, maxDistancia, saida, distancias, MAX_LISTAGEM_FILTRO + 1);
+    }
+    double tempo = tempoMs() - inicio;
+
+    printf("\n--- RESULTADOS (%s, %.1f µs) ---\n", prefixo ? "prefixo" : "aproximada", tempo * 1e3);
+    if (n == 0)
+        printf("Nenhum componente encontrado.\n");
+    for (int i = 0; i < n && i < MAX_LISTAGEM_FILTRO; i++) {
+        const Componente *c = &mochila.itens[saida[i]];
+        printf("  %-25s | %-15s | prioridade %d | qtd %d", c->nome, c->tipo, c->prioridade, c->qtd);
+        if (!prefixo)
+            printf(" | distância %d", distancias[i]);
+        printf("\n");
+    }
+    if (n > MAX_LISTAGEM_FILTRO)
+        printf("  ... e mais\n");
+    free(saida);
+}
+
+// -------------------------------
+// DESCARTE EM LOTE
+// -------------------------------
+
+// Remove vários componentes de uma vez (um por nome informado) com uma única
+// passada de compactação. A compactação é estável, então a ordem relativa dos
+// que ficam se mantém (inclusive a ordenação por nome) e as treaps só precisam
+// ter as posições renumeradas. Devolve quantos componentes foram removidos.
+int removerComponentesEmLote(Mochila *m, const char *nomes[], int n) {
+    int qtdAntes = m->qtd;
+    unsigned char *marcado = calloc((size_t)(m->qtd > 0 ? m->qtd : 1), 1);
+    if (marcado == NULL) {
+        printf("\n❌ Memória insuficiente.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // 1) Marca as posições a remover (nomes repetidos removem ocorrências distintas)
+    int removidos = 0;
+    for (int i = 0; i < n; i++) {
+        int slot = -1;
+        if (m->tabelaNomes != NULL) {
+            slot = buscarNaTabelaNomes(m, nomes[i], marcado);
+        } else {
+            for (int j = 0; j < m->qtd && slot < 0; j++)
+                if (!marcado[j] && strcmp(m->itens[j].nome, nomes[i]) == 0)
+                    slot = j;
+        }
+        if (slot >= 0) {
+            marcado[slot] = 1;
+            removidos++;
+            if (m->indices != NULL)
+                for (int c = 0; c < NUM_INDICES; c++)
+                    removerDoIndice(m, (CampoOrdenacao)c, slot);
+            if (m->trigramas != NULL && !m->trigramas->desatualizada)
+                removerDoIndiceTrigramas(m->trigramas, m->itens[slot].nome);
+        }
+    }
+    if (removidos == 0) {
+        free(marcado);
+        return 0;
+    }
+
+    // 2) Compacta o vetor, guardando a nova posição de cada sobrevivente
+    int *novaPosicao = alocar((size_t)m->qtd * sizeof(int));
+    int destino = 0;
+    for (int i = 0; i < m->qtd; i++) {
+        if (marcado[i]) {
+            novaPosicao[i] = -1;
+            continue;
+        }
+        if (destino != i)
+            m->itens[destino] = m->itens[i];
+        novaPosicao[i] = destino++;
+    }
+
+    // 3) Renumera as treaps (destino <= origem, então a cópia em ordem crescente é segura)
+    IndicesMochila *ind = m->indices;
+    if (ind != NULL) {
+        for (int c = 0; c < NUM_INDICES; c++) {
+            if (ind->raiz[c] >= 0)
+                ind->raiz[c] = novaPosicao[ind->raiz[c]];
+            for (int i = 0; i < m->qtd; i++) {
+                if (novaPosicao[i] < 0)
+                    continue;
+                int esq = ind->esq[c][i], dir = ind->dir[c][i];
+                ind->esq[c][novaPosicao[i]] = esq >= 0 ? novaPosicao[esq] : -1;
+                ind->dir[c][novaPosicao[i]] = dir >= 0 ? novaPosicao[dir] : -1;
+            }
+        }
+        for (int i = 0; i < m->qtd; i++)
+            if (novaPosicao[i] >= 0)
+                ind->peso[novaPosicao[i]] = ind->peso[i];
+    }
+
+    m->qtd = destino;
+    reconstruirTabelaNomes(m); // O(n): mais barato que renumerar entrada por entrada
+    reconstruirColunas(m);
+    reconstruirHeap(m);
+    reconstruirResumos(m);
+    registrarDescarteEmLote(m, marcado, qtdAntes, removidos);
+    aliviarMochila(m);
+    free(novaPosicao);
+    free(marcado);
+    return removidos;
+}
+
+// -------------------------------
+// IMPORTAÇÃO E EXPORTAÇÃO (CSV e binário)
+// -------------------------------
+// CSV: "nome,tipo,prioridade,qtd" por linha (cabeçalho opcional; campos podem vir
+// entre aspas, com "" para aspas internas). A leitura é feita em blocos grandes e
+// cada campo é copiado direto para o componente, sem alocação por campo.
+// Binário: CabecalhoBinario seguido dos registros com o layout exato de
+// Componente; a carga mapeia o arquivo na memória e copia os registros de uma vez.
+
+// Indexa os componentes carregados em [primeiro, qtd): item a item se forem poucos,
+// senão reconstrói os índices de uma vez
+void concluirCargaEmLote(Mochila *m, int primeiro) {
+    int novos = m->qtd - primeiro;
+    if (novos <= 0)
+        return;
+    ordenadoPorNome = 0;
+    if (m->indices == NULL && m->tabelaNomes == NULL && m->resumos == NULL && m->diario == NULL)
+        return;
+    if ((long)novos * 16 < m->qtd) {
+        int registrar = m->diario != NULL;
+        for (int i = primeiro; i < m->qtd; i++) {
+            indexarSlot(m, i);
+            if (registrar)
+                registrar = enfileirarAlteracao(m, DIARIO_ADICIONAR, i);
+        }
+        if (registrar) // A carga inteira é uma operação só (um fdatasync no modo síncrono)
+            concluirNoDiario(m);
+    } else {
+        reconstruirAuxiliares(m);
+        invalidarIndiceTrigramas(m);
+        pontoDeVerificacao(m); // Um registro por componente custaria mais que o binário inteiro
+    }
+}
+
+// Copia um campo de texto do CSV para 'destino' (truncando em tamanho - 1) e
+// devolve o ponteiro para depois do separador; NULL se a linha acabou antes
+const char *lerCampoCSV(const char *p, const char *fim, char *destino, int tamanho) {
+    int n = 0;
+    if (p > fim)
+        return NULL;
+    if (p < fim && *p == '"') { // Campo entre aspas
+        for (p++; p < fim; p++) {
+            if (*p == '"') {
+                if (p + 1 < fim && p[1] == '"')
+                    p++; // "" vira uma aspa
+                else
+                    break;
+            }
+            if (n < tamanho - 1)
+                destino[n++] = *p;
+        }
+        p++; // Fecha aspas
+        while (p < fim && *p != ',')
+            p++;
+    } else {
+        for (; p < fim && *p != ','; p++)
+            if (n < tamanho - 1)
+                destino[n++] = *p;
+    }
+    destino[n] = '\0';
+    return p + 1; // Pula a vírgula (ou passa do fim, sinalizando o último campo)
+}
+
+// Interpreta uma linha do CSV; devolve 1 se o componente é válido
+int lerLinhaCSV(const char *p, const char *fim, Componente *c) {
+    char numero[16];
+    char *resto;
+    if ((p = lerCampoCSV(p, fim, c->nome, TAM_NOME)) == NULL || c->nome[0] == '\0')
+        return 0;
+    if ((p = lerCampoCSV(p, fim, c->tipo, TAM_TIPO)) == NULL)
+        return 0;
+    if ((p = lerCampoCSV(p, fim, numero, sizeof(numero))) == NULL)
+        return 0;
+    c->prioridade = (int)strtol(numero, &resto, 10);
+    if (resto == numero)
+        return 0;
+    if ((p = lerCampoCSV(p, fim, numero, sizeof(numero))) == NULL)
+        return 0;
+    c->qtd = (int)strtol(numero, &resto, 10);
+    if (resto == numero)
+        return 0;
+    c->prioridade = chavePrioridade(c->prioridade) + PRIORIDADE_MIN; // Mesma regra da digitação
+    return 1;
+}
+
+// Importa componentes de um CSV; devolve quantos entraram (-1 se o arquivo não abriu)
+int importarCSV(Mochila *m, const char *caminho, int *invalidas) {
+    FILE *arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL)
+        return -1;
+
+    char *buffer = alocar(TAM_BUFFER_ES);
+    size_t usados = 0;
+    int primeiro = m->qtd, linha = 0, fimArquivo = 0, pulandoLinha = 0;
+    *invalidas = 0;
+
+    while (!fimArquivo) {
+        size_t lidos = fread(buffer + usados, 1, TAM_BUFFER_ES - usados, arquivo);
+        usados += lidos;
+        fimArquivo = lidos == 0;
+
+        char *p = buffer, *fimDados = buffer + usados;
+        if (pulandoLinha) { // Resto de uma linha longa demais: vai até a próxima quebra
+            char *quebra = memchr(p, '\n', usados);
+            if (quebra == NULL) {
+                usados = 0;
+                continue;
+            }
+            pulandoLinha = 0;
+            linha++;
+            p = quebra + 1;
+        }
+        while (p < fimDados) {
+            char *quebra = memchr(p, '\n', (size_t)(fimDados - p));
+            if (quebra == NULL) {
+                if (!fimArquivo)
+                    break; // Linha incompleta: espera o próximo bloco
+                quebra = fimDados;
+            }
+            char *fimLinha = quebra;
+            if (fimLinha > p && fimLinha[-1] == '\r')
+                fimLinha--;
+
+            if (fimLinha > p) {
+                Componente c;
+                memset(&c, 0, sizeof(c));
+                if (lerLinhaCSV(p, fimLinha, &c)) {
+                    int slot = m->qtd;
+                    if (slot == m->capacidade)
+                        reservarMochila(m, m->capacidade < CAPACIDADE_INICIAL ? CAPACIDADE_INICIAL : m->capacidade * 2);
+                    m->itens[slot] = c;
+                    m->qtd++;
+                } else if (!(linha == 0 && strncmp(p, "nome", 4) == 0)) { // Cabeçalho não conta como erro
+                    (*invalidas)++;
+                }
+            }
+            linha++;
+            p = quebra + 1;
+        }
+
+        // Guarda a linha incompleta no início do buffer
+        usados = p < fimDados ? (size_t)(fimDados - p) : 0;
+        if (usados == TAM_BUFFER_ES) { // Linha maior que o buffer inteiro: descarta até o fim dela
+            (*invalidas)++;
+            usados = 0;
+            pulandoLinha = 1;
+        }
+        memmove(buffer, p, usados);
+    }
+
+    free(buffer);
+    fclose(arquivo);
+    concluirCargaEmLote(m, primeiro);
+    return m->qtd - primeiro;
+}
+
+// Acrescenta um texto ao buffer de saída, entre aspas se tiver vírgula ou aspas
+char *escreverCampoCSV(char *saida, const char *texto) {
+    if (strpbrk(texto, ",\"\n") == NULL) {
+        while (*texto)
+            *saida++ = *texto++;
+        return saida;
+    }
+    *saida++ = '"';
+    for (; *texto; texto++) {
+        if (*texto == '"')
+            *saida++ = '"';
+        *saida++ = *texto;
+    }
+    *saida++ = '"';
+    return saida;
+}
+
+// Exporta a mochila para CSV; devolve 1 se gravou
+int exportarCSV(const Mochila *m, const char *caminho) {
+    FILE *arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL)
+        return 0;
+
+    char *buffer = alocar(TAM_BUFFER_ES);
+    char *saida = buffer + sprintf(buffer, "nome,tipo,prioridade,qtd\n");
+    int ok = 1;
+    for (int i = 0; i < m->qtd && ok; i++) {
+        const Componente *c = &m->itens[i];
+        saida = escreverCampoCSV(saida, c->nome);
+        *saida++ = ',';
+        saida = escreverCampoCSV(saida, c->tipo);
+        saida += sprintf(saida, ",%d,%d\n", c->prioridade, c->qtd);
+
+        // Uma linha ocupa no máximo ~2 * (TAM_NOME + TAM_TIPO) + 32 bytes
+        if (saida - buffer > TAM_BUFFER_ES - 256 || i == m->qtd - 1) {
+            ok = fwrite(buffer, 1, (size_t)(saida - buffer), arquivo) == (size_t)(saida - buffer);
+            saida = buffer;
+        }
+    }
+    if (m->qtd == 0)
+        ok = fwrite(buffer, 1, (size_t)(saida - buffer), arquivo) == (size_t)(saida - buffer);
+
+    free(buffer);
+    return fclose(arquivo) == 0 && ok;
+}
+
+// Grava a mochila no formato binário (arquivo temporário + rename), com a geração
+// informada no cabeçalho; 'duravel' sincroniza o arquivo antes do rename. Devolve 1 se gravou
+int gravarBinario(const Mochila *m, const char *caminho, uint32_t geracao, int duravel) {
+    char temporario[PATH_MAX];
+    snprintf(temporario, sizeof(temporario), "%s.tmp", caminho);
+    FILE *arquivo = fopen(temporario, "wb");
+    if (arquivo == NULL)
+        return 0;
+
+    CabecalhoBinario cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.magica, MAGICA_BINARIO, sizeof(cabecalho.magica));
+    cabecalho.versao = VERSAO_BINARIO;
+    cabecalho.tamanhoRegistro = sizeof(Componente);
+    cabecalho.geracao = geracao;
+    cabecalho.quantidade = (uint64_t)m->qtd;
+
+    int ok = fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1 &&
+             fwrite(m->itens, sizeof(Componente), (size_t)m->qtd, arquivo) == (size_t)m->qtd;
+    if (duravel)
+        ok = ok && fflush(arquivo) == 0 && fdatasync(fileno(arquivo)) == 0;
+    ok = fclose(arquivo) == 0 && ok;
+    if (!ok || rename(temporario, caminho) != 0) {
+        remove(temporario);
+        return 0;
+    }
+    return 1;
+}
+
+// Exporta a mochila no formato binário
+int exportarBinario(const Mochila *m, const char *caminho) {
+    return gravarBinario(m, caminho, 0, 0);
+}
+
+// Não confia no arquivo: garante textos terminados e prioridade na faixa
+void sanearComponente(Componente *c) {
+    c->nome[TAM_NOME - 1] = '\0';
+    c->tipo[TAM_TIPO - 1] = '\0';
+    c->prioridade = chavePrioridade(c->prioridade) + PRIORIDADE_MIN;
+}
+
+// Carrega um arquivo binário mapeado em memória e informa a geração do cabeçalho
+// (se 'geracao' não for NULL); devolve quantos entraram (-1 se inválido)
+int carregarBinario(Mochila *m, const char *caminho, uint32_t *geracao) {
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(CabecalhoBinario)) {
+        close(fd);
+        return -1;
+    }
+    void *mapa = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED)
+        return -1;
+
+    const CabecalhoBinario *cabecalho = mapa;
+    uint64_t espaco = ((uint64_t)info.st_size - sizeof(CabecalhoBinario)) / sizeof(Componente);
+    if (memcmp(cabecalho->magica, MAGICA_BINARIO, sizeof(cabecalho->magica)) != 0 ||
+        cabecalho->versao != VERSAO_BINARIO || cabecalho->tamanhoRegistro != sizeof(Componente) ||
+        cabecalho->quantidade > espaco || cabecalho->quantidade > (uint64_t)(INT_MAX - m->qtd)) {
+        munmap(mapa, (size_t)info.st_size);
+        return -1;
+    }
+
+    int n = (int)cabecalho->quantidade, primeiro = m->qtd;
+    if (geracao != NULL)
+        *geracao = cabecalho->geracao;
+    madvise(mapa, (size_t)info.st_size, MADV_SEQUENTIAL);
+    reservarMochila(m, m->qtd + n);
+    memcpy(m->itens + primeiro, (const char *)mapa + sizeof(CabecalhoBinario), (size_t)n * sizeof(Componente));
+    munmap(mapa, (size_t)info.st_size);
+
+    for (int i = primeiro; i < primeiro + n; i++)
+        sanearComponente(&m->itens[i]);
+    m->qtd += n;
+    concluirCargaEmLote(m, primeiro);
+    return n;
+}
+
+// Importa um arquivo binário
+int importarBinario(Mochila *m, const char *caminho) {
+    return carregarBinario(m, caminho, NULL);
+}
+
+// Escolhe o formato pela extensão: ".csv" é CSV, o resto é binário
+int terminaComCSV(const char *caminho) {
+    size_t n = strlen(caminho);
+    return n >= 4 && strcasecmp(caminho + n - 4, ".csv") == 0;
+}
+
+// Importa um arquivo (CSV ou binário) e informa o resultado
+void importarArquivo(const char *caminho) {
+    int invalidas = 0;
+    double inicio = tempoMs();
+    int n = terminaComCSV(caminho) ? importarCSV(&mochila, caminho, &invalidas) : importarBinario(&mochila, caminho);
+    if (n < 0) {
+        fprintf(saidaAvisos, "\n❌ Não foi possível importar '%s'.\n", caminho);
+        return;
+    }
+    fprintf(saidaAvisos, "\n📥 %d componente(s) importado(s) de '%s' em %.1f ms", n, caminho, tempoMs() - inicio);
+    if (invalidas > 0)
+        fprintf(saidaAvisos, " (%d linha(s) inválida(s) ignorada(s))", invalidas);
+    fprintf(saidaAvisos, ".\n");
+}
+
+// Exporta a mochila (CSV ou binário) e informa o resultado
+void exportarArquivo(const char *caminho) {
+    double inicio = tempoMs();
+    int ok = terminaComCSV(caminho) ? exportarCSV(&mochila, caminho) : exportarBinario(&mochila, caminho);
+    if (!ok) {
+        printf("\n❌ Não foi possível exportar para '%s'.\n", caminho);
+        return;
+    }
+    printf("\n📤 %d componente(s) exportado(s) para '%s' em %.1f ms.\n", mochila.qtd, caminho, tempoMs() - inicio);
+}
+
+// -------------------------------
+// DIÁRIO DE ESCRITA ANTECIPADA (--wal DIR)
+// -------------------------------
+// Cada adição, remoção e mudança de prioridade vira um registro de tamanho fixo em
+// DIR/mochila.wal. Os registros entram num buffer em memória e a thread escritora
+// espera até ESPERA_GRUPO_DIARIO_US (ou meio buffer) e grava e sincroniza (fdatasync)
+// tudo o que acumulou de uma vez (commit em grupo): a thread principal não espera
+// o disco e cada fdatasync cobre muitos registros. Uma ordenação vira um registro
+// com o nome do algoritmo (todos são determinísticos: reaplicá-lo sobre o mesmo
+// vetor dá as mesmas posições) e um descarte em lote vira um registro por posição
+// marcada e um de compactação, que fecha o lote (marcas sem ele são cortadas).
+// Cargas grandes e diários com LIMITE_REGISTROS_DIARIO registros geram um
+// ponto de verificação: o binário da mochila em DIR/mochila.ckpt com uma geração
+// nova no cabeçalho, seguido de um diário vazio dessa geração. Se a queda vier
+// entre os dois, o diário antigo tem outra geração e é ignorado. A recuperação
+// carrega o ponto de verificação, reaplica o diário direto no vetor até o primeiro
+// registro incompleto (o resto é cortado) e só então os índices são montados.
+// Por padrão a alteração é confirmada antes de chegar ao disco: numa queda perde-se
+// o que entrou nos últimos ESPERA_GRUPO_DIARIO_US mais o grupo que estava sendo
+// gravado. Com --wal-sincrono cada operação só volta depois do fdatasync que a cobre.
+
+// FNV-1a dos bytes do registro, partindo da geração (registros de outro diário não passam)
+uint32_t verificacaoRegistro(const RegistroDiario *r, uint32_t geracao) {
+    const unsigned char *p = (const unsigned char *)r;
+    uint32_t h = 2166136261u ^ geracao;
+    for (size_t i = 0; i < sizeof(RegistroDiario) - sizeof(r->verificacao); i++)
+        h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+// Sincroniza o diretório (torna duráveis os renames feitos nele)
+int sincronizarDiretorio(const char *diretorio) {
+    int fd = open(diretorio, O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+        return 0;
+    int ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+// Troca o diário por um vazio da geração informada (arquivo temporário + rename)
+int criarDiario(DiarioMochila *d, uint32_t geracao) {
+    char temporario[sizeof(d->caminhoDiario) + 4];
+    snprintf(temporario, sizeof(temporario), "%s.tmp", d->caminhoDiario);
+    int fd = open(temporario, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return 0;
+
+    CabecalhoDiario cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.magica, MAGICA_DIARIO, sizeof(cabecalho.magica));
+    cabecalho.versao = VERSAO_DIARIO;
+    cabecalho.tamanhoRegistro = sizeof(RegistroDiario);
+    cabecalho.geracao = geracao;
+    if (write(fd, &cabecalho, sizeof(cabecalho)) != (ssize_t)sizeof(cabecalho) || fdatasync(fd) != 0 ||
+        rename(temporario, d->caminhoDiario) != 0 || !sincronizarDiretorio(d->diretorio)) {
+        close(fd);
+        remove(temporario);
+        return 0;
+    }
+    if (d->fd >= 0)
+        close(d->fd);
+    d->fd = fd; // Já posicionado depois do cabeçalho
+    d->geracao = geracao;
+    d->registros = 0;
+    return 1;
+}
+
+// Thread escritora: grava e sincroniza de uma vez o que se acumulou no buffer ativo
+void *escritorDiario(void *arg) {
+    DiarioMochila *d = arg;
+    pthread_mutex_lock(&d->trava);
+    for (;;) {
+        while (d->usado == 0 && !d->encerrar)
+            pthread_cond_wait(&d->temDados, &d->trava);
+        if (d->usado == 0)
+            break; // Encerrando e sem nada pendente
+
+        // Commit em grupo: junta mais registros antes do fdatasync
+        struct timespec prazo;
+        clock_gettime(CLOCK_REALTIME, &prazo);
+        prazo.tv_nsec += ESPERA_GRUPO_DIARIO_US * 1000L;
+        prazo.tv_sec += prazo.tv_nsec / 1000000000L;
+        prazo.tv_nsec %= 1000000000L;
+        while (!d->encerrar && !d->urgente && d->usado > 0 && d->usado < TAM_BUFFER_DIARIO / 2 &&
+               pthread_cond_timedwait(&d->temDados, &d->trava, &prazo) == 0)
+            ;
+        d->urgente = 0;
+        if (d->usado == 0)
+            continue; // Um ponto de verificação descartou os pendentes
+
+        // Troca de buffer: a thread principal continua registrando no outro
+        const char *dados = d->buffer[d->ativo];
+        size_t bytes = d->usado;
+        long long alvo = d->enfileirados;
+        int fd = d->fd;
+        d->ativo ^= 1;
+        d->usado = 0;
+        d->gravando = 1;
+        pthread_cond_broadcast(&d->gravou); // Libera quem esperava espaço no buffer
+        pthread_mutex_unlock(&d->trava);
+
+        int ok = 1;
+        for (size_t feito = 0; ok && feito < bytes;) {
+            ssize_t n = write(fd, dados + feito, bytes - feito);
+            if (n < 0 && errno == EINTR)
+                continue;
+            ok = n > 0;
+            if (ok)
+                feito += (size_t)n;
+        }
+        ok = ok && fdatasync(fd) == 0;
+
+        pthread_mutex_lock(&d->trava);
+        d->gravando = 0;
+        d->duraveis = alvo;
+        d->falhou |= !ok;
+        d->grupos++;
+        pthread_cond_broadcast(&d->gravou);
+    }
+    pthread_mutex_unlock(&d->trava);
+    return NULL;
+}
+
+// Entrega um registro pronto à thread escritora; devolve 0 se o diário já falhou
+int enfileirarNoDiario(DiarioMochila *d, RegistroDiario *r) {
+    r->verificacao = verificacaoRegistro(r, d->geracao);
+
+    pthread_mutex_lock(&d->trava);
+    if (d->falhou) {
+        pthread_mutex_unlock(&d->trava);
+        if (!d->avisado)
+            fprintf(saidaAvisos, "\n⚠️ Falha ao gravar o diário: as alterações deixaram de ser duráveis.\n");
+        d->avisado = 1;
+        return 0;
+    }
+    while (d->usado + sizeof(*r) > TAM_BUFFER_DIARIO) // Buffer cheio: espera a escritora trocar
+        pthread_cond_wait(&d->gravou, &d->trava);
+    memcpy(d->buffer[d->ativo] + d->usado, r, sizeof(*r));
+    d->usado += sizeof(*r);
+    d->enfileirados++;
+    // Acorda a escritora no primeiro registro pendente e quando o buffer chega à metade
+    if (d->usado == sizeof(*r) || (d->usado >= TAM_BUFFER_DIARIO / 2 && d->usado - sizeof(*r) < TAM_BUFFER_DIARIO / 2))
+        pthread_cond_signal(&d->temDados);
+    pthread_mutex_unlock(&d->trava);
+    d->registros++;
+    return 1;
+}
+
+// Fecha uma operação já enfileirada: no modo síncrono espera o fdatasync dela e
+// depois troca o diário por um ponto de verificação se ele passou do limite.
+// Devolve 1 se trocou
+int concluirNoDiario(Mochila *m) {
+    if (m->diario->sincrono)
+        sincronizarDiario(m->diario);
+    if (m->diario->registros < LIMITE_REGISTROS_DIARIO)
+        return 0;
+    pontoDeVerificacao(m);
+    return 1;
+}
+
+// Enfileira a alteração já feita na posição 'slot' sem fechar a operação;
+// devolve 0 se o diário está desativado ou falhou
+int enfileirarAlteracao(Mochila *m, OperacaoDiario operacao, int slot) {
+    if (m->diario == NULL)
+        return 0;
+
+    RegistroDiario r;
+    memset(&r, 0, sizeof(r));
+    r.operacao = operacao;
+    r.slot = slot;
+    if (operacao != DIARIO_REMOVER)
+        r.componente = m->itens[slot];
+    return enfileirarNoDiario(m->diario, &r);
+}
+
+// Registra uma alteração já feita na posição 'slot' (nada se o diário estiver
+// desativado). Devolve 1 se o diário passou do limite e virou ponto de verificação
+int registrarNoDiario(Mochila *m, OperacaoDiario operacao, int slot) {
+    return enfileirarAlteracao(m, operacao, slot) && concluirNoDiario(m);
+}
+
+// Registra uma ordenação já feita pelo nome que ordenarPorEspecificacao entende
+int registrarOrdenacao(Mochila *m, const char *especificacao) {
+    if (m->diario == NULL)
+        return 0;
+
+    RegistroDiario r;
+    memset(&r, 0, sizeof(r));
+    r.operacao = DIARIO_ORDENAR;
+    snprintf(r.componente.nome, sizeof(r.componente.nome), "%s", especificacao);
+    return enfileirarNoDiario(m->diario, &r) && concluirNoDiario(m);
+}
+
+// Registra um descarte em lote já feito: as posições marcadas entre as 'qtd' de
+// antes da compactação e o registro que fecha o lote. O limite só é conferido no
+// fim, para o ponto de verificação não cair no meio do lote
+int registrarDescarteEmLote(Mochila *m, const unsigned char *marcado, int qtd, int removidos) {
+    if (m->diario == NULL)
+        return 0;
+
+    RegistroDiario r;
+    memset(&r, 0, sizeof(r));
+    r.operacao = DIARIO_MARCAR;
+    for (int i = 0; i < qtd; i++) {
+        if (!marcado[i])
+            continue;
+        r.slot = i;
+        if (!enfileirarNoDiario(m->diario, &r))
+            return 0;
+    }
+    r.operacao = DIARIO_COMPACTAR;
+    r.slot = removidos;
+    return enfileirarNoDiario(m->diario, &r) && concluirNoDiario(m);
+}
+
+// Espera tudo o que já foi registrado passar por fdatasync; devolve 0 se houve falha
+int sincronizarDiario(DiarioMochila *d) {
+    pthread_mutex_lock(&d->trava);
+    long long alvo = d->enfileirados;
+    d->urgente = 1;
+    pthread_cond_signal(&d->temDados);
+    while (d->duraveis < alvo && !d->falhou)
+        pthread_cond_wait(&d->gravou, &d->trava);
+    int ok = !d->falhou;
+    pthread_mutex_unlock(&d->trava);
+    return ok;
+}
+
+// Grava a mochila inteira como ponto de verificação e recomeça o diário vazio
+// (nada se o diário estiver desativado); devolve 0 se falhou
+int pontoDeVerificacao(Mochila *m) {
+    DiarioMochila *d = m->diario;
+    if (d == NULL)
+        return 1;
+
+    uint32_t geracao = d->geracao + 1;
+    int ok = gravarBinario(m, d->caminhoPonto, geracao, 1) && sincronizarDiretorio(d->diretorio);
+
+    // O ponto cobre o que ainda estava no buffer: descarta os pendentes e troca de diário
+    pthread_mutex_lock(&d->trava);
+    while (d->gravando)
+        pthread_cond_wait(&d->gravou, &d->trava);
+    if (ok) {
+        d->usado = 0;
+        d->duraveis = d->enfileirados;
+        ok = criarDiario(d, geracao);
+    }
+    d->falhou |= !ok; // O diário antigo não descreve mais a mochila
+    pthread_cond_broadcast(&d->gravou);
+    pthread_mutex_unlock(&d->trava);
+    return ok;
+}
+
+// Aplica um registro direto no vetor (a recuperação indexa tudo no fim); 0 se não se encaixa.
+// 'marcado' guarda as marcas do descarte em lote aberto (NULL fora de um lote)
+int aplicarRegistro(Mochila *m, const RegistroDiario *r, unsigned char **marcado, int *marcados) {
+    if (*marcado != NULL && r->operacao != DIARIO_MARCAR && r->operacao != DIARIO_COMPACTAR)
+        return 0; // O lote é gravado inteiro antes de qualquer outra alteração
+    int comparacoes, destino = 0;
+    switch (r->operacao) {
+        case DIARIO_ADICIONAR:
+            if (r->slot != m->qtd || m->capacidade > INT_MAX / 2)
+                return 0;
+            if (m->qtd == m->capacidade)
+                reservarMochila(m, m->capacidade < CAPACIDADE_INICIAL ? CAPACIDADE_INICIAL : m->capacidade * 2);
+            m->itens[m->qtd] = r->componente;
+            sanearComponente(&m->itens[m->qtd++]);
+            return 1;
+        case DIARIO_REMOVER:
+            if (r->slot < 0 || r->slot >= m->qtd)
+                return 0;
+            m->itens[r->slot] = m->itens[--m->qtd]; // Mesma troca com o último de removerComponente
+            return 1;
+        case DIARIO_PRIORIDADE:
+            if (r->slot < 0 || r->slot >= m->qtd)
+                return 0;
+            m->itens[r->slot].prioridade = chavePrioridade(r->componente.prioridade) + PRIORIDADE_MIN;
+            return 1;
+        case DIARIO_ORDENAR:
+            if (memchr(r->componente.nome, '\0', sizeof(r->componente.nome)) == NULL)
+                return 0;
+            return ordenarPorEspecificacao(m->itens, m->qtd, r->componente.nome, NULL, &comparacoes);
+        case DIARIO_MARCAR:
+            if (r->slot < 0 || r->slot >= m->qtd)
+                return 0;
+            if (*marcado == NULL) {
+                *marcado = calloc((size_t)m->qtd, 1);
+                *marcados = 0;
+                if (*marcado == NULL) {
+                    printf("\n❌ Memória insuficiente.\n");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            if ((*marcado)[r->slot])
+                return 0;
+            (*marcado)[r->slot] = 1;
+            (*marcados)++;
+            return 1;
+        case DIARIO_COMPACTAR:
+            if (*marcado == NULL || r->slot != *marcados)
+                return 0;
+            for (int i = 0; i < m->qtd; i++) // Mesma compactação estável de removerComponentesEmLote
+                if (!(*marcado)[i])
+                    m->itens[destino++] = m->itens[i];
+            m->qtd = destino;
+            free(*marcado);
+            *marcado = NULL;
+            return 1;
+    }
+    return 0;
+}
+
+// Reaplica os registros íntegros do diário; devolve quantos entraram e em 'valido' o
+// tamanho do trecho íntegro do arquivo (-1 se não existe ou é de outra geração)
+long reaplicarDiario(Mochila *m, const char *caminho, uint32_t geracao, off_t *valido) {
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(CabecalhoDiario)) {
+        close(fd);
+        return -1;
+    }
+    void *mapa = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED)
+        return -1;
+
+    const CabecalhoDiario *cabecalho = mapa;
+    if (memcmp(cabecalho->magica, MAGICA_DIARIO, sizeof(cabecalho->magica)) != 0 ||
+        cabecalho->versao != VERSAO_DIARIO || cabecalho->tamanhoRegistro != sizeof(RegistroDiario) ||
+        cabecalho->geracao != geracao) {
+        munmap(mapa, (size_t)info.st_size);
+        return -1;
+    }
+
+    madvise(mapa, (size_t)info.st_size, MADV_SEQUENTIAL);
+    const RegistroDiario *registros = (const RegistroDiario *)(cabecalho + 1);
+    long total = (long)(((size_t)info.st_size - sizeof(CabecalhoDiario)) / sizeof(RegistroDiario)), aplicados = 0;
+    long inicioLote = 0; // Primeiro registro do descarte em lote aberto
+    unsigned char *marcado = NULL;
+    int marcados = 0;
+    while (aplicados < total && registros[aplicados].verificacao == verificacaoRegistro(&registros[aplicados], geracao)) {
+        if (marcado == NULL)
+            inicioLote = aplicados;
+        if (!aplicarRegistro(m, &registros[aplicados], &marcado, &marcados))
+            break;
+        aplicados++;
+    }
+    munmap(mapa, (size_t)info.st_size);
+    if (marcado != NULL) { // Lote sem o registro de compactação: nada dele chegou ao vetor
+        free(marcado);
+        aplicados = inicioLote;
+    }
+
+    *valido = (off_t)(sizeof(CabecalhoDiario) + (size_t)aplicados * sizeof(RegistroDiario));
+    return aplicados;
+}
+
+// Recupera a mochila (vazia, ainda sem índices) do diretório e passa a registrar nele
+// as alterações; informa quantos registros do diário foram reaplicados. Devolve 1 se deu certo
+int abrirDiario(Mochila *m, const char *diretorio, long *reaplicados) {
+    if (mkdir(diretorio, 0755) != 0 && errno != EEXIST)
+        return 0;
+
+    DiarioMochila *d = alocar(sizeof(DiarioMochila));
+    memset(d, 0, sizeof(DiarioMochila));
+    d->fd = -1;
+    snprintf(d->diretorio, sizeof(d->diretorio), "%s", diretorio);
+    snprintf(d->caminhoDiario, sizeof(d->caminhoDiario), "%s/mochila.wal", diretorio);
+    snprintf(d->caminhoPonto, sizeof(d->caminhoPonto), "%s/mochila.ckpt", diretorio);
+
+    // Ponto de verificação (se houver) e depois o diário da mesma geração
+    uint32_t geracao = 0;
+    if (access(d->caminhoPonto, F_OK) == 0 && carregarBinario(m, d->caminhoPonto, &geracao) < 0) {
+        free(d);
+        return 0;
+    }
+    off_t valido = 0;
+    long n = reaplicarDiario(m, d->caminhoDiario, geracao, &valido);
+    if (n >= 0) {
+        // Corta o que sobrou de uma gravação interrompida e continua o mesmo diário
+        d->fd = open(d->caminhoDiario, O_WRONLY);
+        if (d->fd < 0 || ftruncate(d->fd, valido) != 0 || lseek(d->fd, valido, SEEK_SET) < 0 || fdatasync(d->fd) != 0) {
+            if (d->fd >= 0)
+                close(d->fd);
+            free(d);
+            return 0;
+        }
+        d->geracao = geracao;
+        d->registros = n;
+    } else if (!criarDiario(d, geracao)) {
+        free(d);
+        return 0;
+    }
+    if (reaplicados != NULL)
+        *reaplicados = n > 0 ? n : 0;
+    ordenadoPorNome = 0;
+
+    d->buffer[0] = alocar(TAM_BUFFER_DIARIO);
+    d->buffer[1] = alocar(TAM_BUFFER_DIARIO);
+    pthread_mutex_init(&d->trava, NULL);
+    pthread_cond_init(&d->temDados, NULL);
+    pthread_cond_init(&d->gravou, NULL);
+    pthread_create(&d->escritor, NULL, escritorDiario, d);
+    m->diario = d;
+    return 1;
+}
+
+// Grava o que estiver pendente, encerra a thread escritora e fecha o diário
+void liberarDiario(Mochila *m) {
+    DiarioMochila *d = m->diario;
+    if (d == NULL)
+        return;
+    pthread_mutex_lock(&d->trava);
+    d->encerrar = 1;
+    pthread_cond_signal(&d->temDados);
+    pthread_mutex_unlock(&d->trava);
+    pthread_join(d->escritor, NULL); // A escritora esvazia o buffer antes de sair
+
+    if (d->falhou && !d->avisado)
+        fprintf(saidaAvisos, "\n⚠️ Falha ao gravar o diário: as últimas alterações podem não ter sido salvas.\n");
+    close(d->fd);
+    free(d->buffer[0]);
+    free(d->buffer[1]);
+    pthread_mutex_destroy(&d->trava);
+    pthread_cond_destroy(&d->temDados);
+    pthread_cond_destroy(&d->gravou);
+    free(d);
+    m->diario = NULL;
+}
+
+// -------------------------------
+// BUSCA BINÁRIA (por nome)
+// -------------------------------
+// Busca binária sem mensagens (a lista deve estar ordenada por nome); devolve a posição ou -1
+int buscaBinaria(const Componente lista[], int n, const char nomeBusca[], int *comparacoes) {
+    int inicio = 0, fim = n - 1, meio;
+    *comparacoes = 0;
+
+    while (inicio <= fim) {
+        meio = inicio + (fim - inicio) / 2;
+        (*comparacoes)++;
+        int resultado = strcmp(lista[meio].nome, nomeBusca);
+        if (resultado == 0) { // Encontrou componente
+            TELEMETRIA_CONTAR("busca_binaria.comparacoes", *comparacoes);
+            return meio;
+        }
+        else if (resultado < 0)
+            inicio = meio + 1; // Busca na metade direita
+        else
+            fim = meio - 1;    // Busca na metade esquerda
+    }
+    TELEMETRIA_CONTAR("busca_binaria.comparacoes", *comparacoes);
+    return -1;
+}
+
+// Busca sequencial por nome (não exige ordenação); devolve a posição ou -1
+int buscaSequencial(const Componente lista[], int n, const char nomeBusca[], int *comparacoes) {
+    *comparacoes = 0;
+    for (int i = 0; i < n; i++) {
+        (*comparacoes)++;
+        if (strcmp(lista[i].nome, nomeBusca) == 0)
+            return i;
+    }
+    return -1;
+}
+
+int buscaBinariaPorNome(Componente lista[], int n, char nomeBusca[]) {
+    if (!ordenadoPorNome) { // Verifica se a lista está ordenada
+        printf("\n⚠️ A busca binária requer que a mochila esteja ordenada por NOME.\n");
+        return -1;
+    }
+
+    int comparacoes;
+    int meio = buscaBinaria(lista, n, nomeBusca, &comparacoes);
+    if (meio >= 0) { // Encontrou componente
+        printf("\n✅ Componente encontrado!\n");
+        printf("Nome: %s\nTipo: %s\nPrioridade: %d\nQuantidade: %d\n",
+               lista[meio].nome, lista[meio].tipo, lista[meio].prioridade, lista[meio].qtd);
+        printf("🔍 Comparações realizadas: %d\n", comparacoes);
+        return meio;
+    }
+
+    printf("\n❌ Componente não encontrado.\n");
+    return -1;
+}
+
+// -------------------------------
+// CRUD DE COMPONENTES
+// -------------------------------
+
+// Adiciona um componente à mochila
+void adicionarComponente() {
+    Componente novo;
+    printf("\n--- Coletando Novo Componente ---\n");
+    printf("Nome do componente: ");
+    lerString(novo.nome, TAM_NOME);
+    printf("Tipo do componente (Estrutural, Eletronico, Energia): ");
+    lerString(novo.tipo, TAM_TIPO);
+    printf("Quantidade: ");
+    novo.qtd = lerInt();
+    printf("Prioridade (1 a 5): ");
+    novo.prioridade = lerInt();
+    if (novo.prioridade < PRIORIDADE_MIN || novo.prioridade > PRIORIDADE_MAX) {
+        novo.prioridade = chavePrioridade(novo.prioridade) + PRIORIDADE_MIN;
+        printf("⚠️ Prioridade fora da faixa; ajustada para %d.\n", novo.prioridade);
+    }
+
+    anexarComponente(&mochila, &novo); // Adiciona à mochila (cresce se necessário)
+
+    printf("\n✅ Componente \"%s\" adicionado com sucesso!\n", novo.nome);
+}
+
+// Remove um componente da mochila pelo nome
+void descartarComponente() {
+    if (mochila.qtd == 0) {
+        printf("\n⚠️ Mochila vazia! Nenhum componente para remover.\n");
+        return;
+    }
+
+    char nomeBusca[TAM_NOME];
+    printf("\n--- DESCARTAR COMPONENTE ---\n");
+    printf("Informe o nome do componente: ");
+    lerString(nomeBusca, TAM_NOME);
+
+    if (removerComponentePorNome(&mochila, nomeBusca)) {
+        printf("\n🗑️ Componente '%s' descartado!\n", nomeBusca);
+        return;
+    }
+    printf("\n❌ Componente não encontrado.\n");
+}
+
+// Remove vários componentes de uma vez (nomes separados por vírgula)
+void descartarEmLote() {
+    if (mochila.qtd == 0) {
+        printf("\n⚠️ Mochila vazia! Nenhum componente para remover.\n");
+        return;
+    }
+
+    char linha[MAX_LOTE * TAM_NOME];
+    const char *nomes[MAX_LOTE];
+    int n = 0;
+    printf("\n--- DESCARTE EM LOTE ---\n");
+    printf("Informe os nomes separados por vírgula: ");
+    lerString(linha, sizeof(linha));
+
+    for (char *nome = strtok(linha, ","); nome != NULL && n < MAX_LOTE; nome = strtok(NULL, ",")) {
+        while (*nome == ' ')
+            nome++; // Ignora espaços antes do nome
+        char *fim = nome + strlen(nome);
+        while (fim > nome && fim[-1] == ' ')
+            *--fim = '\0'; // E depois dele
+        if (*nome != '\0')
+            nomes[n++] = nome;
+    }
+
+    int removidos = removerComponentesEmLote(&mochila, nomes, n);
+    printf("\n🗑️ %d de %d componente(s) descartado(s)!\n", removidos, n);
+}
+
+// -------------------------------
+// BENCHMARK (--bench, --bench-paralelo e --bench-diario)
+// -------------------------------
+// Gera inventários reproduzíveis e mede cada ordenação e busca, imprimindo CSV
+// com tempo, comparações, movimentos e falhas de cache (contadores de hardware
+// via perf_event_open, somando a thread principal e as do pool, quando o sistema
+// permitir; "NA" caso contrário).
+
+// Distribuições de dados geradas para os testes
+typedef enum {
+    DIST_ALEATORIA,
+    DIST_ORDENADA,
+    DIST_INVERSA,
+    DIST_POUCOS_UNICOS,
+    DIST_PREFIXO_LONGO,
+    NUM_DISTRIBUICOES
+} Distribuicao;
+
+const char *nomesDistribuicoes[] = {"aleatoria", "ordenada", "inversa", "poucos_unicos", "prefixo_longo"};
+
+// Gera n componentes conforme a distribuição (mesma semente = mesmo inventário)
+void gerarInventario(Componente lista[], int n, Distribuicao dist, uint32_t semente) {
+    static const char *tipos[] = {"Eletronico", "Energia", "Estrutural"}; // Já em ordem alfabética
+    for (int i = 0; i < n; i++) {
+        semente = semente * 1664525u + 1013904223u;
+        uint32_t valor = semente ^ (semente >> 15);
+        int faixa; // Posição do componente na ordem crescente de todos os campos
+
+        switch (dist) {
+            case DIST_ORDENADA: faixa = i; break;
+            case DIST_INVERSA: faixa = n - 1 - i; break;
+            case DIST_POUCOS_UNICOS: faixa = (int)(valor % 8); valor %= 8; break;
+            default: faixa = (int)(valor % (uint32_t)n); break;
+        }
+
+        if (dist == DIST_PREFIXO_LONGO)
+            snprintf(lista[i].nome, TAM_NOME, "componente-da-torre-%08x", valor);
+        else if (dist == DIST_ORDENADA || dist == DIST_INVERSA)
+            snprintf(lista[i].nome, TAM_NOME, "comp-%010d", faixa);
+        else
+            snprintf(lista[i].nome, TAM_NOME, "comp-%08x", valor);
+
+        int limite = dist == DIST_POUCOS_UNICOS ? 8 : n;
+        snprintf(lista[i].tipo, TAM_TIPO, "%s", tipos[(long)faixa * 3 / limite]);
+        lista[i].prioridade = PRIORIDADE_MIN + (int)((long)faixa * (PRIORIDADE_MAX - PRIORIDADE_MIN + 1) / limite);
+        lista[i].qtd = 1 + i % 100;
+    }
+}
+
+// Falhas de cache da thread chamadora e das auxiliares do pool de ordenação,
+// um contador de hardware por thread (a soma cobre as ordenações paralelas)
+typedef struct {
+    int fds[MAX_THREADS];
+    int qtd; // 0 = indisponível
+} ContadorCache;
+
+// Abre o contador de falhas de cache de uma thread (0 = a chamadora; -1 se indisponível)
+int abrirContadorDaThread(pid_t tid) {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0);
+#else
+    (void)tid;
+    return -1;
+#endif
+}
+
+// Fecha os contadores abertos
+void fecharContadorCache(ContadorCache *c) {
+    for (int i = 0; i < c->qtd; i++)
+        close(c->fds[i]);
+    c->qtd = 0;
+}
+
+// Abre um contador para a chamadora e um para cada auxiliar do pool; se algum
+// falhar, nenhum fica aberto (uma soma parcial enganaria a coluna)
+void abrirContadorCache(ContadorCache *c, const PoolThreads *pool) {
+    c->qtd = 0;
+    int threads = pool != NULL ? pool->qtdThreads : 1;
+    for (int i = 0; i < threads; i++) {
+        int fd = abrirContadorDaThread(i == 0 ? 0 : pool->tids[i]);
+        if (fd < 0) {
+            fecharContadorCache(c);
+            return;
+        }
+        c->fds[c->qtd++] = fd;
+    }
+}
+
+// Zera e liga os contadores
+void iniciarContador(const ContadorCache *c) {
+#ifdef __linux__
+    for (int i = 0; i < c->qtd; i++) {
+        ioctl(c->fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(c->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#else
+    (void)c;
+#endif
+}
+
+// Desliga os contadores e devolve a soma (-1 se indisponível)
+long long pararContador(const ContadorCache *c) {
+    long long total = 0;
+#ifdef __linux__
+    for (int i = 0; i < c->qtd; i++)
+        ioctl(c->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    for (int i = 0; i < c->qtd; i++) {
+        long long valor;
+        if (read(c->fds[i], &valor, sizeof(valor)) != (ssize_t)sizeof(valor))
+            return -1;
+        total += valor;
+    }
+#endif
+    return c->qtd > 0 ? total : -1;
+}
+
+// Imprime uma linha do CSV (valores negativos saem como NA)
+void linhaBenchmark(const char *algoritmo, Distribuicao dist, int n, double tempo,
+                    long long comparacoes, long long movs, long long falhas) {
+    printf("%s,%s,%d,%.3f,", algoritmo, nomesDistribuicoes[dist], n, tempo);
+    if (comparacoes >= 0) printf("%lld,", comparacoes); else printf("NA,");
+    if (movs >= 0) printf("%lld,", movs); else printf("NA,");
+    if (falhas >= 0) printf("%lld\n", falhas); else printf("NA\n");
+    fflush(stdout);
+}
+
+// Adaptadores do Merge Sort paralelo para a assinatura das demais ordenações
+void paraleloNome(Componente lista[], int n, int *comparacoes) {
+    mergeSortParalelo(lista, n, CAMPO_NOME, threadsConfiguradas(), comparacoes);
+}
+
+void paraleloTipo(Componente lista[], int n, int *comparacoes) {
+    mergeSortParalelo(lista, n, CAMPO_TIPO, threadsConfiguradas(), comparacoes);
+}
+
+void paraleloPrioridade(Componente lista[], int n, int *comparacoes) {
+    mergeSortParalelo(lista, n, CAMPO_PRIORIDADE, threadsConfiguradas(), comparacoes);
+}
+
+// Ordenações medidas; as quadráticas só rodam até LIMITE_BENCH_QUADRATICO
+typedef struct {
+    const char *nome;
+    void (*ordenar)(Componente lista[], int n, int *comparacoes);
+    int quadratica;
+} AlgoritmoBenchmark;
+
+const AlgoritmoBenchmark algoritmosBenchmark[] = {
+    {"bubble_nome", bubbleSortNome, 1},
+    {"insertion_tipo", insertionSortTipo, 1},
+    {"selection_prioridade", selectionSortPrioridade, 1},
+    {"merge_nome", mergeSortNome, 0},
+    {"intro_tipo", introSortTipo, 0},
+    {"counting_prioridade", countingSortPrioridade, 0},
+    {"radix_nome", radixSortNome, 0},
+    {"composta_tipo_prioridade_nome", compostaTipoPrioridadeNome, 0},
+    {"paralelo_nome", paraleloNome, 0},
+    {"paralelo_tipo", paraleloTipo, 0},
+    {"paralelo_prioridade", paraleloPrioridade, 0},
+};
+
+// Ordena pelo nome usado no roteiro e no diário: um dos algoritmosBenchmark ou
+// "composta <colunas>". Em 'registro' (se não for NULL, TAM_NOME bytes) sai o nome
+// na forma que o diário grava. Devolve 0 se o nome não existe
+int ordenarPorEspecificacao(Componente lista[], int n, const char *especificacao, char *registro, int *comparacoes) {
+    if (strncmp(especificacao, "composta ", 9) == 0) {
+        OrdemComposta ordem;
+        char colunas[2 * NUM_CAMPOS + 1];
+        if (!interpretarOrdemComposta(especificacao + 9, &ordem))
+            return 0;
+        ordenarComposto(lista, n, &ordem, comparacoes);
+        descreverOrdemComposta(&ordem, colunas);
+        if (registro != NULL)
+            snprintf(registro, TAM_NOME, "composta %s", colunas);
+        return 1;
+    }
+    int total = (int)(sizeof(algoritmosBenchmark) / sizeof(algoritmosBenchmark[0])), a = 0;
+    while (a < total && strcmp(algoritmosBenchmark[a].nome, especificacao) != 0)
+        a++;
+    if (a == total)
+        return 0;
+    algoritmosBenchmark[a].ordenar(lista, n, comparacoes);
+    if (registro != NULL)
+        snprintf(registro, TAM_NOME, "%s", algoritmosBenchmark[a].nome);
+    return 1;
+}
+
+// Mede as buscas por nome com consultas a nomes existentes
+void benchmarkBuscas(const Componente original[], Componente trabalho[], int n, Distribuicao dist, const ContadorCache *contador) {
+    int consultas = n < CONSULTAS_BENCH ? n : CONSULTAS_BENCH, comparacoes;
+    long long total;
+    int *alvos = alocar((size_t)consultas * sizeof(int));
+    uint32_t semente = 777u;
+    for (int q = 0; q < consultas; q++) {
+        semente = semente * 1664525u + 1013904223u;
+        alvos[q] = (int)(semente % (uint32_t)n);
+    }
+
+    // Sequencial sobre o inventário original
+    if (n <= LIMITE_BENCH_LINEAR) {
+        total = 0;
+        iniciarContador(contador);
+        double inicio = tempoMs();
+        for (int q = 0; q < consultas; q++) {
+            buscaSequencial(original, n, original[alvos[q]].nome, &comparacoes);
+            total += comparacoes;
+        }
+        double tempo = tempoMs() - inicio;
+        linhaBenchmark("busca_sequencial", dist, n, tempo, total, 0, pararContador(contador));
+    }
+
+    // Binária sobre uma cópia ordenada por nome (a ordenação não entra na medida)
+    memcpy(trabalho, original, (size_t)n * sizeof(Componente));
+    mergeSortNome(trabalho, n, &comparacoes);
+    total = 0;
+    iniciarContador(contador);
+    double inicio = tempoMs();
+    for (int q = 0; q < consultas; q++) {
+        buscaBinaria(trabalho, n, original[alvos[q]].nome, &comparacoes);
+        total += comparacoes;
+    }
+    double tempo = tempoMs() - inicio;
+    linhaBenchmark("busca_binaria", dist, n, tempo, total, 0, pararContador(contador));
+
+    // Índice (treap) e tabela hash de uma mochila com o inventário original
+    Mochila m;
+    iniciarMochila(&m, n, NULL);
+    memcpy(m.itens, original, (size_t)n * sizeof(Componente));
+    m.qtd = n;
+    iniciarContador(contador);
+    inicio = tempoMs();
+    ativarIndices(&m);
+    ativarTabelaNomes(&m);
+    tempo = tempoMs() - inicio;
+    linhaBenchmark("construcao_indices", dist, n, tempo, -1, -1, pararContador(contador));
+
+    total = 0;
+    iniciarContador(contador);
+    inicio = tempoMs();
+    for (int q = 0; q < consultas; q++) {
+        buscaIndexadaPorNome(&m, original[alvos[q]].nome, &comparacoes);
+        total += comparacoes;
+    }
+    tempo = tempoMs() - inicio;
+    linhaBenchmark("busca_indice", dist, n, tempo, total, 0, pararContador(contador));
+
+    iniciarContador(contador);
+    inicio = tempoMs();
+    for (int q = 0; q < consultas; q++)
+        posicaoPorNome(&m, original[alvos[q]].nome);
+    tempo = tempoMs() - inicio;
+    linhaBenchmark("busca_hash", dist, n, tempo, -1, 0, pararContador(contador));
+
+    // Prefixo (metade do nome) e aproximada (distância 1) sobre o índice sem caso e os trigramas
+    int resultados[MAX_LISTAGEM_FILTRO], distancias[MAX_LISTAGEM_FILTRO];
+    char prefixo[TAM_NOME];
+    iniciarContador(contador);
+    inicio = tempoMs();
+    for (int q = 0; q < consultas; q++) {
+        size_t metade = strlen(original[alvos[q]].nome) / 2;
+        memcpy(prefixo, original[alvos[q]].nome, metade);
+        prefixo[metade] = '\0';
+        buscarPorPrefixo(&m, prefixo, resultados, MAX_LISTAGEM_FILTRO);
+    }
+    tempo = tempoMs() - inicio;
+    linhaBenchmark("busca_prefixo", dist, n, tempo, -1, 0, pararContador(contador));
+
+    if (n <= LIMITE_BENCH_LINEAR) {
+        iniciarContador(contador);
+        inicio = tempoMs();
+        ativarIndiceTrigramas(&m);
+        reconstruirIndiceTrigramas(&m);
+        tempo = tempoMs() - inicio;
+        linhaBenchmark("construcao_trigramas", dist, n, tempo, -1, -1, pararContador(contador));
+
+        iniciarContador(contador);
+        inicio = tempoMs();
+        for (int q = 0; q < consultas; q++)
+            buscarAproximado(&m, original[alvos[q]].nome, 1, resultados, distancias, MAX_LISTAGEM_FILTRO);
+        tempo = tempoMs() - inicio;
+        linhaBenchmark("busca_aproximada", dist, n, tempo, -1, 0, pararContador(contador));
+    }
+
+    liberarMochila(&m);
+    free(alvos);
+}
+
+// Roda todas as ordenações e buscas em todas as distribuições, de 10 até nMaximo componentes
+void benchmarkCompleto(int nMaximo) {
+    // O pool já existe ao abrir os contadores: cada auxiliar ganha o seu
+    ContadorCache contador;
+    abrirContadorCache(&contador, obterPool(threadsConfiguradas()));
+    int total = (int)(sizeof(algoritmosBenchmark) / sizeof(algoritmosBenchmark[0]));
+    Componente *original = alocar((size_t)nMaximo * sizeof(Componente));
+    Componente *trabalho = alocar((size_t)nMaximo * sizeof(Componente));
+
+    printf("algoritmo,distribuicao,n,tempo_ms,comparacoes,movimentos,falhas_cache\n");
+    for (long n = 10; n <= nMaximo; n *= 10) {
+        for (int d = 0; d < NUM_DISTRIBUICOES; d++) {
+            gerarInventario(original, (int)n, (Distribuicao)d, 12345u);
+            for (int a = 0; a < total; a++) {
+                if (algoritmosBenchmark[a].quadratica && n > LIMITE_BENCH_QUADRATICO)
+                    continue;
+                int comparacoes;
+                memcpy(trabalho, original, (size_t)n * sizeof(Componente));
+                movimentos = 0;
+                iniciarContador(&contador);
+                double inicio = tempoMs();
+                algoritmosBenchmark[a].ordenar(trabalho, (int)n, &comparacoes);
+                double tempo = tempoMs() - inicio;
+                linhaBenchmark(algoritmosBenchmark[a].nome, (Distribuicao)d, (int)n, tempo,
+                               comparacoes, movimentos, pararContador(&contador));
+            }
+            benchmarkBuscas(original, trabalho, (int)n, (Distribuicao)d, &contador);
+        }
+    }
+
+    fecharContadorCache(&contador);
+    free(original);
+    free(trabalho);
+}
+
+// Mede a escala da ordenação paralela de 1 até todos os núcleos (--bench-paralelo N)
+void benchmarkParalelo(int n) {
+    static const char *nomesCampos[] = {"nome", "tipo", "prioridade"};
+    int maxThreads = threadsConfiguradas();
+    Componente *lista = alocar((size_t)n * sizeof(Componente));
+
+    printf("campo,threads,n,tempo_ms,comparacoes,aceleracao\n");
+    for (int c = 0; c < NUM_CAMPOS; c++) {
+        double base = 0;
+        for (int t = 1;; t = t * 2 < maxThreads ? t * 2 : maxThreads) {
+            int comparacoes;
+            gerarInventario(lista, n, DIST_ALEATORIA, 12345u);
+            double inicio = tempoMs();
+            mergeSortParalelo(lista, n, (CampoOrdenacao)c, t, &comparacoes);
+            double tempo = tempoMs() - inicio;
+            if (t == 1)
+                base = tempo;
+            printf("%s,%d,%d,%.3f,%d,%.2f\n", nomesCampos[c], t, n, tempo, comparacoes, base / tempo);
+            if (t == maxThreads)
+                break;
+        }
+    }
+    free(lista);
+}
+
+// Adições, remoções e mudanças de prioridade reproduzíveis; devolve quantas alterações fez
+long alteracoesDeTeste(Mochila *m, const Componente lista[], int n) {
+    uint32_t semente = 777u;
+    for (int i = 0; i < n; i++)
+        anexarComponente(m, &lista[i]);
+    for (int i = 0; i < n / 4; i++) {
+        semente = semente * 1664525u + 1013904223u;
+        removerComponente(m, (int)(semente % (uint32_t)m->qtd));
+        atualizarPrioridade(m, (int)((semente >> 8) % (uint32_t)m->qtd), (int)(semente >> 24));
+    }
+    return n + (long)(n / 4) * 2;
+}
+
+// Abre a mochila do diretório como o programa faz ao iniciar (diário e depois os índices);
+// devolve o tempo da recuperação e em 'tempoIndices' o da montagem dos índices (ms)
+double recuperarParaBenchmark(Mochila *m, const char *diretorio, double *tempoIndices) {
+    double inicio = tempoMs();
+    iniciarMochila(m, CAPACIDADE_INICIAL, NULL);
+    if (diretorio != NULL && !abrirDiario(m, diretorio, NULL)) {
+        printf("\n❌ Não foi possível abrir o diário em '%s'.\n", diretorio);
+        exit(EXIT_FAILURE);
+    }
+    double recuperacao = tempoMs() - inicio;
+    inicio = tempoMs();
+    ativarIndices(m);
+    ativarTabelaNomes(m);
+    ativarColunas(m);
+    ativarHeap(m);
+    ativarIndiceTrigramas(m);
+    ativarResumos(m);
+    if (tempoIndices != NULL)
+        *tempoIndices = tempoMs() - inicio;
+    return recuperacao;
+}
+
+// 1 se as duas mochilas têm os mesmos componentes nas mesmas posições
+int mesmasPosicoes(const Componente *a, int na, const Componente *b, int nb) {
+    if (na != nb)
+        return 0;
+    for (int i = 0; i < na; i++)
+        if (strcmp(a[i].nome, b[i].nome) != 0 || strcmp(a[i].tipo, b[i].tipo) != 0 ||
+            a[i].prioridade != b[i].prioridade || a[i].qtd != b[i].qtd)
+            return 0;
+    return 1;
+}
+
+// Mede o custo do diário nas alterações e o tempo de recuperação (--bench-diario N)
+void benchmarkDiario(int n) {
+    char diretorio[] = "/tmp/freefire-diario-XXXXXX";
+    if (n <= 0 || mkdtemp(diretorio) == NULL) {
+        printf("\n❌ Não foi possível preparar o benchmark do diário.\n");
+        return;
+    }
+    Componente *lista = alocar((size_t)n * sizeof(Componente));
+    gerarInventario(lista, n, DIST_ALEATORIA, 12345u);
+
+    // Mesmas alterações sem e com diário (com diário, até o último registro estar sincronizado)
+    printf("etapa,n,tempo_ms,operacoes_por_s\n");
+    Mochila m;
+    double tempos[2];
+    long operacoes = 0;
+    for (int comDiario = 0; comDiario <= 1; comDiario++) {
+        recuperarParaBenchmark(&m, comDiario ? diretorio : NULL, NULL);
+        double inicio = tempoMs();
+        operacoes = alteracoesDeTeste(&m, lista, n);
+        if (comDiario)
+            sincronizarDiario(m.diario);
+        tempos[comDiario] = tempoMs() - inicio;
+        printf("%s,%d,%.3f,%.0f\n", comDiario ? "alteracoes_com_diario" : "alteracoes_sem_diario", n,
+               tempos[comDiario], operacoes * 1e3 / tempos[comDiario]);
+        if (!comDiario)
+            liberarMochila(&m);
+    }
+    fprintf(stderr, "diário: %+.1f%% de tempo nas alterações; %lld fdatasync(s), %.0f registro(s) por grupo\n",
+            (tempos[1] / tempos[0] - 1) * 100, m.diario->grupos,
+            m.diario->grupos > 0 ? (double)m.diario->enfileirados / m.diario->grupos : 0.0);
+
+    // Recupera do ponto de verificação automático + diário, depois só do ponto
+    // (a montagem dos índices é a mesma de qualquer carga e sai numa linha à parte)
+    int qtdEsperada = m.qtd;
+    Componente *esperado = alocar((size_t)(qtdEsperada > 0 ? qtdEsperada : 1) * sizeof(Componente));
+    memcpy(esperado, m.itens, (size_t)qtdEsperada * sizeof(Componente));
+    liberarMochila(&m);
+    for (int etapa = 0; etapa < 2; etapa++) {
+        double tempoIndices;
+        double tempo = recuperarParaBenchmark(&m, diretorio, &tempoIndices);
+        printf("%s,%d,%.3f,%.0f\n", etapa == 0 ? "recuperacao_ponto_e_diario" : "recuperacao_so_ponto",
+               m.qtd, tempo, m.qtd * 1e3 / tempo);
+        printf("construcao_indices,%d,%.3f,%.0f\n", m.qtd, tempoIndices, m.qtd * 1e3 / tempoIndices);
+        if (!mesmasPosicoes(m.itens, m.qtd, esperado, qtdEsperada))
+            fprintf(stderr, "❌ %s: a mochila recuperada difere da original\n", etapa == 0 ? "ponto e diário" : "só ponto");
+        if (etapa == 0) {
+            double inicio = tempoMs();
+            pontoDeVerificacao(&m);
+            tempo = tempoMs() - inicio;
+            printf("ponto_de_verificacao,%d,%.3f,%.0f\n", m.qtd, tempo, m.qtd * 1e3 / tempo);
+        }
+        liberarMochila(&m);
+    }
+
+    char caminho[sizeof(diretorio) + 16];
+    snprintf(caminho, sizeof(caminho), "%s/mochila.wal", diretorio);
+    remove(caminho);
+    snprintf(caminho, sizeof(caminho), "%s/mochila.ckpt", diretorio);
+    remove(caminho);
+    rmdir(diretorio);
+    free(esperado);
+    free(lista);
+}
+
+// -------------------------------
+// MODO ROTEIRO (--script ARQ)
+// -------------------------------
+// Executa um fluxo de comandos, um por linha, sem prompts (para repetir sessões
+// gravadas e para testes de carga). A entrada é lida em blocos de TAM_BUFFER_ES
+// bytes e cada linha é interpretada direto no buffer. Linhas vazias e iniciadas
+// por '#' são ignoradas. Comandos:
+//   adicionar nome,tipo,prioridade,qtd   (mesmo formato de uma linha do CSV)
+//   descartar nome
+//   ordenar algoritmo                    (nomes do --bench, ex.: radix_nome)
+//   ordenar composta colunas             (ex.: t-pn)
+//   buscar nome
+//   prefixo texto
+//   aproximada distância texto
+//   listar
+//   resumo                               (tipo,componentes,qtd_total,prioridade_min,prioridade_max)
+// Os resultados saem em CSV na saída padrão; erros e o relatório de latência
+// (por comando e vazão total) saem na saída de erros.
+
+typedef enum {
+    CMD_ADICIONAR,
+    CMD_DESCARTAR,
+    CMD_ORDENAR,
+    CMD_BUSCAR,
+    CMD_PREFIXO,
+    CMD_APROXIMADA,
+    CMD_LISTAR,
+    CMD_RESUMO,
+    NUM_COMANDOS
+} ComandoRoteiro;
+
+const char *nomesComandos[NUM_COMANDOS] = {
+    "adicionar", "descartar", "ordenar", "buscar", "prefixo", "aproximada", "listar", "resumo"
+};
+
+// Latências de um tipo de comando (vetor do núcleo comum)
+DEFINIR_VETOR(LatenciasComando, double)
+
+int compararTempos(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Percentil p (0-100) de tempos já ordenados, pelo posto mais próximo
+double percentil(const double tempos[], int qtd, int p) {
+    int posto = (qtd * p + 99) / 100;
+    return tempos[posto > 0 ? posto - 1 : 0];
+}
+
+// Componente em CSV na saída padrão, com as mesmas aspas da exportação
+void imprimirComponenteCSV(const Componente *c) {
+    char linha[2 * (TAM_NOME + TAM_TIPO) + 32];
+    char *saida = escreverCampoCSV(linha, c->nome);
+    *saida++ = ',';
+    saida = escreverCampoCSV(saida, c->tipo);
+    sprintf(saida, ",%d,%d\n", c->prioridade, c->qtd);
+    fputs(linha, stdout);
+}
+
+// Executa uma linha já sem o fim de linha; devolve o comando ou -1 se for inválida
+int executarComando(const char *linha, const char *fim) {
+    const char *espaco = memchr(linha, ' ', (size_t)(fim - linha));
+    const char *fimVerbo = espaco ? espaco : fim;
+    size_t tamanhoVerbo = (size_t)(fimVerbo - linha);
+    const char *argumento = espaco ? espaco + 1 : fim;
+
+    int comando = -1;
+    for (int c = 0; c < NUM_COMANDOS; c++)
+        if (strlen(nomesComandos[c]) == tamanhoVerbo && memcmp(linha, nomesComandos[c], tamanhoVerbo) == 0)
+            comando = c;
+
+    char texto[TAM_LINHA_ROTEIRO];
+    size_t tamanho = (size_t)(fim - argumento);
+    if (tamanho >= sizeof(texto))
+        return -1;
+    memcpy(texto, argumento, tamanho);
+    texto[tamanho] = '\0';
+
+    int resultados[MAX_LISTAGEM_FILTRO], distancias[MAX_LISTAGEM_FILTRO], n, comparacoes;
+    switch (comando) {
+        case CMD_ADICIONAR: {
+            Componente c;
+            memset(&c, 0, sizeof(c));
+            if (!lerLinhaCSV(argumento, fim, &c))
+                return -1;
+            anexarComponente(&mochila, &c);
+            break;
+        }
+        case CMD_DESCARTAR:
+            if (!removerComponentePorNome(&mochila, texto))
+                printf("nao_encontrado,%s\n", texto);
+            break;
+        case CMD_ORDENAR: {
+            char registro[TAM_NOME];
+            movimentos = 0;
+            if (!ordenarPorEspecificacao(mochila.itens, mochila.qtd, texto, registro, &comparacoes))
+                return -1;
+            TELEMETRIA_CONTAR("ordenacao.comparacoes", comparacoes);
+            TELEMETRIA_CONTAR("ordenacao.movimentos", movimentos);
+            reconstruirAuxiliares(&mochila); // As posições mudaram
+            registrarOrdenacao(&mochila, registro);
+            break;
+        }
+        case CMD_BUSCAR: {
+            int posicao = ordenadoPorNome ? buscaBinaria(mochila.itens, mochila.qtd, texto, &comparacoes)
+                                          : posicaoPorNome(&mochila, texto);
+            if (posicao >= 0)
+                imprimirComponenteCSV(&mochila.itens[posicao]);
+            else
+                printf("nao_encontrado,%s\n", texto);
+            break;
+        }
+        case CMD_PREFIXO:
+            n = buscarPorPrefixo(&mochila, texto, resultados, MAX_LISTAGEM_FILTRO);
+            for (int i = 0; i < n; i++)
+                imprimirComponenteCSV(&mochila.itens[resultados[i]]);
+            break;
+        case CMD_APROXIMADA: {
+            char *resto;
+            long maxDistancia = strtol(texto, &resto, 10);
+            if (resto == texto || *resto != ' ' || maxDistancia < 0 || maxDistancia > MAX_DISTANCIA_BUSCA)
+                return -1;
+            n = buscarAproximado(&mochila, resto + 1, (int)maxDistancia, resultados, distancias, MAX_LISTAGEM_FILTRO);
+            for (int i = 0; i < n; i++)
+                imprimirComponenteCSV(&mochila.itens[resultados[i]]);
+            break;
+        }
+        case CMD_LISTAR:
+            for (int i = 0; i < mochila.qtd; i++)
+                imprimirComponenteCSV(&mochila.itens[i]);
+            break;
+        case CMD_RESUMO: {
+            const ResumoTipo **lista;
+            n = listarResumos(&mochila, &lista);
+            for (int i = 0; i < n; i++) {
+                char saidaCSV[2 * TAM_TIPO + 64];
+                int menor, maior;
+                faixaDoResumo(lista[i], &menor, &maior);
+                char *saida = escreverCampoCSV(saidaCSV, lista[i]->tipo);
+                sprintf(saida, ",%d,%lld,%d,%d\n", lista[i]->componentes, lista[i]->totalQtd, menor, maior);
+                fputs(saidaCSV, stdout);
+            }
+            free(lista);
+            break;
+        }
+        default:
+            return -1;
+    }
+    return comando;
+}
+
+// Relatório de latência por comando e vazão total (saída de erros)
+void relatorioRoteiro(LatenciasComando latencias[], double total, long executados, long invalidas) {
+    fprintf(stderr, "comando,qtd,total_ms,media_us,p50_us,p99_us,max_us\n");
+    for (int c = 0; c < NUM_COMANDOS; c++) {
+        LatenciasComando *l = &latencias[c];
+        if (l->qtd == 0)
+            continue;
+        double soma = 0;
+        for (int i = 0; i < l->qtd; i++)
+            soma += l->itens[i];
+        qsort(l->itens, (size_t)l->qtd, sizeof(double), compararTempos);
+        fprintf(stderr, "%s,%d,%.3f,%.2f,%.2f,%.2f,%.2f\n", nomesComandos[c], l->qtd, soma,
+                soma * 1e3 / l->qtd, percentil(l->itens, l->qtd, 50) * 1e3,
+                percentil(l->itens, l->qtd, 99) * 1e3, l->itens[l->qtd - 1] * 1e3);
+    }
+    fprintf(stderr, "total: %ld comandos em %.3f ms (%.0f comandos/s), %ld linhas inválidas\n",
+            executados, total, total > 0 ? executados * 1e3 / total : 0.0, invalidas);
+}
+
+// Executa o roteiro do arquivo ('-' = entrada padrão); devolve 0 se tudo foi válido
+int executarRoteiro(const char *caminho) {
+    FILE *arquivo = strcmp(caminho, "-") == 0 ? stdin : fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        fprintf(stderr, "❌ Não foi possível abrir '%s'.\n", caminho);
+        return 1;
+    }
+    setvbuf(stdout, NULL, _IOFBF, TAM_BUFFER_ES); // Resultados em blocos, não por linha
+
+    LatenciasComando latencias[NUM_COMANDOS];
+    memset(latencias, 0, sizeof(latencias));
+    char *buffer = alocar(TAM_BUFFER_ES);
+    size_t usados = 0;
+    long numeroLinha = 0, executados = 0, invalidas = 0;
+    int fimArquivo = 0;
+    double inicioTotal = tempoMs();
+
+    while (!fimArquivo) {
+        size_t lidos = fread(buffer + usados, 1, TAM_BUFFER_ES - usados, arquivo);
+        usados += lidos;
+        fimArquivo = lidos == 0;
+
+        char *p = buffer, *fimDados = buffer + usados;
+        while (p < fimDados) {
+            char *quebra = memchr(p, '\n', (size_t)(fimDados - p));
+            if (quebra == NULL) {
+                if (!fimArquivo)
+                    break; // Linha incompleta: espera o próximo bloco
+                quebra = fimDados;
+            }
+            char *fimLinha = quebra;
+            if (fimLinha > p && fimLinha[-1] == '\r')
+                fimLinha--;
+            numeroLinha++;
+
+            if (fimLinha > p && *p != '#') {
+                double inicio = tempoMs();
+                TELEMETRIA_INICIO(marcaComando);
+                int comando = executarComando(p, fimLinha);
+                TELEMETRIA_FIM(marcaComando, comando >= 0 ? nomesComandos[comando] : "invalido");
+                double tempo = tempoMs() - inicio;
+                if (comando < 0) {
+                    fprintf(stderr, "linha %ld: comando inválido: %.*s\n", numeroLinha, (int)(fimLinha - p), p);
+                    invalidas++;
+                } else {
+                    LatenciasComando_acrescentar(&latencias[comando], tempo);
+                    executados++;
+                }
+            }
+            p = quebra + 1;
+        }
+
+        usados = p < fimDados ? (size_t)(fimDados - p) : 0;
+        if (usados == TAM_BUFFER_ES) { // Linha maior que o buffer inteiro: descarta
+            invalidas++;
+            usados = 0;
+        }
+        memmove(buffer, p, usados);
+    }
+    double total = tempoMs() - inicioTotal;
+    fflush(stdout);
+
+    relatorioRoteiro(latencias, total, executados, invalidas);
+    for (int c = 0; c < NUM_COMANDOS; c++)
+        LatenciasComando_liberar(&latencias[c]);
+    free(buffer);
+    if (arquivo != stdin)
+        fclose(arquivo);
+    return invalidas > 0;
+}
+
+// -------------------------------
+// MENU PRINCIPAL
+// -------------------------------
+void menu() {
+    int opcao, comparacoes;
+
+    do {
+        printf("\n==================================================================\n");
+        printf("PLANO DE FUGA – CODIGO DA ILHA (NIVEL MESTRE)\n");
+        printf("==================================================================\n");
+        printf("Itens na Mochila: %d (capacidade reservada: %d)\n", mochila.qtd, mochila.capacidade);
+        printf("Status da ordenação por nome: %s\n\n", ordenadoPorNome ? "ORDENADO" : "NAO ORDENADO");
+        printf("1. Adicionar Componente\n");
+        printf("2. Descartar Componente\n");
+        printf("3. Listar Componentes (Inventario)\n");
+        printf("4. Organizar Mochila (Ordenar componentes)\n");
+        printf("5. Busca por componente-chave (por nome)\n");
+        printf("6. Listar em ordem (nome, tipo ou prioridade)\n");
+        printf("7. Descartar vários componentes (em lote)\n");
+        printf("8. Importar/Exportar inventário (CSV ou binário)\n");
+        printf("9. Análise rápida (quantidades, prioridades, filtro)\n");
+        printf("10. Componentes críticos (fila de prioridade)\n");
+        printf("11. Carga ótima (limite de espaços)\n");
+        printf("12. Busca por prefixo ou aproximada\n");
+        printf("13. Resumo por tipo (componentes, quantidade total, prioridades)\n");
+        printf("0. ATIVAR TORRE DE FUGA (Sair)\n");
+        printf("-------------------------------------------------------------------\n");
+        printf("Escolha uma opção: ");
+        opcao = lerInt();
+
+        switch (opcao) {
+            case 1: adicionarComponente(); break;
+            case 2: descartarComponente(); break;
+            case 3: mostrarComponentes(mochila.itens, mochila.qtd); break;
+
+            case 4: {
+                int escolha;
+                printf("\nEscolha o método de ordenação:\n");
+                printf("1. Bubble Sort (por nome)\n");
+                printf("2. Insertion Sort (por tipo)\n");
+                printf("3. Selection Sort (por prioridade)\n");
+                printf("4. Merge Sort (por nome)\n");
+                printf("5. Introsort (por tipo)\n");
+                printf("6. Counting Sort (por prioridade)\n");
+                printf("7. Radix Sort MSD (por nome)\n");
+                printf("8. Merge Sort paralelo (%d threads, qualquer campo)\n", threadsConfiguradas());
+                printf("9. Ordem composta (várias colunas, ex.: tpn)\n");
+                printf("Opção: ");
+                escolha = lerInt();
+
+                double inicio = tempoMs();
+                TELEMETRIA_INICIO(marcaOrdenacao);
+                comparacoes = -1;
+                movimentos = 0;
+                char registro[TAM_NOME]; // Nome da ordenação no diário
+                switch (escolha) {
+                    case 1: bubbleSortNome(mochila.itens, mochila.qtd, &comparacoes); strcpy(registro, "bubble_nome"); break;
+                    case 2: insertionSortTipo(mochila.itens, mochila.qtd, &comparacoes); strcpy(registro, "insertion_tipo"); break;
+                    case 3: selectionSortPrioridade(mochila.itens, mochila.qtd, &comparacoes); strcpy(registro, "selection_prioridade"); break;
+                    case 4: mergeSortNome(mochila.itens, mochila.qtd, &comparacoes); strcpy(registro, "merge_nome"); break;
+                    case 5: introSortTipo(mochila.itens, mochila.qtd, &comparacoes); strcpy(registro, "intro_tipo"); break;
+                    case 6: countingSortPrioridade(mochila.itens, mochila.qtd, &comparacoes); strcpy(registro, "counting_prioridade"); break;
+                    case 7: radixSortNome(mochila.itens, mochila.qtd, &comparacoes); strcpy(registro, "radix_nome"); break;
+                    case 8: {
+                        static const char *paralelos[NUM_CAMPOS] = {"paralelo_nome", "paralelo_tipo", "paralelo_prioridade"};
+                        printf("Campo (1. Nome, 2. Tipo, 3. Prioridade): ");
+                        int campo = lerInt();
+                        if (campo < 1 || campo > NUM_CAMPOS) {
+                            printf("\n❌ Opção inválida.\n");
+                            break;
+                        }
+                        inicio = tempoMs(); // Não conta o tempo de digitação
+                        TELEMETRIA_MARCAR(marcaOrdenacao);
+                        mergeSortParalelo(mochila.itens, mochila.qtd, (CampoOrdenacao)(campo - 1), threadsConfiguradas(), &comparacoes);
+                        strcpy(registro, paralelos[campo - 1]);
+                        break;
+                    }
+                    case 9: {
+                        char texto[16];
+                        OrdemComposta ordem;
+                        printf("Colunas (n = nome, t = tipo, p = prioridade; '-' = decrescente), ex.: t-pn: ");
+                        lerString(texto, sizeof(texto));
+                        if (!interpretarOrdemComposta(texto, &ordem)) {
+                            printf("\n❌ Ordem inválida.\n");
+                            break;
+                        }
+                        inicio = tempoMs();
+                        TELEMETRIA_MARCAR(marcaOrdenacao);
+                        ordenarComposto(mochila.itens, mochila.qtd, &ordem, &comparacoes);
+                        strcpy(registro, "composta ");
+                        descreverOrdemComposta(&ordem, registro + 9);
+                        break;
+                    }
+                    default: printf("\n❌ Opção inválida.\n");
+                }
+                if (comparacoes >= 0) {
+                    TELEMETRIA_FIM(marcaOrdenacao, "ordenar");
+                    TELEMETRIA_CONTAR("ordenacao.comparacoes", comparacoes);
+                    TELEMETRIA_CONTAR("ordenacao.movimentos", movimentos);
+                    printf("\n✅ Mochila organizada! Comparações: %d | Tempo: %.3f ms\n", comparacoes, tempoMs() - inicio);
+                    reconstruirAuxiliares(&mochila); // As posições mudaram
+                    registrarOrdenacao(&mochila, registro);
+                }
+                break;
+            }
+
+            case 5: {
+                char nomeBusca[TAM_NOME];
+                printf("\nDigite o nome do componente-chave: ");
+                lerString(nomeBusca, TAM_NOME);
+                if (ordenadoPorNome) { // Vetor ordenado: busca binária direta
+                    buscaBinariaPorNome(mochila.itens, mochila.qtd, nomeBusca);
+                    break;
+                }
+                // Fora de ordem: consulta o índice por nome
+                int posicao = buscaIndexadaPorNome(&mochila, nomeBusca, &comparacoes);
+                if (posicao < 0) {
+                    printf("\n❌ Componente não encontrado.\n");
+                    break;
+                }
+                Componente *c = &mochila.itens[posicao];
+                printf("\n✅ Componente encontrado (índice por nome)!\n");
+                printf("Nome: %s\nTipo: %s\nPrioridade: %d\nQuantidade: %d\n", c->nome, c->tipo, c->prioridade, c->qtd);
+                printf("🔍 Comparações realizadas: %d\n", comparacoes);
+                break;
+            }
+
+            case 6: {
+                printf("\nOrdenar listagem por:\n");
+                printf("1. Nome\n2. Tipo\n3. Prioridade\n4. Nome (sem diferenciar maiúsculas)\n");
+                printf("Opção: ");
+                int escolha = lerInt();
+                if (escolha < 1 || escolha > NUM_INDICES) {
+                    printf("\n❌ Opção inválida.\n");
+                    break;
+                }
+                mostrarPorIndice(&mochila, (CampoOrdenacao)(escolha - 1));
+                break;
+            }
+
+            case 7: descartarEmLote(); break;
+
+            case 8: {
+                char caminho[PATH_MAX];
+                printf("\n1. Importar\n2. Exportar\nOpção: ");
+                int escolha = lerInt();
+                if (escolha != 1 && escolha != 2) {
+                    printf("\n❌ Opção inválida.\n");
+                    break;
+                }
+                printf("Arquivo (.csv para CSV, outra extensão para binário): ");
+                lerString(caminho, sizeof(caminho));
+                if (escolha == 1)
+                    importarArquivo(caminho);
+                else
+                    exportarArquivo(caminho);
+                break;
+            }
+
+            case 9: analisarMochila(); break;
+            case 10: menuCriticos(); break;
+            case 11: planejarCarga(); break;
+            case 12: buscarNomesFlexivel(); break;
+            case 13: mostrarResumoPorTipo(); break;
+
+            case 0: printf("\n🚀 Torre de Fuga ativada! Missão concluída.\n"); break;
+            default: printf("\n❌ Opção inválida! Tente novamente.\n");
+        }
+
+    } while (opcao != 0);
+}
+
+// -------------------------------
+// FUNÇÃO PRINCIPAL
+// -------------------------------
+int main(int argc, char *argv[]) {
+    const char *arquivoImportar = NULL, *roteiro = NULL, *diretorioDiario = NULL;
+    int diarioSincrono = 0;
+    saidaAvisos = stdout;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--arena") == 0 && i + 1 < argc) { // Arena de N MB para a mochila
+            arenaMochila = criarArena((size_t)atol(argv[++i]) << 20);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) { // Threads da ordenação paralela
+            threadsOrdenacao = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--importar") == 0 && i + 1 < argc) { // Carrega um inventário ao iniciar
+            arquivoImportar = argv[++i];
+        } else if (strcmp(argv[i], "--wal") == 0 && i + 1 < argc) { // Recupera e registra as alterações no diretório
+            diretorioDiario = argv[++i];
+        } else if (strcmp(argv[i], "--wal-sincrono") == 0) { // Só confirma a alteração depois do fdatasync
+            diarioSincrono = 1;
+        } else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) { // Comandos de um arquivo ou '-' (sem menu)
+            roteiro = argv[++i];
+        } else if (strcmp(argv[i], "--bench") == 0) { // CSV de todas as ordenações e buscas
+            int maximo = i + 1 < argc && argv[i + 1][0] != '-' ? atoi(argv[++i]) : BENCH_MAXIMO_PADRAO;
+            benchmarkCompleto(maximo);
+            liberarPool(poolOrdenacao);
+            return 0;
+        } else if (strcmp(argv[i], "--bench-paralelo") == 0 && i + 1 < argc) { // Escala de 1 a N núcleos
+            benchmarkParalelo(atoi(argv[++i]));
+            liberarPool(poolOrdenacao);
+            return 0;
+        } else if (strcmp(argv[i], "--bench-diario") == 0 && i + 1 < argc) { // Custo do diário e da recuperação
+            benchmarkDiario(atoi(argv[++i]));
+            return 0;
+        } else {
+            printf("Uso: %s [--arena MB] [--threads N] [--importar ARQ] [--wal DIR [--wal-sincrono]] [--script ARQ|-] [--bench [N_MAX]] [--bench-paralelo N] [--bench-diario N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (roteiro != NULL) // A saída padrão fica só com os resultados dos comandos
+        saidaAvisos = stderr;
+    iniciarMochila(&mochila, CAPACIDADE_INICIAL, arenaMochila);
+    if (diretorioDiario != NULL) { // Antes dos índices: eles são montados uma vez só, já recuperados
+        long reaplicados = 0;
+        double inicio = tempoMs();
+        if (!abrirDiario(&mochila, diretorioDiario, &reaplicados)) {
+            fprintf(saidaAvisos, "\n❌ Não foi possível abrir o diário em '%s'.\n", diretorioDiario);
+            return 1;
+        }
+        mochila.diario->sincrono = diarioSincrono;
+        fprintf(saidaAvisos, "\n📒 %d componente(s) recuperado(s) de '%s' (%ld registro(s) do diário) em %.1f ms.\n",
+               mochila.qtd, diretorioDiario, reaplicados, tempoMs() - inicio);
+    }
+    ativarIndices(&mochila);
+    ativarTabelaNomes(&mochila);
+    ativarColunas(&mochila);
+    ativarHeap(&mochila);
+    ativarIndiceTrigramas(&mochila);
+    ativarResumos(&mochila);
+    if (arquivoImportar != NULL)
+        importarArquivo(arquivoImportar);
+    int status = 0;
+    if (roteiro != NULL)
+        status = executarRoteiro(roteiro);
+    else
+        menu(); // Inicia o menu principal
+    liberarMochila(&mochila);
+    liberarArena(arenaMochila);
+    liberarPool(poolOrdenacao);
+    return status;
 }
@@ -1,6 +1,17 @@
+#define _POSIX_C_SOURCE 200809L // clock_gettime, sigaction
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h> 
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "../../comum/estruturas.h" // Fila circular e pilha compartilhadas pelos três programas
+#include "../../comum/telemetria.h"  // Contadores e intervalos (só com -DTELEMETRIA)
 
 // ------------------------------------------
 // 1. CONSTANTES E DEFINIÇÕES
@@ -9,6 +20,18 @@
 #define MAX_PILHA 3  // Capacidade máxima da pilha de peças reservadas (Requisito: 3)
 #define TROCA_MULTIPLA_QTY 3 // Quantidade de peças para a troca em bloco
 
+// Modo tempo real (terminal interativo)
+#define ALTURA_CAMPO 20           // Linhas que a peça da frente desce até o chão
+#define INTERVALO_GRAVIDADE_MS 500 // Tempo entre duas quedas de linha
+#define ATRASO_TRAVA_MS 500       // Tempo no chão antes de a peça ser jogada sozinha
+#define TIQUE_MS 10               // Resolução da roda de temporizadores
+#define SLOTS_RODA 64             // Posições da roda (um giro = SLOTS_RODA * TIQUE_MS)
+
+#ifdef TELEMETRIA
+// Nome de cada opção do menu nos intervalos da telemetria
+static const char *NOMES_ACOES[] = { "sair", "jogar", "reservar", "usar_reserva", "trocar", "troca_multipla" };
+#endif
+
 // ------------------------------------------
 // 2. ESTRUTURAS DE DADOS (STRUCTS)
 // ------------------------------------------
@@ -22,30 +45,75 @@ typedef struct {
 } Peca;
 
 /**
- * @brief Estrutura que representa a Fila Circular de Peças.
+ * @brief Fila Circular de Peças (FIFO), gerada pelo núcleo comum.
  *
- * Conceito: FIFO.
+ * Campos: itens (vetor embutido de MAX_FILA peças), inicio (próximo a sair) e qtd.
  */
-typedef struct {
-    Peca vetor[MAX_FILA]; 
-    int inicio;           // Índice da frente da fila (o próximo a sair)
-    int fim;              // Índice da posição logo após o último elemento inserido
-    int qtd_elementos;    // Contador do número real de peças na fila
-} Fila;
+DEFINIR_FILA_CIRCULAR(Fila, Peca, MAX_FILA)
+
+/**
+ * @brief Pilha de Reserva de Peças (LIFO), gerada pelo núcleo comum.
+ *
+ * Campos: itens (vetor embutido de MAX_PILHA peças) e qtd (o topo é itens[qtd - 1]).
+ */
+DEFINIR_PILHA(Pilha, Peca, MAX_PILHA)
+
+/**
+ * @brief Eventos com hora marcada do modo tempo real.
+ */
+typedef enum {
+    EVENTO_GRAVIDADE, // A peça da frente desce uma linha
+    EVENTO_TRAVA,     // A peça no chão é jogada
+    NUM_EVENTOS
+} TipoEvento;
 
 /**
- * @brief Estrutura que representa a Pilha de Reserva de Peças.
+ * @brief Temporizador agendado na roda (no máximo um por tipo de evento).
+ */
+typedef struct Temporizador {
+    TipoEvento tipo;
+    unsigned long long prazo;      // Tique em que dispara
+    int ativo;
+    struct Temporizador *proximo;  // Próximo temporizador no mesmo slot
+} Temporizador;
+
+/**
+ * @brief Roda de temporizadores (hashed timing wheel) sobre o relógio monotônico.
  *
- * Conceito: LIFO.
+ * O slot de um temporizador é prazo % SLOTS_RODA; prazos além de um giro esperam
+ * no mesmo slot até o tique certo. Agendar e cancelar custam O(1) (mais o slot).
+ */
+typedef struct {
+    Temporizador *slots[SLOTS_RODA];
+    unsigned long long tique; // Último tique processado
+    double inicio;            // Instante (s) do tique 0
+} RodaTemporizadores;
+
+/**
+ * @brief Vetor dinâmico de latências em segundos (núcleo comum).
+ */
+DEFINIR_VETOR(VetorLatencias, double)
+
+/**
+ * @brief Estado do modo tempo real: estruturas do jogo, peça em queda e medições.
  */
 typedef struct {
-    Peca vetor[MAX_PILHA]; 
-    int topo;              // Índice do último elemento inserido (topo da pilha)
-} Pilha;
+    Fila *fila;
+    Pilha *pilha;
+    RodaTemporizadores roda;
+    Temporizador eventos[NUM_EVENTOS];
+    int linha;                 // Linha da peça da frente (0 = topo, ALTURA_CAMPO - 1 = chão)
+    int id_em_queda;           // Peça que está caindo (jogadas e trocas reiniciam a queda)
+    VetorLatencias ate_estado; // Tecla -> estado atualizado
+    VetorLatencias ate_tela;   // Tecla -> resposta escrita no terminal
+} JogoTempoReal;
 
 // Variável global para garantir que o ID de cada peça seja único
 int proximo_id = 0;
 
+// Sinal de encerramento recebido (Ctrl+C) no modo tempo real
+volatile sig_atomic_t encerrar_jogo = 0;
+
 // ------------------------------------------
 // 3. FUNÇÕES AUXILIARES GERAIS
 // ------------------------------------------
@@ -81,21 +149,21 @@ Peca gerarPeca() {
  * @param p Ponteiro para a pilha.
  */
 void inicializarPilha(Pilha *p) {
-    p->topo = -1; // -1 indica que a pilha está vazia
+    Pilha_iniciar(p, MAX_PILHA);
 }
 
 /**
  * @brief Verifica se a Pilha está vazia.
  */
 int pilhaVazia(Pilha *p) {
-    return (p->topo == -1);
+    return Pilha_vazia(p);
 }
 
 /**
  * @brief Verifica se a Pilha está cheia.
  */
 int pilhaCheia(Pilha *p) {
-    return (p->topo == MAX_PILHA - 1);
+    return Pilha_cheia(p);
 }
 
 /**
@@ -105,12 +173,8 @@ int pilhaCheia(Pilha *p) {
  * @return int 1 se sucesso, 0 se cheia.
  */
 int inserirPecaPilha(Pilha *p, Peca peca) {
-    if (pilhaCheia(p)) {
-        return 0; 
-    }
-    p->topo++;
-    p->vetor[p->topo] = peca;
-    return 1;
+    TELEMETRIA_CONTAR("pilha.empilhar", 1);
+    return Pilha_empilhar(p, peca);
 }
 
 /**
@@ -120,12 +184,8 @@ int inserirPecaPilha(Pilha *p, Peca peca) {
  * @return int 1 se sucesso, 0 se vazia.
  */
 int removerPecaPilha(Pilha *p, Peca *peca) {
-    if (pilhaVazia(p)) {
-        return 0; 
-    }
-    *peca = p->vetor[p->topo];
-    p->topo--;
-    return 1;
+    TELEMETRIA_CONTAR("pilha.desempilhar", 1);
+    return Pilha_desempilhar(p, peca);
 }
 
 // ------------------------------------------
@@ -137,23 +197,21 @@ int removerPecaPilha(Pilha *p, Peca *peca) {
  * @param f Ponteiro para a fila.
  */
 void inicializarFila(Fila *f) {
-    f->inicio = 0;
-    f->fim = 0;
-    f->qtd_elementos = 0;
+    Fila_iniciar(f, MAX_FILA);
 }
 
 /**
  * @brief Verifica se a Fila está vazia.
  */
 int filaVazia(Fila *f) {
-    return (f->qtd_elementos == 0);
+    return Fila_vazia(f);
 }
 
 /**
  * @brief Verifica se a Fila está cheia.
  */
 int filaCheia(Fila *f) {
-    return (f->qtd_elementos == MAX_FILA);
+    return Fila_cheia(f);
 }
 
 /**
@@ -165,17 +223,14 @@ int filaCheia(Fila *f) {
  * @return int 1 se sucesso, 0 se cheia.
  */
 int inserirPecaFila(Fila *f, Peca peca, int silencioso) {
-    if (filaCheia(f)) {
+    TELEMETRIA_CONTAR("fila.inserir", 1);
+    if (!Fila_inserir(f, peca)) {
         if (!silencioso) {
             printf("\n[ALERTA] Fila de pecas futuras esta cheia! Nova peca descartada.\n");
         }
         return 0; 
     }
 
-    f->vetor[f->fim] = peca;
-    f->fim = (f->fim + 1) % MAX_FILA;
-    f->qtd_elementos++;
-
     if (!silencioso) {
         printf("\n[SUCESSO] Nova Peca gerada e inserida na Fila: Tipo '%c', ID %d.\n", peca.nome, peca.id);
     }
@@ -190,15 +245,8 @@ int inserirPecaFila(Fila *f, Peca peca, int silencioso) {
  * @return int 1 se sucesso, 0 se vazia.
  */
 int removerPecaFila(Fila *f, Peca *peca) {
-    if (filaVazia(f)) {
-        return 0; // Fila vazia
-    }
-
-    *peca = f->vetor[f->inicio];
-    f->inicio = (f->inicio + 1) % MAX_FILA;
-    f->qtd_elementos--;
-
-    return 1;
+    TELEMETRIA_CONTAR("fila.remover", 1);
+    return Fila_remover(f, peca); // 0 se a fila estiver vazia
 }
 
 // ------------------------------------------
@@ -213,15 +261,14 @@ void exibirEstadoAtual(Fila *f, Pilha *p) {
     printf("            ESTADO ATUAL DO JOGO\n");
     
     // --- Visualização da Fila ---
-    printf("Fila de Pecas (%d/%d): ", f->qtd_elementos, MAX_FILA);
+    printf("Fila de Pecas (%d/%d): ", f->qtd, MAX_FILA);
     if (filaVazia(f)) {
         printf("Vazia.");
     } else {
-        for (int i = 0; i < f->qtd_elementos; i++) {
-            int indice = (f->inicio + i) % MAX_FILA;
-            Peca peca = f->vetor[indice];
+        for (int i = 0; i < f->qtd; i++) {
+            Peca peca = *Fila_em(f, i);
             printf("[%c %d]", peca.nome, peca.id);
-            if (i < f->qtd_elementos - 1) {
+            if (i < f->qtd - 1) {
                 printf(" -> ");
             }
         }
@@ -229,15 +276,15 @@ void exibirEstadoAtual(Fila *f, Pilha *p) {
     printf("\n");
 
     // --- Visualização da Pilha ---
-    printf("Pilha de Reserva (%d/%d) (Topo -> Base): ", p->topo + 1, MAX_PILHA);
+    printf("Pilha de Reserva (%d/%d) (Topo -> Base): ", p->qtd, MAX_PILHA);
     if (pilhaVazia(p)) {
         printf("Vazia.");
     } else {
         // Percorre a pilha do topo para a base (LIFO)
-        for (int i = p->topo; i >= 0; i--) {
-            Peca peca = p->vetor[i];
+        for (int i = 0; i < p->qtd; i++) {
+            Peca peca = *Pilha_doTopo(p, i);
             printf("[%c %d]", peca.nome, peca.id);
-            if (i > 0) {
+            if (i < p->qtd - 1) {
                 printf(" -> ");
             }
         }
@@ -318,22 +365,22 @@ void acaoUsarPecaReservada(Fila *f, Pilha *p) {
 void acaoTrocarPecaAtual(Fila *f, Pilha *p) {
     if (filaVazia(f) || pilhaVazia(p)) {
         printf("\n[ALERTA] Impossivel realizar a troca: Fila e Pilha devem ter pecas. (Fila: %d/%d, Pilha: %d/%d)\n", 
-                f->qtd_elementos, MAX_FILA, p->topo + 1, MAX_PILHA);
+                f->qtd, MAX_FILA, p->qtd, MAX_PILHA);
         return;
     }
 
-    // A Fila Circular tem a peça no índice f->inicio
-    int idx_fila = f->inicio;
-    // A Pilha tem a peça no índice p->topo
-    int idx_pilha = p->topo;
+    // Frente da Fila e topo da Pilha
+    Peca *frente = Fila_frente(f);
+    Peca *topo = Pilha_doTopo(p, 0);
 
     // Realiza a troca (Swap) diretamente nas posições das estruturas
-    Peca temp = f->vetor[idx_fila];
-    f->vetor[idx_fila] = p->vetor[idx_pilha];
-    p->vetor[idx_pilha] = temp;
+    Peca temp = *frente;
+    *frente = *topo;
+    *topo = temp;
+    TELEMETRIA_CONTAR("troca.pecas", 1);
 
     printf("\n[ACAO 4] TROCA PECA ATUAL: Peca da frente da Fila (ID %d) trocada com o Topo da Pilha (ID %d).\n", 
-            p->vetor[idx_fila].id, f->vetor[idx_fila].id);
+            topo->id, frente->id);
     
     // Requisito: Ação de troca NÃO gera nova peça.
 }
@@ -345,26 +392,26 @@ void acaoTrocarPecaAtual(Fila *f, Pilha *p) {
  */
 void acaoTrocaMultipla(Fila *f, Pilha *p) {
     // Verifica se há pelo menos 3 peças em ambas as estruturas
-    if (f->qtd_elementos < TROCA_MULTIPLA_QTY || p->topo < TROCA_MULTIPLA_QTY - 1) {
+    if (f->qtd < TROCA_MULTIPLA_QTY || p->qtd < TROCA_MULTIPLA_QTY) {
         printf("\n[ALERTA] Impossivel realizar Troca Multipla: Ambas estruturas devem ter %d pecas. (Fila: %d/%d, Pilha: %d/%d)\n", 
-                TROCA_MULTIPLA_QTY, f->qtd_elementos, MAX_FILA, p->topo + 1, MAX_PILHA);
+                TROCA_MULTIPLA_QTY, f->qtd, MAX_FILA, p->qtd, MAX_PILHA);
         return;
     }
 
     // Loop para trocar 3 peças
     for (int i = 0; i < TROCA_MULTIPLA_QTY; i++) {
-        // Fila: acessa a i-ésima peça a partir do início (lógica circular)
-        int idx_fila = (f->inicio + i) % MAX_FILA;
+        // Fila: i-ésima peça a partir do início (o núcleo trata a volta circular)
+        Peca *da_fila = Fila_em(f, i);
         
-        // Pilha: acessa a (i+1)-ésima peça a partir do topo (p->topo, p->topo-1, p->topo-2...)
-        // p->topo - i garante que i=0 acessa o TOPO, i=1 acessa o (TOPO-1) e assim por diante.
-        int idx_pilha = p->topo - i; 
+        // Pilha: i-ésima peça a partir do topo (i=0 é o TOPO, i=1 o TOPO-1 e assim por diante)
+        Peca *da_pilha = Pilha_doTopo(p, i);
 
         // Realiza a troca (Swap)
-        Peca temp = f->vetor[idx_fila];
-        f->vetor[idx_fila] = p->vetor[idx_pilha];
-        p->vetor[idx_pilha] = temp;
+        Peca temp = *da_fila;
+        *da_fila = *da_pilha;
+        *da_pilha = temp;
     }
+    TELEMETRIA_CONTAR("troca.pecas", TROCA_MULTIPLA_QTY);
 
     printf("\n[ACAO 5] TROCA MULTIPLA: Troca realizada entre as %d primeiras pecas da FILA e as %d pecas da PILHA.\n", 
             TROCA_MULTIPLA_QTY, TROCA_MULTIPLA_QTY);
@@ -391,59 +438,376 @@ void exibirMenu() {
 }
 
 // ------------------------------------------
-// 7. FUNÇÃO PRINCIPAL (MAIN)
+// 7. MODO TEMPO REAL (Teclado Sem Bloqueio e Roda de Temporizadores)
 // ------------------------------------------
 
-int main() {
-    Fila fila_pecas;
-    Pilha pilha_reserva;
-    int opcao;
+/**
+ * @brief Retorna o instante atual do relógio monotônico, em segundos.
+ */
+double agoraSegundos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
 
-    // Inicializa o gerador de números aleatórios
-    srand(time(NULL));
+/**
+ * @brief Converte um instante (s) no tique correspondente da roda.
+ */
+unsigned long long tiqueDe(const RodaTemporizadores *r, double instante) {
+    double decorrido = instante - r->inicio;
+    return decorrido > 0 ? (unsigned long long)(decorrido * 1000.0 / TIQUE_MS) : 0;
+}
 
-    // Inicialização das estruturas
-    inicializarFila(&fila_pecas);
-    inicializarPilha(&pilha_reserva);
+/**
+ * @brief Inicializa a roda com o tique 0 no instante informado.
+ */
+void iniciarRoda(RodaTemporizadores *r, double instante) {
+    memset(r->slots, 0, sizeof(r->slots));
+    r->tique = 0;
+    r->inicio = instante;
+}
 
-    // Preenche a fila inicial
-    for (int i = 0; i < MAX_FILA; i++) {
-        Peca nova = gerarPeca();
-        inserirPecaFila(&fila_pecas, nova, 1); // 1: Modo silencioso
+/**
+ * @brief Retira um temporizador da roda (nada acontece se ele não estiver agendado).
+ */
+void cancelarTemporizador(RodaTemporizadores *r, Temporizador *t) {
+    if (!t->ativo) {
+        return;
     }
-    printf("\nSistema de Gerenciamento Tetris Stack Iniciado.\n");
-    printf("Fila de pecas futuras preenchida inicialmente com %d elementos.\n", MAX_FILA);
+    Temporizador **elo = &r->slots[t->prazo % SLOTS_RODA];
+    while (*elo != t) {
+        elo = &(*elo)->proximo;
+    }
+    *elo = t->proximo;
+    t->ativo = 0;
+}
+
+/**
+ * @brief Agenda (ou reagenda) um temporizador para daqui a atraso_ms.
+ *
+ * @param agora Tique atual; o prazo é arredondado para cima e fica pelo menos um tique à frente.
+ */
+void agendarTemporizador(RodaTemporizadores *r, Temporizador *t, unsigned long long agora, int atraso_ms) {
+    cancelarTemporizador(r, t);
+    unsigned long long base = agora > r->tique ? agora : r->tique;
+    unsigned long long tiques = (unsigned long long)(atraso_ms + TIQUE_MS - 1) / TIQUE_MS;
+    t->prazo = base + (tiques > 0 ? tiques : 1);
+    t->ativo = 1;
+    Temporizador **slot = &r->slots[t->prazo % SLOTS_RODA];
+    t->proximo = *slot;
+    *slot = t;
+}
+
+/**
+ * @brief Retira o próximo temporizador vencido até o tique 'agora', avançando a roda.
+ *
+ * @return Temporizador* O temporizador disparado, ou NULL se nenhum venceu.
+ */
+Temporizador* retirarVencido(RodaTemporizadores *r, unsigned long long agora) {
+    for (;;) {
+        Temporizador **elo = &r->slots[r->tique % SLOTS_RODA];
+        for (; *elo != NULL; elo = &(*elo)->proximo) {
+            if ((*elo)->prazo <= r->tique) {
+                Temporizador *t = *elo;
+                *elo = t->proximo;
+                t->ativo = 0;
+                return t;
+            }
+        }
+        if (r->tique >= agora) {
+            return NULL;
+        }
+        r->tique++;
+    }
+}
+
+/**
+ * @brief Milissegundos até o próximo prazo da roda (-1 se não há nada agendado).
+ *
+ * Usado como timeout do poll: o laço dorme até uma tecla ou até o próximo evento.
+ */
+int msAteProximoPrazo(const RodaTemporizadores *r, double instante) {
+    unsigned long long menor = 0;
+    int encontrou = 0;
+    for (int i = 0; i < SLOTS_RODA; i++) {
+        for (const Temporizador *t = r->slots[i]; t != NULL; t = t->proximo) {
+            if (!encontrou || t->prazo < menor) {
+                menor = t->prazo;
+                encontrou = 1;
+            }
+        }
+    }
+    if (!encontrou) {
+        return -1;
+    }
+    double falta_ms = (r->inicio + menor * (TIQUE_MS / 1000.0) - instante) * 1000.0;
+    return falta_ms > 0 ? (int)falta_ms + 1 : 0;
+}
+
+/**
+ * @brief Recomeça a queda com a peça que está na frente da fila.
+ */
+void reiniciarQueda(JogoTempoReal *j, unsigned long long agora) {
+    j->linha = 0;
+    j->id_em_queda = filaVazia(j->fila) ? -1 : Fila_frente(j->fila)->id;
+    cancelarTemporizador(&j->roda, &j->eventos[EVENTO_TRAVA]);
+    if (j->id_em_queda >= 0) {
+        agendarTemporizador(&j->roda, &j->eventos[EVENTO_GRAVIDADE], agora, INTERVALO_GRAVIDADE_MS);
+    } else {
+        cancelarTemporizador(&j->roda, &j->eventos[EVENTO_GRAVIDADE]);
+    }
+}
+
+/**
+ * @brief Reescreve, no lugar, a linha de status da peça em queda.
+ */
+void exibirQueda(const JogoTempoReal *j) {
+    printf("\r\033[K");
+    if (j->id_em_queda < 0) {
+        printf("[QUEDA] Nenhuma peca na fila.");
+    } else {
+        printf("[QUEDA] Peca '%c' ID %d: linha %d/%d%s | Teclas 1-5: acoes, 0: sair",
+               Fila_frente(j->fila)->nome, j->id_em_queda, j->linha + 1, ALTURA_CAMPO,
+               j->eventos[EVENTO_TRAVA].ativo ? " (travando)" : "");
+    }
+}
+
+/**
+ * @brief Trata um evento vencido da roda (gravidade ou trava).
+ */
+void tratarEvento(JogoTempoReal *j, TipoEvento evento, unsigned long long agora) {
+    if (evento == EVENTO_GRAVIDADE) {
+        j->linha++;
+        if (j->linha >= ALTURA_CAMPO - 1) {
+            // No chão: a peça ainda pode ser trocada até o fim do atraso de trava
+            j->linha = ALTURA_CAMPO - 1;
+            agendarTemporizador(&j->roda, &j->eventos[EVENTO_TRAVA], agora, ATRASO_TRAVA_MS);
+        } else {
+            agendarTemporizador(&j->roda, &j->eventos[EVENTO_GRAVIDADE], agora, INTERVALO_GRAVIDADE_MS);
+        }
+        exibirQueda(j);
+    } else {
+        TELEMETRIA_INICIO(marca_trava);
+        printf("\n[TRAVA] A peca chegou ao chao e foi jogada.");
+        acaoJogarPeca(j->fila);
+        reiniciarQueda(j, agora);
+        TELEMETRIA_FIM(marca_trava, "travar");
+        exibirEstadoAtual(j->fila, j->pilha);
+        exibirQueda(j);
+    }
+}
+
+/**
+ * @brief Executa a ação de uma tecla no instante em que ela chega.
+ *
+ * @return int 0 se a tecla encerra o jogo, 1 caso contrário.
+ */
+int tratarTecla(JogoTempoReal *j, char tecla, unsigned long long agora) {
+    printf("\n");
+    switch (tecla) {
+        case '1': // Jogar (a peça cai de uma vez)
+            acaoJogarPeca(j->fila);
+            break;
+        case '2': // Reservar
+            acaoReservarPeca(j->fila, j->pilha);
+            break;
+        case '3': // Usar Reserva
+            acaoUsarPecaReservada(j->fila, j->pilha);
+            break;
+        case '4': // Troca Simples
+            acaoTrocarPecaAtual(j->fila, j->pilha);
+            break;
+        case '5': // Troca Múltipla
+            acaoTrocaMultipla(j->fila, j->pilha);
+            break;
+        default: // '0' ou 'q'
+            printf("\nEncerrando o Gerenciador de Pecas do Tetris Stack.\n");
+            return 0;
+    }
+
+    // Uma nova peça na frente da fila começa a cair do topo
+    int frente = filaVazia(j->fila) ? -1 : Fila_frente(j->fila)->id;
+    if (frente != j->id_em_queda) {
+        reiniciarQueda(j, agora);
+    }
+    return 1;
+}
+
+/**
+ * @brief Comparador de latências para qsort.
+ */
+int compararLatencias(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Exibe p50, p99 e máximo (em microssegundos) de uma lista de latências.
+ */
+void exibirLatencias(const char *nome, VetorLatencias *v) {
+    qsort(v->itens, v->qtd, sizeof(double), compararLatencias);
+    int p50 = (v->qtd * 50 + 99) / 100 - 1;
+    int p99 = (v->qtd * 99 + 99) / 100 - 1;
+    printf("  %-16s p50 %8.1f us | p99 %8.1f us | max %8.1f us\n", nome,
+           v->itens[p50] * 1e6, v->itens[p99] * 1e6, v->itens[v->qtd - 1] * 1e6);
+}
+
+struct termios terminal_original; // Modo do terminal antes do jogo (restaurado na saída)
+
+/**
+ * @brief Devolve o terminal ao modo original (eco e leitura por linha).
+ */
+void restaurarTerminal() {
+    tcsetattr(STDIN_FILENO, TCSANOW, &terminal_original);
+}
+
+/**
+ * @brief Trata Ctrl+C: o laço encerra e o terminal é restaurado normalmente.
+ */
+void sinalEncerrar(int sinal) {
+    (void)sinal;
+    encerrar_jogo = 1;
+}
+
+/**
+ * @brief Laço orientado a eventos: teclas sem Enter, gravidade e trava por temporizador.
+ *
+ * O terminal fica sem modo canônico e sem eco (leitura sem bloqueio, VMIN = VTIME = 0).
+ * O poll dorme até uma tecla chegar ou até o próximo prazo da roda, então cada tecla
+ * é tratada assim que lida. A latência medida vai da volta do poll até o estado
+ * atualizado e até a resposta escrita no terminal.
+ */
+void executarModoTempoReal(Fila *f, Pilha *p) {
+    JogoTempoReal jogo = { .fila = f, .pilha = p };
+    for (int e = 0; e < NUM_EVENTOS; e++) {
+        jogo.eventos[e].tipo = (TipoEvento)e;
+    }
+    VetorLatencias_iniciar(&jogo.ate_estado);
+    VetorLatencias_iniciar(&jogo.ate_tela);
+
+    if (tcgetattr(STDIN_FILENO, &terminal_original) != 0) {
+        perror("Erro ao ler o modo do terminal");
+        exit(EXIT_FAILURE);
+    }
+    struct termios bruto = terminal_original;
+    bruto.c_lflag &= ~(ICANON | ECHO);
+    bruto.c_cc[VMIN] = 0;
+    bruto.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &bruto);
+    atexit(restaurarTerminal);
+
+    struct sigaction acao = { 0 };
+    acao.sa_handler = sinalEncerrar;
+    sigemptyset(&acao.sa_mask);
+    sigaction(SIGINT, &acao, NULL);
+    sigaction(SIGTERM, &acao, NULL);
+
+    iniciarRoda(&jogo.roda, agoraSegundos());
+    reiniciarQueda(&jogo, 0);
+    exibirEstadoAtual(f, p);
+    exibirQueda(&jogo);
+
+    int rodando = 1;
+    while (rodando && !encerrar_jogo) {
+        // 1. Dispara os eventos vencidos (a roda alcança o relógio)
+        Temporizador *vencido;
+        while ((vencido = retirarVencido(&jogo.roda, tiqueDe(&jogo.roda, agoraSegundos()))) != NULL) {
+            tratarEvento(&jogo, vencido->tipo, jogo.roda.tique);
+        }
+        fflush(stdout);
+
+        // 2. Dorme até uma tecla ou até o próximo prazo
+        struct pollfd entrada = { .fd = STDIN_FILENO, .events = POLLIN };
+        int prontos = poll(&entrada, 1, msAteProximoPrazo(&jogo.roda, agoraSegundos()));
+        if (prontos < 0 && errno != EINTR) {
+            perror("Erro no poll");
+            break;
+        }
+        if (prontos <= 0) {
+            continue;
+        }
+        if (entrada.revents & (POLLHUP | POLLERR)) {
+            break;
+        }
+
+        // 3. Trata cada tecla lida no momento em que chegou
+        double chegada = agoraSegundos();
+        char teclas[32];
+        ssize_t lidas = read(STDIN_FILENO, teclas, sizeof(teclas));
+        for (ssize_t i = 0; i < lidas && rodando; i++) {
+            char tecla = teclas[i];
+            if (tecla == 'q') {
+                tecla = '0';
+            }
+            if (tecla < '0' || tecla > '5') {
+                continue; // Setas, Enter e outras teclas não têm ação
+            }
+            TELEMETRIA_INICIO(marca_acao);
+            rodando = tratarTecla(&jogo, tecla, tiqueDe(&jogo.roda, agoraSegundos()));
+            TELEMETRIA_FIM(marca_acao, NOMES_ACOES[tecla - '0']);
+            VetorLatencias_acrescentar(&jogo.ate_estado, agoraSegundos() - chegada);
+            if (rodando) {
+                exibirEstadoAtual(f, p);
+                exibirQueda(&jogo);
+            }
+            fflush(stdout);
+            VetorLatencias_acrescentar(&jogo.ate_tela, agoraSegundos() - chegada);
+        }
+    }
+
+    restaurarTerminal();
+    if (encerrar_jogo) {
+        printf("\n\nEncerrando o Gerenciador de Pecas do Tetris Stack.\n");
+    }
+    if (jogo.ate_estado.qtd > 0) {
+        printf("\n[LATENCIA] %d tecla(s) tratada(s):\n", jogo.ate_estado.qtd);
+        exibirLatencias("entrada->estado", &jogo.ate_estado);
+        exibirLatencias("entrada->tela", &jogo.ate_tela);
+    }
+    VetorLatencias_liberar(&jogo.ate_estado);
+    VetorLatencias_liberar(&jogo.ate_tela);
+}
+
+/**
+ * @brief Laço clássico por menu: lê uma opção por linha (entrada redirecionada ou --classico).
+ */
+void executarModoClassico(Fila *fila_pecas, Pilha *pilha_reserva) {
+    int opcao;
 
-    // Loop principal do jogo
     do {
-        exibirEstadoAtual(&fila_pecas, &pilha_reserva);
+        exibirEstadoAtual(fila_pecas, pilha_reserva);
         exibirMenu();
         
-        if (scanf("%d", &opcao) != 1) {
+        int lidos = scanf("%d", &opcao);
+        if (lidos == EOF) {
+            opcao = 0; // Fim da entrada encerra o jogo
+        } else if (lidos != 1) {
             // Limpa o buffer em caso de entrada inválida (não numérica)
-            while (getchar() != '\n');
+            int c;
+            while ((c = getchar()) != '\n' && c != EOF);
             opcao = -1; // Garante que a opção seja inválida
         }
 
+        TELEMETRIA_INICIO(marca_acao); // Só a ação (a leitura da opção fica de fora)
         switch (opcao) {
             case 1: // Jogar
-                acaoJogarPeca(&fila_pecas);
+                acaoJogarPeca(fila_pecas);
                 break;
 
             case 2: // Reservar
-                acaoReservarPeca(&fila_pecas, &pilha_reserva);
+                acaoReservarPeca(fila_pecas, pilha_reserva);
                 break;
             
             case 3: // Usar Reserva
-                acaoUsarPecaReservada(&fila_pecas, &pilha_reserva);
+                acaoUsarPecaReservada(fila_pecas, pilha_reserva);
                 break;
             
             case 4: // Troca Simples (Fila Frontal <-> Pilha Topo)
-                acaoTrocarPecaAtual(&fila_pecas, &pilha_reserva);
+                acaoTrocarPecaAtual(fila_pecas, pilha_reserva);
                 break;
             
             case 5: // Troca Múltipla (3 Fila <-> 3 Pilha)
-                acaoTrocaMultipla(&fila_pecas, &pilha_reserva);
+                acaoTrocaMultipla(fila_pecas, pilha_reserva);
                 break;
 
             case 0:
@@ -454,8 +818,45 @@ int main() {
                 printf("\n[ERRO] Opcao invalida. Por favor, escolha 0, 1, 2, 3, 4 ou 5.\n");
                 break;
         }
+        TELEMETRIA_FIM(marca_acao, opcao >= 0 && opcao <= 5 ? NOMES_ACOES[opcao] : "invalida");
 
     } while (opcao != 0);
+}
+
+// ------------------------------------------
+// 8. FUNÇÃO PRINCIPAL (MAIN)
+// ------------------------------------------
+
+int main(int argc, char *argv[]) {
+    Fila fila_pecas;
+    Pilha pilha_reserva;
+
+    // Terminal interativo: modo tempo real; entrada redirecionada (ou --classico): menu por linha
+    int tempo_real = isatty(STDIN_FILENO) && !(argc > 1 && strcmp(argv[1], "--classico") == 0);
+    if (tempo_real) {
+        setvbuf(stdout, NULL, _IOFBF, 1 << 16); // Um write por resposta, não um por linha
+    }
+
+    // Inicializa o gerador de números aleatórios
+    srand(time(NULL));
+
+    // Inicialização das estruturas
+    inicializarFila(&fila_pecas);
+    inicializarPilha(&pilha_reserva);
+
+    // Preenche a fila inicial
+    for (int i = 0; i < MAX_FILA; i++) {
+        Peca nova = gerarPeca();
+        inserirPecaFila(&fila_pecas, nova, 1); // 1: Modo silencioso
+    }
+    printf("\nSistema de Gerenciamento Tetris Stack Iniciado.\n");
+    printf("Fila de pecas futuras preenchida inicialmente com %d elementos.\n", MAX_FILA);
+
+    if (tempo_real) {
+        executarModoTempoReal(&fila_pecas, &pilha_reserva);
+    } else {
+        executarModoClassico(&fila_pecas, &pilha_reserva);
+    }
 
     return 0;
-}
\ No newline at end of file
+}